@@ -1,6 +1,13 @@
 #include "AppNetworkManager.h"
+#include "WakeArena.h"
+#include "WakeTrace.h"
+#include "WakeLoop.h"
+#include "TimeUtil.h"
+#include <esp_sntp.h>
 #include <esp_bt.h>
 #include <time.h>
+#include <lwip/sockets.h>
+#include <lwip/dns.h>
 
 // ---------------- utils ----------------
 
@@ -9,10 +16,11 @@ static bool startsWith(const char *s, const char *p)
 	return s && p && strncmp(s, p, strlen(p)) == 0;
 }
 
-// Supports http://host[:port]/path and https://host[:port]/path
-static bool parseUrl(const char *url, String &host, uint16_t &port, String &path)
+// Supports http://host[:port]/path and https://host[:port]/path.
+// host/path are allocated from the wake arena (valid until the caller's ArenaScope ends).
+static bool parseUrl(const char *url, const char *&host, uint16_t &port, const char *&path)
 {
-	host = "";
+	host = nullptr;
 	path = "/";
 	port = 443;
 
@@ -39,41 +47,100 @@ static bool parseUrl(const char *url, String &host, uint16_t &port, String &path
 	if (hostLen == 0)
 		return false;
 
-	String hostPort = String(url).substring(0, hostLen);
-	int colon = hostPort.indexOf(':');
-	if (colon >= 0)
+	const char *colon = (const char *)memchr(url, ':', hostLen);
+	if (colon)
 	{
-		host = hostPort.substring(0, colon);
-		int prt = hostPort.substring(colon + 1).toInt();
+		long prt = strtol(colon + 1, nullptr, 10);
 		if (prt <= 0 || prt > 65535)
 			return false;
 		port = (uint16_t)prt;
+		hostLen = (size_t)(colon - url);
 	}
-	else
+
+	host = wakeArena().strndup(url, hostLen);
+	if (slash)
+		path = slash; // points into url; no copy needed
+	return host && host[0];
+}
+
+// "Content-Range: bytes <start>-<end>/<total>" (total may be "*")
+static void parseContentRange(const char *val, HttpResponseInfo &resp)
+{
+	resp.rangeStart = -1;
+	resp.totalLength = -1;
+
+	if (strncmp(val, "bytes ", 6) != 0)
+		return;
+
+	const char *dash = strchr(val, '-');
+	const char *slash = strchr(val, '/');
+	if (!dash)
+		return;
+
+	resp.rangeStart = strtol(val + 6, nullptr, 10);
+	if (slash > dash && slash[1] != '*')
+		resp.totalLength = strtol(slash + 1, nullptr, 10);
+}
+
+// One read of up to maxLen available bytes, into the sink's memory when it offers some,
+// else through a stack bounce buffer to the callback. Returns bytes delivered, 0 if none
+// were ready, -1 on a read error (error set) or a consumer abort (error set).
+static int readAvailable(
+	WiFiClient &client,
+	size_t maxLen,
+	AppNetworkManager::ChunkCallback cb,
+	void *user,
+	const HttpBodySink *sink,
+	const char **outError)
+{
+	uint8_t bounce[1024];
+
+	uint8_t *dst = nullptr;
+	size_t cap = 0;
+	if (sink)
+		dst = sink->reserve(maxLen, &cap, user);
+
+	const bool direct = dst && cap > 0;
+	if (!direct)
 	{
-		host = hostPort;
+		dst = bounce;
+		cap = sizeof(bounce);
 	}
 
-	if (slash)
-		path = String(slash);
-	return host.length() > 0;
+	int r = client.read(dst, (maxLen < cap) ? maxLen : cap);
+	if (r < 0)
+	{
+		if (outError)
+			*outError = "Body read error";
+		return -1;
+	}
+	if (r == 0)
+		return 0;
+
+	if (direct ? !sink->commit((size_t)r, user) : !cb(dst, (size_t)r, user))
+	{
+		if (outError)
+			*outError = "Aborted by callback";
+		return -1;
+	}
+	return r;
 }
 
 // Stream-safe read: never call readBytes() for fixed-length bodies.
 // Instead, read only what is available, and fail on "no-progress" stall.
+// The overall timeout runs from startMs (the request's start), not from this call.
 static bool streamReadExact(
 	WiFiClient &client,
 	int totalLen,
 	AppNetworkManager::ChunkCallback cb,
 	void *user,
+	const HttpBodySink *sink,
+	uint32_t startMs,
 	uint32_t overallTimeoutMs,
-	String *outError,
+	const char **outError,
 	uint32_t stallTimeoutMs = 8000)
 {
-	uint8_t buf[1024];
-
-	const uint32_t startMs = millis();
-	uint32_t lastProgressMs = startMs;
+	uint32_t lastProgressMs = millis();
 
 	int remaining = totalLen;
 	while (remaining > 0)
@@ -105,39 +172,20 @@ static bool streamReadExact(
 				return false;
 			}
 
-			delay(1);
-			yield();
+			wakeLoop().wait(1);
 			continue;
 		}
 
-		int toRead = avail;
-		if (toRead > (int)sizeof(buf))
-			toRead = (int)sizeof(buf);
-		if (toRead > remaining)
-			toRead = remaining;
-
-		int r = client.read(buf, toRead);
+		int r = readAvailable(client, (size_t)((avail < remaining) ? avail : remaining), cb, user, sink, outError);
 		if (r < 0)
-		{
-			if (outError)
-				*outError = "Body read error";
 			return false;
-		}
 		if (r == 0)
 		{
 			// No bytes right now; keep looping until stall timeout
-			delay(1);
-			yield();
+			wakeLoop().wait(1);
 			continue;
 		}
 
-		if (!cb(buf, (size_t)r, user))
-		{
-			if (outError)
-				*outError = "Aborted by callback";
-			return false;
-		}
-
 		remaining -= r;
 		lastProgressMs = millis();
 	}
@@ -145,27 +193,39 @@ static bool streamReadExact(
 	return true;
 }
 
-// Similar helper for chunked bodies: reads "n" data bytes exactly (no CRLF).
-static bool streamReadExactChunk(
-	WiFiClient &client,
-	int totalLen,
-	AppNetworkManager::ChunkCallback cb,
-	void *user,
-	uint32_t overallTimeoutMs,
-	String *outError,
-	uint32_t stallTimeoutMs = 8000)
-{
-	return streamReadExact(client, totalLen, cb, user, overallTimeoutMs, outError, stallTimeoutMs);
-}
-
 // ---------------- class ----------------
 
 AppNetworkManager::AppNetworkManager(const char *ssid, const char *pass)
-	: _ssid(ssid), _pass(pass) {}
+	: _ssid(ssid), _pass(pass), _radio(ssid) {}
 
 void AppNetworkManager::setInsecureHttps(bool enabled)
 {
-	_insecureHttps = enabled;
+	_tls.profile = enabled ? TlsProfile::Insecure : TlsProfile::PinnedCa;
+}
+
+void AppNetworkManager::setTlsConfig(const TlsConfig &tls)
+{
+	_tls = tls;
+}
+
+const char *tlsProfileName(TlsProfile profile)
+{
+	switch (profile)
+	{
+	case TlsProfile::Insecure:
+		return "insecure";
+	case TlsProfile::PinnedCa:
+		return "pinned-ca";
+	case TlsProfile::Psk:
+		return "psk";
+	default:
+		return "?";
+	}
+}
+
+void AppNetworkManager::setTimeSyncEnabled(bool enabled)
+{
+	_timeSync = enabled;
 }
 
 void AppNetworkManager::disableBluetooth()
@@ -180,22 +240,36 @@ bool AppNetworkManager::isHttpsUrl(const char *url) const
 
 // ---------------- time sync ----------------
 
-bool AppNetworkManager::syncTimeNtp(uint32_t timeoutMs)
+// lwIP's SNTP client runs in the tcpip thread; the task only watches for the first answer.
+static WakeLoop::State sntpStep(void *)
 {
+	if (sntp_get_sync_status() != SNTP_SYNC_STATUS_COMPLETED)
+		return WakeLoop::State::Pending;
+
+	Serial.printf("[TIME] synced: %ld\n", (long)time(nullptr));
+	return WakeLoop::State::Done;
+}
+
+int AppNetworkManager::startTimeSync()
+{
+	if (wakeLoop().state(_ntpTask) == WakeLoop::State::Pending)
+		return _ntpTask;
+
+	sntp_set_sync_status(SNTP_SYNC_STATUS_RESET);
 	configTime(0, 0, "pool.ntp.org", "time.nist.gov");
+	_ntpTask = wakeLoop().add("ntp", sntpStep, nullptr);
+	return _ntpTask;
+}
 
-	time_t now = 0;
-	uint32_t start = millis();
-	while ((millis() - start) < timeoutMs)
-	{
-		time(&now);
-		if (now > 1700000000) // ~late 2023
-		{
-			Serial.printf("[TIME] synced: %ld\n", (long)now);
-			return true;
-		}
-		delay(200);
-	}
+bool AppNetworkManager::timeSynced() const
+{
+	return wakeLoop().state(_ntpTask) == WakeLoop::State::Done;
+}
+
+bool AppNetworkManager::syncTimeNtp(uint32_t timeoutMs)
+{
+	if (wakeLoop().runUntil(startTimeSync(), timeoutMs))
+		return true;
 
 	Serial.println("[TIME] sync failed");
 	return false;
@@ -205,32 +279,76 @@ bool AppNetworkManager::syncTimeNtp(uint32_t timeoutMs)
 
 bool AppNetworkManager::connectWiFi(uint32_t timeoutMs)
 {
+	timeoutMs = wakeLoop().clamp(timeoutMs);
 	disableBluetooth();
 
 	WiFi.mode(WIFI_STA);
 	WiFi.disconnect(true, true);
 	delay(100);
+	WiFi.mode(WIFI_STA); // disconnect(wifioff) stopped the driver; radio settings need it up
+
+	_radio.apply(_radio.choose());
 
-	Serial.printf("Connecting to WiFi: %s\n", _ssid);
-	WiFi.begin(_ssid, _pass);
+	uint8_t bssid[6];
+	uint8_t channel = _radio.channel();
+	if (channel)
+		memcpy(bssid, _radio.bssid(), sizeof(bssid));
+
+	// The AP was missing last time (e.g. switched off overnight): one short scan decides
+	// whether association is worth trying at all.
+	bool probed = false;
+	int8_t rssi = 0;
+	if (_radio.failStreak() && !channel)
+	{
+		probed = true;
+		if (!_radio.probe(0, bssid, &channel, &rssi))
+		{
+			_radio.recordFailure(true);
+			Serial.println("WiFi FAILED (AP not found)");
+			return false;
+		}
+	}
+
+	Serial.printf("Connecting to WiFi: %s%s\n", _ssid, channel ? " (cached AP)" : "");
+	const uint32_t start = millis();
+	WiFi.begin(_ssid, _pass, channel, channel ? bssid : nullptr);
 
-	uint32_t start = millis();
 	while (WiFi.status() != WL_CONNECTED && (millis() - start) < timeoutMs)
 	{
-		delay(250);
-		Serial.print(".");
+		const wl_status_t st = WiFi.status();
+		if (st == WL_CONNECT_FAILED)
+			break; // credentials: waiting won't help
+
+		if (st == WL_NO_SSID_AVAIL)
+		{
+			// Not on the cached channel: the AP may have moved, or it is gone
+			if (probed || !_radio.probe(0, bssid, &channel, &rssi))
+			{
+				_radio.recordFailure(true);
+				Serial.println("WiFi FAILED (AP not found)");
+				return false;
+			}
+			probed = true;
+			WiFi.begin(_ssid, _pass, channel, bssid);
+		}
+
+		delay(100);
 	}
-	Serial.println();
 
 	if (WiFi.status() == WL_CONNECTED)
 	{
-		Serial.println("WiFi connected");
+		const uint32_t assocMs = millis() - start;
+		_radio.recordSuccess(assocMs, (int8_t)WiFi.RSSI(), WiFi.BSSID(), (uint8_t)WiFi.channel());
+		Serial.printf("WiFi connected in %lu ms, RSSI %d dBm, ch %d\n",
+					  (unsigned long)assocMs, (int)WiFi.RSSI(), (int)WiFi.channel());
 		Serial.println(WiFi.localIP());
-		syncTimeNtp(15000);
+		if (_timeSync)
+			startTimeSync(); // runs alongside the fetch; nothing waits for it on success
 		return true;
 	}
 
-	Serial.println("WiFi FAILED (timeout)");
+	_radio.recordFailure(false);
+	Serial.printf("WiFi FAILED (%s)\n", WiFi.status() == WL_CONNECT_FAILED ? "auth" : "timeout");
 	return false;
 }
 
@@ -284,450 +402,1056 @@ bool AppNetworkManager::httpGetStream(
 	String *outContentType,
 	int *outContentLength)
 {
+	HttpRequestOptions req;
+	HttpResponseInfo resp;
+
+	bool ok = httpGetStream(url, cb, user, timeoutMs, req, resp);
+
 	if (outHttpCode)
-		*outHttpCode = 0;
+		*outHttpCode = resp.httpCode;
 	if (outError)
-		*outError = "";
+		*outError = resp.error;
 	if (outContentType)
-		*outContentType = "";
+		*outContentType = resp.contentType;
 	if (outContentLength)
-		*outContentLength = -1;
+		*outContentLength = resp.contentLength;
+
+	return ok;
+}
+
+bool AppNetworkManager::httpGetStream(
+	const char *url,
+	ChunkCallback cb,
+	void *user,
+	uint32_t timeoutMs,
+	const HttpRequestOptions &req,
+	HttpResponseInfo &resp)
+{
+	resp = HttpResponseInfo();
 
 	if (!isConnected())
 	{
-		if (outError)
-			*outError = "WiFi not connected";
+		resp.error = "WiFi not connected";
 		Serial.println("HTTP GET skipped: WiFi not connected");
 		return false;
 	}
 	if (!url || !cb)
 	{
-		if (outError)
-			*outError = "Bad args";
+		resp.error = "Bad args";
 		return false;
 	}
 
 	Serial.printf("[HTTP] GET %s\n", url);
 	Serial.printf("[HTTP] RSSI: %d dBm\n", WiFi.RSSI());
+	if (req.rangeStart > 0)
+		Serial.printf("[HTTP] Range: bytes=%u- (If-Range: %s)\n",
+					  (unsigned)req.rangeStart, req.ifRange ? req.ifRange : "-");
 
-	if (isHttpsUrl(url))
+	return httpGetRaw(url, cb, user, timeoutMs, req, resp);
+}
+
+// ---------------- DNS cache (RTC) ----------------
+
+// Entries live for the configured TTL, not the record's: lwIP's dns_gethostbyname (and its
+// mDNS path for *.local) hands back only the address. A record that changes sooner costs
+// one failed connect to the cached IP, which drops the entry and looks the host up again.
+struct DnsCacheEntry
+{
+	char host[64];
+	uint32_t ip;
+	uint32_t expiresAt;
+};
+
+static constexpr size_t DNS_CACHE_SIZE = 4;
+RTC_DATA_ATTR static DnsCacheEntry rtcDnsCache[DNS_CACHE_SIZE];
+
+static DnsCacheEntry *dnsFind(const char *host)
+{
+	for (size_t i = 0; i < DNS_CACHE_SIZE; i++)
+		if (rtcDnsCache[i].host[0] && strcmp(rtcDnsCache[i].host, host) == 0)
+			return &rtcDnsCache[i];
+	return nullptr;
+}
+
+static void dnsStore(const char *host, IPAddress ip, uint32_t ttlSec)
+{
+	if (strlen(host) >= sizeof(rtcDnsCache[0].host))
+		return;
+
+	DnsCacheEntry *e = dnsFind(host);
+	if (!e)
 	{
-		return httpsGetRaw(url, cb, user, timeoutMs, outHttpCode, outError, outContentType, outContentLength);
+		// Empty slot, else the one closest to expiry
+		e = &rtcDnsCache[0];
+		for (size_t i = 0; i < DNS_CACHE_SIZE; i++)
+		{
+			if (!rtcDnsCache[i].host[0])
+			{
+				e = &rtcDnsCache[i];
+				break;
+			}
+			if (rtcDnsCache[i].expiresAt < e->expiresAt)
+				e = &rtcDnsCache[i];
+		}
 	}
 
-	// Plain HTTP fallback
-	HTTPClient http;
-	http.setTimeout(timeoutMs);
-	http.setReuse(false);
-	http.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
-	http.addHeader("Connection", "close");
-	http.addHeader("Accept-Encoding", "identity");
-	http.addHeader("User-Agent", "ESP32");
+	strncpy(e->host, host, sizeof(e->host) - 1);
+	e->host[sizeof(e->host) - 1] = '\0';
+	e->ip = (uint32_t)ip;
+	e->expiresAt = rtcNowSec() + ttlSec;
+}
+
+static void dnsInvalidate(const char *host)
+{
+	DnsCacheEntry *e = dnsFind(host);
+	if (e)
+		memset(e, 0, sizeof(*e));
+}
+
+// ---------------- DNS prefetch ----------------
+
+// Lookups started ahead of the connect; lwIP answers them in the tcpip thread and the
+// loop task moves the address into the RTC cache.
+struct DnsLookup
+{
+	char host[64];
+	volatile uint8_t result; // 0 pending, 1 found, 2 failed
+	uint32_t ip;
+	uint32_t ttlSec;
+	int task = -1; // WakeLoop id
+};
 
-	if (!http.begin(url))
+static constexpr uint32_t DNS_WAIT_MS = 5000;
+static DnsLookup dnsLookups[DNS_CACHE_SIZE];
+
+static void dnsFound(const char *name, const ip_addr_t *addr, void *arg)
+{
+	DnsLookup *l = (DnsLookup *)arg;
+	if (strcmp(name, l->host) != 0)
+		return; // late answer for an abandoned lookup whose slot was reused
+	if (addr)
+		l->ip = ip4_addr_get_u32(ip_2_ip4(addr));
+	l->result = (addr && l->ip) ? 1 : 2;
+}
+
+static WakeLoop::State dnsStep(void *ctx)
+{
+	DnsLookup *l = (DnsLookup *)ctx;
+	if (l->result == 0)
+		return WakeLoop::State::Pending;
+
+	if (l->result != 1)
 	{
-		if (outError)
-			*outError = "HTTP begin() failed";
-		return false;
+		Serial.printf("[DNS] %s prefetch failed\n", l->host);
+		return WakeLoop::State::Failed;
 	}
 
-	int code = http.GET();
-	if (outHttpCode)
-		*outHttpCode = code;
+	dnsStore(l->host, IPAddress(l->ip), l->ttlSec);
+	Serial.printf("[DNS] %s -> %s (prefetched)\n", l->host, IPAddress(l->ip).toString().c_str());
+	return WakeLoop::State::Done;
+}
+
+static DnsLookup *dnsInFlight(const char *host)
+{
+	for (size_t i = 0; i < DNS_CACHE_SIZE; i++)
+		if (wakeLoop().state(dnsLookups[i].task) == WakeLoop::State::Pending &&
+			strcmp(dnsLookups[i].host, host) == 0)
+			return &dnsLookups[i];
+	return nullptr;
+}
 
-	if (code <= 0)
+static void dnsPrefetch(const char *host, uint32_t ttlSec)
+{
+	IPAddress literal;
+	if (!ttlSec || literal.fromString(host) || strlen(host) >= sizeof(dnsLookups[0].host))
+		return;
+
+	const DnsCacheEntry *e = dnsFind(host);
+	if ((e && (int32_t)(e->expiresAt - rtcNowSec()) > 0) || dnsInFlight(host))
+		return;
+
+	DnsLookup *l = nullptr;
+	for (size_t i = 0; i < DNS_CACHE_SIZE && !l; i++)
+		if (wakeLoop().state(dnsLookups[i].task) != WakeLoop::State::Pending)
+			l = &dnsLookups[i];
+	if (!l)
+		return;
+
+	strcpy(l->host, host);
+	l->result = 0;
+	l->ip = 0;
+	l->ttlSec = ttlSec;
+	l->task = -1;
+
+	ip_addr_t addr;
+	const err_t err = dns_gethostbyname(l->host, &addr, dnsFound, l);
+	if (err == ERR_OK) // in lwIP's own cache
 	{
-		String e = http.errorToString(code);
-		if (outError)
-			*outError = e;
-		Serial.printf("[HTTP] GET failed (%d): %s\n", code, e.c_str());
-		http.end();
-		return false;
+		dnsStore(host, IPAddress(ip4_addr_get_u32(ip_2_ip4(&addr))), ttlSec);
+		return;
 	}
+	if (err == ERR_INPROGRESS)
+		l->task = wakeLoop().add("dns", dnsStep, l);
+}
 
-	String ct = http.header("Content-Type");
-	int len = http.getSize();
+// Literal IPs bypass the cache. fromCache tells the caller a failure may be a stale entry.
+static bool resolveHost(const char *host, uint32_t ttlSec, IPAddress &ip, bool &fromCache)
+{
+	fromCache = false;
 
-	if (outContentType)
-		*outContentType = ct;
-	if (outContentLength)
-		*outContentLength = len;
+	if (ip.fromString(host))
+		return true;
 
-	Serial.printf("[HTTP] Status: %d\n", code);
-	Serial.printf("[HTTP] Content-Type: %s\n", ct.c_str());
-	Serial.printf("[HTTP] Content-Length: %d\n", len);
+	// A prefetch already asked: wait for that answer rather than asking again
+	const DnsLookup *pending = dnsInFlight(host);
+	if (pending)
+		wakeLoop().runUntil(pending->task, DNS_WAIT_MS);
 
-	if (!(code >= 200 && code < 300))
+	if (ttlSec)
 	{
-		if (outError)
-			*outError = "Non-2xx";
-		http.end();
+		DnsCacheEntry *e = dnsFind(host);
+		if (e && (int32_t)(e->expiresAt - rtcNowSec()) > 0)
+		{
+			ip = IPAddress(e->ip);
+			fromCache = true;
+			Serial.printf("[DNS] %s -> %s (cached)\n", host, ip.toString().c_str());
+			return true;
+		}
+	}
+
+	// lwIP resolves *.local through mDNS and everything else through unicast DNS
+	const uint32_t t0 = millis();
+	if (!WiFi.hostByName(host, ip) || (uint32_t)ip == 0)
+	{
+		Serial.printf("[DNS] %s lookup failed\n", host);
 		return false;
 	}
 
-	Stream &s = http.getStream();
-	uint8_t buf[1024];
+	Serial.printf("[DNS] %s -> %s (lookup %u ms)\n",
+				  host, ip.toString().c_str(), (unsigned)(millis() - t0));
+	if (ttlSec)
+		dnsStore(host, ip, ttlSec);
+	return true;
+}
 
-	uint32_t startMs = millis();
-	uint32_t lastProgressMs = startMs;
-	const uint32_t stallTimeoutMs = 8000;
+void AppNetworkManager::prefetchDns(const char *const *urls, size_t count)
+{
+	ArenaScope scope;
+	for (size_t i = 0; i < count; i++)
+	{
+		const char *host, *path;
+		uint16_t port = 0;
+		if (parseUrl(urls[i], host, port, path))
+			dnsPrefetch(host, _conn.dnsTtl());
+	}
+}
 
-	while (true)
+// ---------------- keep-alive connection ----------------
+
+bool HttpConnection::matches(const char *host, uint16_t port, bool https)
+{
+	if (!_open || _https != https || _port != port || strcmp(_host, host) != 0)
+		return false;
+
+	// Peer may have closed the idle socket; unread bytes would also corrupt the next response.
+	WiFiClient &c = client();
+	return c.connected() && c.available() == 0;
+}
+
+// mbedTLS takes at most MBEDTLS_PSK_MAX_LEN (32) bytes; an empty key would "authenticate"
+// anyone who also configured none.
+static bool validPskHex(const char *hex)
+{
+	if (!hex)
+		return false;
+	const size_t len = strlen(hex);
+	if (len == 0 || (len & 1) || len > 64)
+		return false;
+	for (size_t i = 0; i < len; i++)
+		if (!isxdigit((unsigned char)hex[i]))
+			return false;
+	return true;
+}
+
+bool HttpConnection::open(const char *host, uint16_t port, bool https, const TlsConfig &tls, uint32_t timeoutMs)
+{
+	if (matches(host, port, https))
 	{
-		// If we have a known length, stop exactly at len==0
-		if (len == 0)
-			break;
+		// readLine's stall limit is the stream timeout: this request's, not the last one's
+		client().setTimeout((timeoutMs > 0) ? timeoutMs : 15000);
+		_reused = true;
+		Serial.printf("[RAW] Reusing connection %s:%u (request #%u)\n",
+					  host, port, (unsigned)(_requests + 1));
+		return true;
+	}
 
-		if (timeoutMs && (millis() - startMs) > timeoutMs)
+	close();
+
+	if (strlen(host) >= sizeof(_host))
+		return false;
+
+	_https = https;
+	strcpy(_host, host);
+	_port = port;
+	_reused = false;
+	_requests = 0;
+
+	if (https)
+	{
+		if (tls.profile == TlsProfile::Insecure)
+			_tls.setInsecure();
+		else if (tls.profile == TlsProfile::PinnedCa && !tls.caPem)
 		{
-			if (outError)
-				*outError = "Body read timeout";
-			http.end();
+			Serial.println("[TLS] pinned-ca profile without a CA");
 			return false;
 		}
-
-		int avail = s.available();
-		if (avail <= 0)
+		else if (tls.profile == TlsProfile::Psk && !(tls.pskIdentity && tls.pskIdentity[0] && validPskHex(tls.pskHex)))
 		{
-			if (!http.connected())
-				break;
+			Serial.println("[TLS] psk profile without identity or a 1..32 byte hex key");
+			return false;
+		}
+		_tls.setHandshakeTimeout(30); // seconds
+		wakeTraceMark("tls"); // handshake needs ~40k contiguous: watch "big"
+	}
 
-			if ((millis() - lastProgressMs) > stallTimeoutMs)
+	WiFiClient &c = client();
+	// Stream::setTimeout is milliseconds on Arduino; keep it moderately large.
+	c.setTimeout((timeoutMs > 0) ? timeoutMs : 15000);
+
+	// A cached address that no longer answers is dropped and resolved again once.
+	for (int attempt = 0; attempt < 2; attempt++)
+	{
+		IPAddress ip;
+		bool fromCache = false;
+		if (!resolveHost(host, _dnsTtlSec, ip, fromCache))
+			return false;
+
+		Serial.printf("[RAW] Connect %s:%u via %s (%s)\n",
+					  host, port, ip.toString().c_str(), https ? "TLS" : "TCP");
+
+		const uint32_t t0 = millis();
+		int rc;
+		if (!https)
+			rc = _plain.connect(ip, port);
+		else if (tls.profile == TlsProfile::Psk)
+			rc = _tls.connect(ip, port, tls.pskIdentity, tls.pskHex); // no certificate, so no SNI needed
+		else // IP overload keeps the host name for SNI; the CA argument is what gets verified
+			rc = _tls.connect(ip, port, host, tls.profile == TlsProfile::PinnedCa ? tls.caPem : nullptr,
+							  nullptr, nullptr);
+		_handshakeMs = millis() - t0;
+
+		if (rc)
+		{
+			if (https)
 			{
-				if (outError)
-					*outError = "Body read stalled";
-				http.end();
-				return false;
+				wakeTraceMark("tls-ok");
+				Serial.printf("[TLS] %s handshake %u ms (incl. TCP)\n",
+							  tlsProfileName(tls.profile), (unsigned)_handshakeMs);
 			}
-
-			delay(1);
-			yield();
-			continue;
+			_open = true;
+			return true;
 		}
 
-		int toRead = avail;
-		if (toRead > (int)sizeof(buf))
-			toRead = (int)sizeof(buf);
-		if (len > 0 && toRead > len)
-			toRead = len;
+		if (!fromCache)
+			return false;
 
-		int r = s.readBytes((char *)buf, toRead);
-		if (r <= 0)
+		Serial.printf("[DNS] connect to cached %s failed; re-resolving\n", ip.toString().c_str());
+		dnsInvalidate(host);
+	}
+
+	return false;
+}
+
+void HttpConnection::close()
+{
+	if (_open)
+	{
+		client().stop();
+		Serial.printf("[RAW] Closed %s:%u after %u request(s)\n",
+					  _host, _port, (unsigned)_requests);
+	}
+	_open = false;
+	_reused = false;
+}
+
+void AppNetworkManager::closeConnection()
+{
+	_conn.close();
+}
+
+void AppNetworkManager::setMaxRedirects(uint8_t maxRedirects)
+{
+	_maxRedirects = maxRedirects;
+}
+
+void AppNetworkManager::setDnsCacheTtl(uint32_t seconds)
+{
+	_conn.setDnsTtl(seconds);
+}
+
+// ---------------- endpoint race ----------------
+
+// Address without blocking: a literal IP or a fresh cache entry.
+static bool cachedHost(const char *host, uint32_t ttlSec, IPAddress &ip)
+{
+	if (ip.fromString(host))
+		return true;
+	const DnsCacheEntry *e = ttlSec ? dnsFind(host) : nullptr;
+	if (!e || (int32_t)(e->expiresAt - rtcNowSec()) <= 0)
+		return false;
+	ip = IPAddress(e->ip);
+	return true;
+}
+
+static int startConnect(IPAddress ip, uint16_t port)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0)
+		return -1;
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+	struct sockaddr_in sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sin_family = AF_INET;
+	sa.sin_port = htons(port);
+	sa.sin_addr.s_addr = (uint32_t)ip;
+
+	if (connect(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0 && errno != EINPROGRESS)
+	{
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+// The budget covers name resolution too: uncached hosts are looked up on the wake loop
+// and join the race when their answer arrives. With the DNS cache off (TTL 0) there is
+// nowhere for an async answer to land, so those lookups block and count against it.
+int AppNetworkManager::raceConnect(const char *const *urls, size_t count, uint32_t timeoutMs)
+{
+	static constexpr size_t MAX_RACE = 4;
+	static constexpr uint32_t RACE_SLICE_MS = 10;
+	int fds[MAX_RACE];
+	const char *hosts[MAX_RACE];
+	uint16_t ports[MAX_RACE];
+	bool resolving[MAX_RACE];
+	int winner = -1;
+
+	if (count > MAX_RACE)
+		count = MAX_RACE;
+	timeoutMs = wakeLoop().clamp(timeoutMs);
+	const uint32_t startMs = millis();
+	const uint32_t ttlSec = _conn.dnsTtl();
+
+	ArenaScope scope;
+	for (size_t i = 0; i < count; i++)
+	{
+		fds[i] = -1;
+		resolving[i] = false;
+
+		const char *path;
+		IPAddress ip;
+		bool fromCache = false;
+		if (!parseUrl(urls[i], hosts[i], ports[i], path))
+			continue;
+
+		if (cachedHost(hosts[i], ttlSec, ip))
+			fds[i] = startConnect(ip, ports[i]);
+		else if (ttlSec)
 		{
-			if (!http.connected())
-				break;
+			dnsPrefetch(hosts[i], ttlSec);
+			resolving[i] = true;
+		}
+		else if ((millis() - startMs) < timeoutMs && resolveHost(hosts[i], 0, ip, fromCache))
+			fds[i] = startConnect(ip, ports[i]);
+	}
 
-			// treat as stall, not immediate loss
-			if ((millis() - lastProgressMs) > stallTimeoutMs)
+	while (winner < 0 && (millis() - startMs) < timeoutMs)
+	{
+		fd_set wfds;
+		FD_ZERO(&wfds);
+		int maxFd = -1;
+		bool waiting = false;
+		for (size_t i = 0; i < count; i++)
+		{
+			if (resolving[i])
 			{
-				if (outError)
-					*outError = "Body read stalled";
-				http.end();
-				return false;
+				IPAddress ip;
+				if (cachedHost(hosts[i], ttlSec, ip))
+				{
+					resolving[i] = false;
+					fds[i] = startConnect(ip, ports[i]);
+				}
+				else if (!dnsInFlight(hosts[i]))
+				{
+					resolving[i] = false; // lookup failed (or no free lookup slot)
+					Serial.printf("[RACE] %s not resolved\n", hosts[i]);
+				}
+			}
+			if (resolving[i])
+				waiting = true;
+			if (fds[i] >= 0)
+			{
+				FD_SET(fds[i], &wfds);
+				if (fds[i] > maxFd)
+					maxFd = fds[i];
 			}
-			delay(1);
-			yield();
-			continue;
 		}
+		if (maxFd < 0 && !waiting)
+			break;
 
-		if (!cb(buf, (size_t)r, user))
+		// Short slices keep the wake loop's tasks (the lookups among them) moving
+		uint32_t left = timeoutMs - (millis() - startMs);
+		if (left > RACE_SLICE_MS)
+			left = RACE_SLICE_MS;
+		if (maxFd < 0)
 		{
-			if (outError)
-				*outError = "Aborted by callback";
-			http.end();
-			return false;
+			wakeLoop().wait(left);
+			continue;
 		}
 
-		lastProgressMs = millis();
+		struct timeval tv;
+		tv.tv_sec = 0;
+		tv.tv_usec = left * 1000;
 
-		if (len > 0)
+		const int ready = select(maxFd + 1, nullptr, &wfds, nullptr, &tv);
+		if (ready < 0)
+			break;
+		if (ready == 0)
 		{
-			len -= r;
-			if (len <= 0)
-				break;
+			wakeLoop().poll();
+			continue;
+		}
+
+		for (size_t i = 0; i < count && winner < 0; i++)
+		{
+			if (fds[i] < 0 || !FD_ISSET(fds[i], &wfds))
+				continue;
+
+			int err = 0;
+			socklen_t errLen = sizeof(err);
+			getsockopt(fds[i], SOL_SOCKET, SO_ERROR, &err, &errLen);
+			if (err == 0)
+			{
+				winner = (int)i;
+			}
+			else
+			{
+				// Refused/unreachable: drop it and keep waiting for the others
+				close(fds[i]);
+				fds[i] = -1;
+			}
 		}
 	}
 
-	http.end();
+	for (size_t i = 0; i < count; i++)
+		if (fds[i] >= 0)
+			close(fds[i]);
+
+	Serial.printf("[RACE] winner=%d after %u ms\n", winner, (unsigned)(millis() - startMs));
+	return winner;
+}
+
+// ---------------- raw HTTP(S) (ngrok-friendly) ----------------
+
+struct ResponseHead
+{
+	bool chunked = false;
+	bool connClose = false; // server will close after this response
+	const char *location = nullptr; // wake arena
+};
+
+static bool isRedirect(int code)
+{
+	return code == 301 || code == 302 || code == 303 || code == 307 || code == 308;
+}
+
+static bool discardBytes(const uint8_t *, size_t, void *)
+{
 	return true;
 }
 
-// ---------------- raw HTTPS (ngrok-friendly) ----------------
+static bool deadlinePassed(uint32_t startMs, uint32_t timeoutMs)
+{
+	return timeoutMs && (millis() - startMs) >= timeoutMs;
+}
 
-bool AppNetworkManager::httpsGetRaw(
-	const char *url,
-	ChunkCallback cb,
-	void *user,
-	uint32_t timeoutMs,
-	int *outHttpCode,
-	String *outError,
-	String *outContentType,
-	int *outContentLength)
+// Budget left for the next phase (0 = unlimited, as for the stream readers).
+static uint32_t remainingMs(uint32_t startMs, uint32_t timeoutMs)
 {
-	String host, path;
-	uint16_t port = 443;
+	if (!timeoutMs)
+		return 0;
+	uint32_t used = millis() - startMs;
+	return (used < timeoutMs) ? (timeoutMs - used) : 1;
+}
 
-	if (!parseUrl(url, host, port, path))
-	{
-		if (outError)
-			*outError = "Bad URL";
+// Redirects stay on the origin that was asked: same host and port, and never from https
+// down to http. Anything else could hand the request (Range, If-None-Match, the tile
+// manifest) and the response we trust to another server.
+static bool sameOrigin(const char *url, const char *host, uint16_t port, bool https)
+{
+	const char *toHost, *toPath;
+	uint16_t toPort;
+	if (!parseUrl(url, toHost, toPort, toPath))
 		return false;
+	return strcasecmp(toHost, host) == 0 && toPort == port && startsWith(url, "https://") == https;
+}
+
+// Absolute URL or absolute path; relative references are not used by our servers.
+// Result is allocated from the wake arena.
+static const char *resolveLocation(const char *location, const char *host, uint16_t port, bool https)
+{
+	if (startsWith(location, "http://") || startsWith(location, "https://"))
+	{
+		if (!sameOrigin(location, host, port, https))
+		{
+			Serial.printf("[RAW] Redirect to another origin refused: %s\n", location);
+			return nullptr;
+		}
+		return wakeArena().strdup(location);
 	}
 
-	WiFiClientSecure client;
-	if (_insecureHttps)
-		client.setInsecure();
+	if (location[0] != '/')
+		return nullptr;
 
-	client.setHandshakeTimeout(30); // seconds
-	// Stream::setTimeout is milliseconds on Arduino; keep it moderately large.
-	client.setTimeout((timeoutMs > 0) ? timeoutMs : 15000);
+	const size_t cap = strlen(host) + strlen(location) + 16;
+	char *url = (char *)wakeArena().alloc(cap, 1);
+	if (!url)
+		return nullptr;
 
-	Serial.printf("[TLS] free heap: %u\n", (unsigned)ESP.getFreeHeap());
-	Serial.printf("[RAW] Connect %s:%u\n", host.c_str(), port);
+	if (port != (https ? 443 : 80))
+		snprintf(url, cap, "%s%s:%u%s", https ? "https://" : "http://", host, (unsigned)port, location);
+	else
+		snprintf(url, cap, "%s%s%s", https ? "https://" : "http://", host, location);
+	return url;
+}
 
-	if (!client.connect(host.c_str(), port))
+// One line without CR/LF into buf (NUL-terminated). Overlong lines are truncated and the
+// rest is discarded. Returns bytes consumed including the terminator (0 = nothing arrived
+// before the stream timeout), so a blank "\r\n" line is distinguishable from a timeout.
+static size_t readLine(WiFiClient &client, char *buf, size_t cap)
+{
+	const uint32_t stallMs = client.getTimeout();
+	size_t consumed = 0;
+	size_t len = 0;
+	uint32_t lastMs = millis();
+
+	while (true)
 	{
-		if (outError)
-			*outError = "TLS connect failed";
-		if (outHttpCode)
-			*outHttpCode = -1;
-		return false;
+		int c = client.read();
+		if (c < 0)
+		{
+			if ((millis() - lastMs) >= stallMs || !(client.connected() || client.available()))
+				break;
+			wakeLoop().wait(1);
+			continue;
+		}
+
+		lastMs = millis();
+		consumed++;
+		if (c == '\n')
+			break;
+		if (c != '\r' && len + 1 < cap)
+			buf[len++] = (char)c;
 	}
 
-	// Request
+	buf[len] = '\0';
+	return consumed;
+}
+
+static char *trimInPlace(char *s)
+{
+	while (*s == ' ' || *s == '\t')
+		s++;
+	char *end = s + strlen(s);
+	while (end > s && (end[-1] == ' ' || end[-1] == '\t'))
+		*--end = '\0';
+	return s;
+}
+
+static void writeRequest(
+	WiFiClient &client,
+	const char *host,
+	uint16_t port,
+	bool https,
+	const char *path,
+	const HttpRequestOptions &req)
+{
 	client.print("GET ");
 	client.print(path);
 	client.println(" HTTP/1.1");
 	client.print("Host: ");
-	client.println(host);
-	client.println("Connection: close");
+	client.print(host);
+	if (port != (https ? 443 : 80))
+	{
+		client.print(":");
+		client.print((unsigned)port);
+	}
+	client.println();
+	client.println("Connection: keep-alive");
 	client.println("Accept-Encoding: identity");
 	client.println("User-Agent: ESP32");
 	client.println("ngrok-skip-browser-warning: true");
+	if (req.rangeStart > 0)
+	{
+		client.print("Range: bytes=");
+		client.print((unsigned long)req.rangeStart);
+		client.println("-");
+		if (req.ifRange && req.ifRange[0])
+		{
+			client.print("If-Range: ");
+			client.println(req.ifRange);
+		}
+	}
+	if (req.extraHeaders)
+		client.print(req.extraHeaders);
 	client.println();
+}
 
+// Status line + headers. resp.httpCode stays 0 if nothing arrived (stale socket).
+static bool readHead(WiFiClient &client, uint32_t timeoutMs, HttpResponseInfo &resp, ResponseHead &head)
+{
 	// Wait for response bytes (status line)
 	uint32_t waitStart = millis();
-	while ((millis() - waitStart) < timeoutMs && client.available() == 0)
+	while ((!timeoutMs || (millis() - waitStart) < timeoutMs) && client.available() == 0)
 	{
 		if (!client.connected())
 			break;
-		delay(1);
-		yield();
+		wakeLoop().wait(1);
+	}
+
+	// One arena line buffer for the whole head (released with the request's ArenaScope)
+	static constexpr size_t LINE_CAP = 512;
+	char *line = (char *)wakeArena().alloc(LINE_CAP, 1);
+	if (!line)
+	{
+		resp.error = "Out of arena memory";
+		resp.httpCode = -1;
+		return false;
 	}
 
 	// Status line
-	String line = client.readStringUntil('\n');
-	if (line.length() == 0)
+	if (readLine(client, line, LINE_CAP) == 0 || line[0] == '\0')
 	{
-		if (outError)
-			*outError = "No status line";
-		if (outHttpCode)
-			*outHttpCode = 0;
-		client.stop();
+		resp.error = "No status line";
+		resp.httpCode = 0;
 		return false;
 	}
 
-	line.trim();
-	Serial.printf("[RAW] Status line: %s\n", line.c_str());
+	Serial.printf("[RAW] Status line: %s\n", line);
 
-	if (!line.startsWith("HTTP/"))
+	if (!startsWith(line, "HTTP/"))
 	{
-		if (outError)
-			*outError = "Bad HTTP status line";
-		if (outHttpCode)
-			*outHttpCode = 0;
-		client.stop();
+		resp.error = "Bad HTTP status line";
+		resp.httpCode = 0;
 		return false;
 	}
 
+	// HTTP/1.0 closes unless it explicitly says keep-alive
+	head.connClose = startsWith(line, "HTTP/1.0");
+
 	int code = 0;
-	int sp1 = line.indexOf(' ');
-	if (sp1 > 0)
-	{
-		int sp2 = line.indexOf(' ', sp1 + 1);
-		String codeStr = (sp2 > sp1) ? line.substring(sp1 + 1, sp2) : line.substring(sp1 + 1);
-		code = codeStr.toInt();
-	}
+	const char *sp1 = strchr(line, ' ');
+	if (sp1)
+		code = (int)strtol(sp1 + 1, nullptr, 10);
 
-	if (outHttpCode)
-		*outHttpCode = code;
+	resp.httpCode = code;
 	Serial.printf("[RAW] Status: %d\n", code);
 
 	// Headers
-	int contentLen = -1;
-	bool chunked = false;
-	String ct;
-	String location;
-
 	while (true)
 	{
-		line = client.readStringUntil('\n');
-		if (line.length() == 0)
+		if (readLine(client, line, LINE_CAP) == 0)
 		{
-			if (outError)
-				*outError = "Header read timeout";
-			client.stop();
+			resp.error = "Header read timeout";
 			return false;
 		}
 
-		line.trim();
-		if (line.length() == 0)
+		char *key = trimInPlace(line);
+		if (key[0] == '\0')
 			break;
 
-		int colon = line.indexOf(':');
-		if (colon <= 0)
+		char *colon = strchr(key, ':');
+		if (!colon || colon == key)
 			continue;
 
-		String key = line.substring(0, colon);
-		String val = line.substring(colon + 1);
-		key.toLowerCase();
-		val.trim();
+		*colon = '\0';
+		char *val = trimInPlace(colon + 1);
 
-		if (key == "content-length")
-			contentLen = val.toInt();
-		else if (key == "content-type")
-			ct = val;
-		else if (key == "transfer-encoding")
+		if (strcasecmp(key, "content-length") == 0)
+			resp.contentLength = (int)strtol(val, nullptr, 10);
+		else if (strcasecmp(key, "content-type") == 0)
 		{
-			val.toLowerCase();
-			if (val.indexOf("chunked") >= 0)
-				chunked = true;
+			strncpy(resp.contentType, val, sizeof(resp.contentType) - 1);
+			resp.contentType[sizeof(resp.contentType) - 1] = '\0';
 		}
-		else if (key == "location")
-			location = val;
-	}
-
-	if (outContentType)
-		*outContentType = ct;
-	if (outContentLength)
-		*outContentLength = contentLen;
-
-	if ((code == 301 || code == 302 || code == 303 || code == 307 || code == 308) && location.length() > 0)
-	{
-		if (outError)
-			*outError = "Redirect not handled";
-		client.stop();
-		return false;
+		else if (strcasecmp(key, "transfer-encoding") == 0)
+		{
+			if (strcasestr(val, "chunked"))
+				head.chunked = true;
+		}
+		else if (strcasecmp(key, "location") == 0)
+			head.location = wakeArena().strdup(val);
+		else if (strcasecmp(key, "etag") == 0)
+		{
+			// A cut-off validator would make If-Range match the wrong entity
+			if (strlen(val) < sizeof(resp.etag))
+				strcpy(resp.etag, val);
+		}
+		else if (strcasecmp(key, "content-range") == 0)
+			parseContentRange(val, resp);
+		else if (strcasecmp(key, "connection") == 0)
+		{
+			if (strcasestr(val, "close"))
+				head.connClose = true;
+			else if (strcasestr(val, "keep-alive"))
+				head.connClose = false;
+		}
+		else
+			parseDigestHeader(key, val, resp.digest);
 	}
 
-	if (!(code >= 200 && code < 300))
-	{
-		if (outError)
-			*outError = "Non-2xx";
-		client.stop();
-		return false;
-	}
+	return true;
+}
 
-	// Body
+// Body framing: chunked, Content-Length, or until close. startMs / timeoutMs are the
+// request's deadline: however many chunks the server sends, reading stops there.
+static bool readBody(
+	WiFiClient &client,
+	const ResponseHead &head,
+	int contentLen,
+	AppNetworkManager::ChunkCallback cb,
+	void *user,
+	const HttpBodySink *sink,
+	uint32_t startMs,
+	uint32_t timeoutMs,
+	HttpResponseInfo &resp)
+{
 	const uint32_t stallTimeoutMs = 8000;
 
-	if (chunked)
+	if (head.chunked)
 	{
 		while (true)
 		{
-			String szLine = client.readStringUntil('\n');
-			if (szLine.length() == 0)
+			if (deadlinePassed(startMs, timeoutMs))
 			{
-				if (outError)
-					*outError = "Chunk size timeout";
-				client.stop();
+				resp.error = "Body read timeout";
+				return false;
+			}
+
+			char szLine[24]; // hex size + optional extensions (truncated)
+			if (readLine(client, szLine, sizeof(szLine)) == 0)
+			{
+				resp.error = "Chunk size timeout";
 				return false;
 			}
 
-			szLine.trim();
-			int sz = (int)strtol(szLine.c_str(), nullptr, 16);
+			int sz = (int)strtol(trimInPlace(szLine), nullptr, 16);
 			if (sz <= 0)
 				break;
 
 			// Read exactly sz data bytes (stall-safe, no readBytes)
-			if (!streamReadExactChunk(client, sz, cb, user, timeoutMs, outError, stallTimeoutMs))
-			{
-				client.stop();
+			if (!streamReadExact(client, sz, cb, user, sink, startMs, timeoutMs, &resp.error, stallTimeoutMs))
 				return false;
-			}
 
-			// Consume trailing CRLF after the chunk data
-			// (best-effort; tolerate both \r\n and \n)
-			int c1 = -1;
-			uint32_t t0 = millis();
-			while ((millis() - t0) < stallTimeoutMs && (c1 = client.read()) < 0)
+			// CRLF after the chunk data (tolerates a bare \n). Read as a line so a CR and LF
+			// split across segments can't leave the LF to be taken for an empty size line.
+			char crlf[4];
+			if (readLine(client, crlf, sizeof(crlf)) == 0 || crlf[0] != '\0')
 			{
-				if (!(client.connected() || client.available()))
-					break;
-				delay(1);
-				yield();
+				resp.error = "Bad chunk terminator";
+				return false;
 			}
-			if (c1 == '\r')
-				client.read(); // try read '\n'
-			else if (c1 != '\n' && c1 >= 0)
+		}
+
+		// Trailer section ends with an empty line; must be consumed before the socket is reused.
+		char trailer[64];
+		while (readLine(client, trailer, sizeof(trailer)) > 0 && trimInPlace(trailer)[0] != '\0')
+		{
+			if (deadlinePassed(startMs, timeoutMs))
 			{
-				// unexpected; ignore
+				resp.error = "Body read timeout";
+				return false;
 			}
 		}
+		return true;
 	}
-	else if (contentLen >= 0)
+
+	if (contentLen >= 0)
 	{
 		// Read exactly contentLen bytes (stall-safe)
-		if (!streamReadExact(client, contentLen, cb, user, timeoutMs, outError, stallTimeoutMs))
+		return streamReadExact(client, contentLen, cb, user, sink, startMs, timeoutMs, &resp.error, stallTimeoutMs);
+	}
+
+	// Unknown length: drain until close with stall protection
+	uint32_t lastProgressMs = millis();
+
+	while (client.connected() || client.available())
+	{
+		if (timeoutMs && (millis() - startMs) > timeoutMs)
 		{
-			client.stop();
+			resp.error = "Body read timeout";
 			return false;
 		}
+
+		int avail = client.available();
+		if (avail <= 0)
+		{
+			if ((millis() - lastProgressMs) > stallTimeoutMs)
+				break;
+			wakeLoop().wait(1);
+			continue;
+		}
+
+		int r = readAvailable(client, (size_t)avail, cb, user, sink, &resp.error);
+		if (r < 0)
+			return false;
+		if (r == 0)
+		{
+			if ((millis() - lastProgressMs) > stallTimeoutMs)
+				break;
+			wakeLoop().wait(1);
+			continue;
+		}
+
+		lastProgressMs = millis();
 	}
-	else
+
+	return true;
+}
+
+// Sends the request and reads the response head on _conn. A reused keep-alive socket
+// may have been closed by the server while idle, so that case retries once on a fresh one.
+static bool requestHead(
+	HttpConnection &conn,
+	const TlsConfig &tls,
+	const char *host,
+	uint16_t port,
+	bool https,
+	const char *path,
+	const HttpRequestOptions &req,
+	uint32_t timeoutMs,
+	HttpResponseInfo &resp,
+	ResponseHead &head)
+{
+	for (int attempt = 0; attempt < 2; attempt++)
 	{
-		// Unknown length: drain until close with stall protection
-		uint8_t buf[1024];
-		uint32_t startMs = millis();
-		uint32_t lastProgressMs = startMs;
+		resp = HttpResponseInfo();
+		head = ResponseHead();
 
-		while (client.connected() || client.available())
+		if (!conn.open(host, port, https, tls, timeoutMs))
 		{
-			if (timeoutMs && (millis() - startMs) > timeoutMs)
-			{
-				if (outError)
-					*outError = "Body read timeout";
-				client.stop();
-				return false;
-			}
+			resp.error = https ? "TLS connect failed" : "TCP connect failed";
+			resp.httpCode = -1;
+			conn.close();
+			return false;
+		}
 
-			int avail = client.available();
-			if (avail <= 0)
-			{
-				if ((millis() - lastProgressMs) > stallTimeoutMs)
-					break;
-				delay(1);
-				yield();
-				continue;
-			}
+		const bool reused = conn.reused();
+		WiFiClient &client = conn.client();
+
+		writeRequest(client, host, port, https, path, req);
+
+		if (readHead(client, timeoutMs, resp, head))
+		{
+			conn.countRequest();
+			return true;
+		}
+
+		conn.close();
+		if (!reused || resp.httpCode != 0)
+			return false;
 
-			int toRead = avail;
-			if (toRead > (int)sizeof(buf))
-				toRead = (int)sizeof(buf);
+		Serial.println("[RAW] Reused connection was stale; reconnecting");
+	}
 
-			int r = client.read(buf, toRead);
-			if (r <= 0)
+	return false;
+}
+
+bool AppNetworkManager::httpGetRaw(
+	const char *url,
+	ChunkCallback cb,
+	void *user,
+	uint32_t timeoutMs,
+	const HttpRequestOptions &req,
+	HttpResponseInfo &resp)
+{
+	const uint32_t startMs = millis();
+	timeoutMs = wakeLoop().clamp(timeoutMs);
+	ArenaScope scope; // URL pieces, header line, redirect targets
+	const char *currentUrl = url;
+
+	for (uint8_t hop = 0;; hop++)
+	{
+		const char *host, *path;
+		uint16_t port = 443;
+
+		if (!parseUrl(currentUrl, host, port, path))
+		{
+			resp.error = "Bad URL";
+			return false;
+		}
+		const bool https = isHttpsUrl(currentUrl);
+
+		ResponseHead head;
+		const uint32_t hopStartMs = millis();
+		if (!requestHead(_conn, _tls, host, port, https, path, req,
+						 remainingMs(startMs, timeoutMs), resp, head))
+			return false;
+		resp.ttfbMs = millis() - hopStartMs;
+
+		// Never a body, whatever the headers say (e.g. the OTA check's "current")
+		if (resp.httpCode == 204 || resp.httpCode == 304)
+		{
+			resp.contentLength = 0;
+			head.chunked = false;
+		}
+
+		WiFiClient &client = _conn.client();
+		const bool framed = head.chunked || resp.contentLength >= 0;
+
+		if (isRedirect(resp.httpCode) && head.location && head.location[0])
+		{
+			const char *next = (hop < _maxRedirects) ? resolveLocation(head.location, host, port, https) : nullptr;
+			if (!next)
 			{
-				if ((millis() - lastProgressMs) > stallTimeoutMs)
-					break;
-				delay(1);
-				yield();
-				continue;
+				resp.error = (hop >= _maxRedirects) ? "Too many redirects" : "Bad redirect Location";
+				_conn.close();
+				return false;
 			}
 
-			if (!cb(buf, (size_t)r, user))
+			Serial.printf("[RAW] Redirect %d -> %s\n", resp.httpCode, next);
+
+			// Drain the (small) redirect body so the same socket can carry the next request.
+			if (!framed || head.connClose ||
+				!readBody(client, head, resp.contentLength, discardBytes, nullptr, nullptr, startMs, timeoutMs, resp))
+				_conn.close();
+
+			if (deadlinePassed(startMs, timeoutMs))
 			{
-				if (outError)
-					*outError = "Aborted by callback";
-				client.stop();
+				resp.error = "Request deadline exceeded";
+				_conn.close();
 				return false;
 			}
 
-			lastProgressMs = millis();
+			currentUrl = next;
+			continue;
 		}
-	}
 
-	client.stop();
-	return true;
+		if (!(resp.httpCode >= 200 && resp.httpCode < 300))
+		{
+			resp.error = "Non-2xx";
+			_conn.close();
+			return false;
+		}
+
+		// Body
+		bool ok = readBody(client, head, resp.contentLength, cb, user, req.sink, startMs, timeoutMs, resp);
+
+		// Keep the socket only if the response was framed and fully consumed.
+		if (!ok || !framed || head.connClose)
+			_conn.close();
+
+		return ok;
+	}
 }
@@ -3,7 +3,100 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
-#include <HTTPClient.h>
+
+#include "Digest.h"
+#include "RadioPolicy.h"
+
+// Direct-read sink: body bytes are read from the socket (lwIP receive buffer, or the
+// decrypted mbedTLS record for TLS) straight into caller memory instead of a stack bounce
+// buffer that the ChunkCallback then copies again. reserve() returns where up to *outCap
+// of the next want bytes may go, or nullptr to use the ChunkCallback for this read (e.g.
+// while a header is still being parsed); commit() reports how many bytes landed there.
+// Both get the same user pointer as the ChunkCallback.
+struct HttpBodySink
+{
+	uint8_t *(*reserve)(size_t want, size_t *outCap, void *user);
+	bool (*commit)(size_t len, void *user);
+};
+
+// Optional request knobs for httpGetStream
+struct HttpRequestOptions
+{
+	uint32_t rangeStart = 0;		 // > 0 => "Range: bytes=<rangeStart>-"
+	const char *ifRange = nullptr; // validator (ETag) sent as If-Range; server answers 200 if it changed
+	const char *extraHeaders = nullptr; // raw "Name: value\r\n" lines appended to the request
+	const HttpBodySink *sink = nullptr;	// direct-read mode; nullptr = ChunkCallback only
+};
+
+// Response metadata; filled before the first body byte reaches the ChunkCallback.
+// No heap: error points at a string literal, header values are copied into the fields.
+struct HttpResponseInfo
+{
+	int httpCode = 0;
+	const char *error = ""; // "" = none
+	char contentType[64] = {}; // truncated if longer (only the media type is compared)
+	int contentLength = -1;
+	char etag[64] = {};		 // empty when absent or too long to send back intact
+	int rangeStart = -1;  // Content-Range start on 206
+	int totalLength = -1; // Content-Range "/total" on 206
+	ExpectedDigest digest; // strongest integrity header, if any
+	uint32_t ttfbMs = 0;  // request start -> status line (includes connect on a new socket)
+};
+
+// Handshake profile for https URLs. The suite list itself is fixed by the core's mbedTLS
+// build; what a profile changes is the key exchange the server can pick.
+enum class TlsProfile : uint8_t
+{
+	Insecure = 0, // any suite, no server authentication
+	PinnedCa = 1, // verify against caPem; with a P-256 ECDSA certificate the server can only
+				  // pick an ECDHE-ECDSA suite (no RSA key exchange); the cipher is its choice
+	Psk = 2		  // TLS-PSK (per-device key): no certificates, no public-key operations
+};
+
+struct TlsConfig
+{
+	TlsProfile profile = TlsProfile::Insecure;
+	const char *caPem = nullptr;	   // PinnedCa
+	const char *pskIdentity = nullptr; // Psk
+	const char *pskHex = nullptr;	   // Psk: key as hex digits
+};
+
+const char *tlsProfileName(TlsProfile profile);
+
+// One HTTP/1.1 connection (plain or TLS) kept open across requests within a wake.
+// Requests to the same scheme/host/port reuse the socket and skip TCP + TLS handshakes.
+// New connections go to a cached IP (RTC memory, survives deep sleep) when it is fresh;
+// TLS still sends the host name for SNI and the Host header is unchanged.
+class HttpConnection
+{
+public:
+	// Reuses the open socket when it matches and is still alive, else reconnects.
+	bool open(const char *host, uint16_t port, bool https, const TlsConfig &tls, uint32_t timeoutMs);
+	void close();
+
+	void setDnsTtl(uint32_t seconds) { _dnsTtlSec = seconds; } // 0 disables the cache
+	uint32_t dnsTtl() const { return _dnsTtlSec; }
+
+	bool matches(const char *host, uint16_t port, bool https);
+	bool reused() const { return _reused; }
+	void countRequest() { _requests++; }
+	uint32_t handshakeMs() const { return _handshakeMs; } // TCP + TLS of the current socket
+
+	WiFiClient &client() { return _https ? (WiFiClient &)_tls : _plain; }
+
+private:
+	WiFiClient _plain;
+	WiFiClientSecure _tls;
+
+	bool _open = false;
+	bool _https = false;
+	bool _reused = false;
+	char _host[64] = {0}; // fixed: outlives the per-request arena scope
+	uint16_t _port = 0;
+	uint32_t _requests = 0;
+	uint32_t _dnsTtlSec = 3600;
+	uint32_t _handshakeMs = 0;
+};
 
 class AppNetworkManager
 {
@@ -12,14 +105,35 @@ public:
 
 	AppNetworkManager(const char *ssid, const char *pass);
 
-	void setInsecureHttps(bool enabled);
+	void setInsecureHttps(bool enabled); // true = TlsProfile::Insecure, false = PinnedCa
+	void setTlsConfig(const TlsConfig &tls);
+	const TlsConfig &tlsConfig() const { return _tls; }
+	void setTimeSyncEnabled(bool enabled); // start NTP after association (default off: opt in per wake)
+	void setMaxRedirects(uint8_t maxRedirects);
+	void setDnsCacheTtl(uint32_t seconds); // host -> IP cache lifetime (fixed: lwIP doesn't report record TTLs)
+
 	void disableBluetooth();
 
 	bool connectWiFi(uint32_t timeoutMs);
 	bool isConnected() const;
 
+	// Drop the keep-alive connection (call before WiFi goes down).
+	void closeConnection();
+
+	// Non-blocking TCP connects to all URLs at once; index of the first to accept, -1 if none
+	// within timeoutMs. Probe only: the sockets are closed, the fetch opens its own.
+	int raceConnect(const char *const *urls, size_t count, uint32_t timeoutMs);
+
+	// SNTP as a wakeLoop() task: starts it (once per wake) and returns its id.
+	// syncTimeNtp is the blocking form; it pumps the loop until the first answer.
+	int startTimeSync();
+	bool timeSynced() const;
 	bool syncTimeNtp(uint32_t timeoutMs);
 
+	// Starts lookups for the URLs' hosts (those not fresh in the RTC cache) on the wake
+	// loop, so they resolve while something else waits; connect picks the answer up.
+	void prefetchDns(const char *const *urls, size_t count);
+
 	bool httpGet(const char *url, String &responseBody, uint32_t timeoutMs);
 
 	bool httpGetStream(
@@ -32,21 +146,35 @@ public:
 		String *outContentType = nullptr,
 		int *outContentLength = nullptr);
 
+	bool httpGetStream(
+		const char *url,
+		ChunkCallback cb,
+		void *user,
+		uint32_t timeoutMs,
+		const HttpRequestOptions &req,
+		HttpResponseInfo &resp);
+
 private:
 	bool isHttpsUrl(const char *url) const;
 
-	bool httpsGetRaw(
+	// Raw HTTP/1.1 over _conn for both schemes; timeoutMs is a deadline for the whole
+	// request including connect, redirects and body.
+	bool httpGetRaw(
 		const char *url,
 		ChunkCallback cb,
 		void *user,
 		uint32_t timeoutMs,
-		int *outHttpCode,
-		String *outError,
-		String *outContentType,
-		int *outContentLength);
+		const HttpRequestOptions &req,
+		HttpResponseInfo &resp);
 
 private:
 	const char *_ssid;
 	const char *_pass;
-	bool _insecureHttps = false;
+	RadioPolicy _radio;
+	TlsConfig _tls;
+	bool _timeSync = false;
+	int _ntpTask = -1;
+	uint8_t _maxRedirects = 3;
+
+	HttpConnection _conn;
 };
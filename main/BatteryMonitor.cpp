@@ -0,0 +1,145 @@
+#include "BatteryMonitor.h"
+
+// Resting Li-Po discharge curve (single cell, light load). mV -> percent.
+struct CurvePoint
+{
+	uint16_t mv;
+	uint8_t pct;
+};
+
+static const CurvePoint LIPO_CURVE[] = {
+	{4200, 100},
+	{4100, 90},
+	{4000, 80},
+	{3930, 70},
+	{3870, 60},
+	{3820, 50},
+	{3790, 40},
+	{3770, 30},
+	{3730, 20},
+	{3700, 15},
+	{3680, 10},
+	{3500, 5},
+	{3300, 0},
+};
+
+// Lower bound (percent) of each tier, index = BatteryTier
+static const uint8_t TIER_MIN_PCT[] = {20, 10, 5, 0};
+
+BatteryMonitor::BatteryMonitor(int adcPin, float dividerRatio, float calScale, int calOffsetMv)
+	: _pin(adcPin), _dividerRatio(dividerRatio), _calScale(calScale), _calOffsetMv(calOffsetMv) {}
+
+void BatteryMonitor::begin()
+{
+	if (!enabled())
+		return;
+	pinMode(_pin, INPUT);
+	analogSetPinAttenuation(_pin, ADC_11db); // ~150..2450 mV usable range at the pin
+}
+
+uint32_t BatteryMonitor::sampleMilliVolts(uint8_t samples)
+{
+	if (!enabled())
+		return 0;
+	if (samples == 0)
+		samples = 1;
+
+	// First conversion after wake is often off; discard it.
+	(void)analogReadMilliVolts(_pin);
+
+	// analogReadMilliVolts() applies the eFuse (Vref / two-point) ADC calibration.
+	// Drop min and max to reject single-sample spikes.
+	uint32_t sum = 0;
+	uint32_t mn = UINT32_MAX;
+	uint32_t mx = 0;
+	for (uint8_t i = 0; i < samples; i++)
+	{
+		uint32_t v = analogReadMilliVolts(_pin);
+		sum += v;
+		if (v < mn)
+			mn = v;
+		if (v > mx)
+			mx = v;
+		delayMicroseconds(200);
+	}
+
+	uint32_t pinMv;
+	if (samples > 2)
+		pinMv = (sum - mn - mx) / (samples - 2);
+	else
+		pinMv = sum / samples;
+
+	float mv = (float)pinMv * _dividerRatio * _calScale + (float)_calOffsetMv;
+	if (mv < 0)
+		mv = 0;
+
+	Serial.printf("[BAT] pin=%u mV battery=%u mV (samples=%u)\n",
+				  (unsigned)pinMv, (unsigned)mv, (unsigned)samples);
+	return (uint32_t)mv;
+}
+
+uint8_t BatteryMonitor::percentFromMilliVolts(uint32_t mv)
+{
+	const size_t n = sizeof(LIPO_CURVE) / sizeof(LIPO_CURVE[0]);
+
+	if (mv >= LIPO_CURVE[0].mv)
+		return 100;
+	if (mv <= LIPO_CURVE[n - 1].mv)
+		return 0;
+
+	for (size_t i = 1; i < n; i++)
+	{
+		const CurvePoint &hi = LIPO_CURVE[i - 1];
+		const CurvePoint &lo = LIPO_CURVE[i];
+		if (mv >= lo.mv)
+		{
+			// Linear interpolation inside the segment
+			uint32_t span = hi.mv - lo.mv;
+			uint32_t into = mv - lo.mv;
+			return (uint8_t)(lo.pct + (into * (hi.pct - lo.pct)) / span);
+		}
+	}
+
+	return 0;
+}
+
+BatteryTier BatteryMonitor::tierFor(uint8_t percent, BatteryTier previous, uint8_t hysteresisPct)
+{
+	BatteryTier tier = BatteryTier::Dormant;
+	for (uint8_t t = 0; t < 4; t++)
+	{
+		if (percent >= TIER_MIN_PCT[t])
+		{
+			tier = (BatteryTier)t;
+			break;
+		}
+	}
+
+	// Moving to a better tier needs margin above its threshold; avoids flapping
+	// when the voltage recovers a little after the radio is off.
+	if ((uint8_t)tier < (uint8_t)previous)
+	{
+		uint8_t better = (uint8_t)previous - 1;
+		if (percent < TIER_MIN_PCT[better] + hysteresisPct)
+			return previous;
+		return (BatteryTier)better;
+	}
+
+	return tier;
+}
+
+const char *BatteryMonitor::tierName(BatteryTier tier)
+{
+	switch (tier)
+	{
+	case BatteryTier::Normal:
+		return "NORMAL";
+	case BatteryTier::Low:
+		return "LOW";
+	case BatteryTier::Critical:
+		return "CRITICAL";
+	case BatteryTier::Dormant:
+		return "DORMANT";
+	}
+	return "?";
+}
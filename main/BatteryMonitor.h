@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+
+enum class BatteryTier : uint8_t
+{
+	Normal = 0,	 // full cadence, NTP, status screens
+	Low = 1,	 // longer cadence, no NTP, no status screens
+	Critical = 2, // longest cadence, bitmap only
+	Dormant = 3	 // low-battery frame shown once, radio stays off
+};
+
+class BatteryMonitor
+{
+public:
+	// Below any cell that can still run the board: no divider fitted (the pin reads ~0).
+	static constexpr uint32_t MIN_PLAUSIBLE_MV = 2500;
+
+	// adcPin -1 = no battery sense (sampleMilliVolts returns 0)
+	// dividerRatio = Vbat / Vpin (100k/100k divider => 2.0)
+	// calScale / calOffsetMv: per-board linear correction measured against a multimeter
+	BatteryMonitor(int adcPin, float dividerRatio, float calScale = 1.0f, int calOffsetMv = 0);
+
+	void begin();
+	bool enabled() const { return _pin >= 0; }
+
+	// Averaged, calibrated battery voltage. Call before WiFi is enabled:
+	// radio TX bursts sag the rail and skew the reading.
+	uint32_t sampleMilliVolts(uint8_t samples = 16);
+
+	static uint8_t percentFromMilliVolts(uint32_t mv);
+
+	// Tier with hysteresis: leaving a worse tier requires hysteresisPct extra charge.
+	static BatteryTier tierFor(uint8_t percent, BatteryTier previous, uint8_t hysteresisPct = 3);
+
+	static const char *tierName(BatteryTier tier);
+
+private:
+	int _pin;
+	float _dividerRatio;
+	float _calScale;
+	int _calOffsetMv;
+};
@@ -0,0 +1,174 @@
+#include "BitRotate.h"
+
+#include <string.h>
+
+void transpose8x8(const uint8_t *in, size_t inStride, uint8_t *out, size_t outStride)
+{
+	// Hacker's Delight transpose8, two 32-bit halves (4 rows each)
+	uint32_t x = ((uint32_t)in[0] << 24) | ((uint32_t)in[inStride] << 16) |
+				 ((uint32_t)in[2 * inStride] << 8) | in[3 * inStride];
+	uint32_t y = ((uint32_t)in[4 * inStride] << 24) | ((uint32_t)in[5 * inStride] << 16) |
+				 ((uint32_t)in[6 * inStride] << 8) | in[7 * inStride];
+	uint32_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AAu;
+	x = x ^ t ^ (t << 7);
+	t = (y ^ (y >> 7)) & 0x00AA00AAu;
+	y = y ^ t ^ (t << 7);
+
+	t = (x ^ (x >> 14)) & 0x0000CCCCu;
+	x = x ^ t ^ (t << 14);
+	t = (y ^ (y >> 14)) & 0x0000CCCCu;
+	y = y ^ t ^ (t << 14);
+
+	t = (x & 0xF0F0F0F0u) | ((y >> 4) & 0x0F0F0F0Fu);
+	y = ((x << 4) & 0xF0F0F0F0u) | (y & 0x0F0F0F0Fu);
+	x = t;
+
+	out[0] = (uint8_t)(x >> 24);
+	out[outStride] = (uint8_t)(x >> 16);
+	out[2 * outStride] = (uint8_t)(x >> 8);
+	out[3 * outStride] = (uint8_t)x;
+	out[4 * outStride] = (uint8_t)(y >> 24);
+	out[5 * outStride] = (uint8_t)(y >> 16);
+	out[6 * outStride] = (uint8_t)(y >> 8);
+	out[7 * outStride] = (uint8_t)y;
+}
+
+uint8_t reverseBits8(uint8_t b)
+{
+	b = (uint8_t)((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+	b = (uint8_t)((b & 0xCC) >> 2 | (b & 0x33) << 2);
+	b = (uint8_t)((b & 0xAA) >> 1 | (b & 0x55) << 1);
+	return b;
+}
+
+// Copy one row, optionally reversed (bytes and bits) = horizontal flip
+static void copyRow(const uint8_t *src, uint8_t *dst, size_t bytes, bool reverse)
+{
+	if (!reverse)
+	{
+		memcpy(dst, src, bytes);
+		return;
+	}
+	for (size_t i = 0; i < bytes; i++)
+		dst[bytes - 1 - i] = reverseBits8(src[i]);
+}
+
+bool rotateToNative(const uint8_t *src, uint16_t w, uint16_t h, uint8_t rotation, bool mirror,
+					uint8_t *dst, uint16_t y0, uint16_t y1)
+{
+	if (!src || !dst || (w & 7) || y1 > h || y0 > y1 || rotation > 3)
+		return false;
+	// 90/270 work on whole 8x8 blocks; the logical height becomes the native byte width
+	if ((rotation & 1) && ((h & 7) || (y0 & 7) || (y1 & 7)))
+		return false;
+
+	const size_t srcStride = w / 8;
+
+	if (rotation == 0 || rotation == 2)
+	{
+		// Native geometry == logical; 2 flips both axes, mirror flips x once more
+		const bool flipX = (rotation == 2) != mirror;
+		for (uint16_t y = y0; y < y1; y++)
+		{
+			const uint16_t ny = (rotation == 2) ? (uint16_t)(h - 1 - y) : y;
+			copyRow(src + (size_t)y * srcStride, dst + (size_t)ny * srcStride, srcStride, flipX);
+		}
+		return true;
+	}
+
+	// 90 / 270: native is h x w; each 8x8 logical block lands as one transposed block.
+	const size_t dstStride = h / 8;
+	const uint16_t nbx = h / 8; // native byte columns
+	uint8_t block[8];
+	uint8_t tb[8];
+
+	for (uint16_t by = y0 / 8; by < y1 / 8; by++)
+	{
+		const uint8_t *rowBase = src + (size_t)by * 8 * srcStride;
+
+		for (uint16_t bx = 0; bx < srcStride; bx++)
+		{
+			const uint8_t *in = rowBase + bx;
+
+			if (rotation == 1)
+			{
+				// native[r][k] = L[7-k][r]: transpose the vertically flipped block
+				for (int i = 0; i < 8; i++)
+					block[i] = in[(7 - i) * srcStride];
+				transpose8x8(block, 1, tb, 1);
+
+				uint16_t col = (uint16_t)(nbx - 1 - by);
+				uint8_t *out = dst + (size_t)bx * 8 * dstStride;
+				if (mirror)
+				{
+					col = by;
+					for (int r = 0; r < 8; r++)
+						out[r * dstStride + col] = reverseBits8(tb[r]);
+				}
+				else
+				{
+					for (int r = 0; r < 8; r++)
+						out[r * dstStride + col] = tb[r];
+				}
+			}
+			else
+			{
+				// native[7-c][k] = L[k][c]: transpose, then rows land bottom-up
+				transpose8x8(in, srcStride, tb, 1);
+
+				const size_t nyBase = (size_t)(w - 8 - bx * 8);
+				uint8_t *out = dst + nyBase * dstStride;
+				if (mirror)
+				{
+					const uint16_t col = (uint16_t)(nbx - 1 - by);
+					for (int r = 0; r < 8; r++)
+						out[(7 - r) * dstStride + col] = reverseBits8(tb[r]);
+				}
+				else
+				{
+					for (int r = 0; r < 8; r++)
+						out[(7 - r) * dstStride + by] = tb[r];
+				}
+			}
+		}
+	}
+	return true;
+}
+
+void nativeRectForRows(uint16_t w, uint16_t h, uint8_t rotation, bool mirror, uint16_t y0, uint16_t y1,
+					   uint16_t *outX, uint16_t *outY, uint16_t *outW, uint16_t *outH)
+{
+	uint16_t x = 0, y = 0, rw = w, rh = (uint16_t)(y1 - y0);
+
+	switch (rotation & 3)
+	{
+	case 0:
+		y = y0;
+		break;
+	case 2:
+		y = (uint16_t)(h - y1);
+		break;
+	case 1:
+		// logical rows become native columns counted from the right
+		rw = (uint16_t)(y1 - y0);
+		rh = w;
+		x = mirror ? y0 : (uint16_t)(h - y1);
+		break;
+	case 3:
+		rw = (uint16_t)(y1 - y0);
+		rh = w;
+		x = mirror ? (uint16_t)(h - y1) : y0;
+		break;
+	}
+
+	if (outX)
+		*outX = x;
+	if (outY)
+		*outY = y;
+	if (outW)
+		*outW = rw;
+	if (outH)
+		*outH = rh;
+}
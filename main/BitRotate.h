@@ -0,0 +1,42 @@
+#pragma once
+
+// No Arduino.h: also built on the host by tools/bench/bitrotate_bench.cpp
+#include <stddef.h>
+#include <stdint.h>
+
+// 1-bpp bitmap rotation into controller RAM order.
+//
+// Bitmaps are row-major, MSB = leftmost pixel, stride = w / 8 (P4 layout).
+// rotation uses the GxEPD2 convention: the logical frame (w x h, as drawn with
+// setRotation(rotation)) is mapped to the native panel (nw x nh):
+//
+//   0: nx = x,          ny = y             (nw = w, nh = h)
+//   1: nx = nw - 1 - y, ny = x             (nw = h, nh = w)
+//   2: nx = nw - 1 - x, ny = nh - 1 - y    (nw = w, nh = h)
+//   3: nx = y,          ny = nh - 1 - x    (nw = h, nh = w)
+//
+// mirror additionally flips the native image horizontally (nx = nw - 1 - nx).
+// w must be a multiple of 8. For 90/270 the work is done per 8x8 bit block with a
+// 32-bit SWAR transpose, so h (and any row range) must be a multiple of 8 as well.
+
+// Transpose one 8x8 bit block: out row r = column r of in (MSB first).
+void transpose8x8(const uint8_t *in, size_t inStride, uint8_t *out, size_t outStride);
+
+// Reverse the bit order of a byte (pixel mirror within a byte).
+uint8_t reverseBits8(uint8_t b);
+
+// Rotate logical rows [y0, y1) of src into their native position in dst. dst holds the
+// full native frame (nw/8 * nh bytes); only the bytes fed by those rows are written, so a
+// frame can be converted band by band as it streams in. Returns false for unsupported geometry.
+bool rotateToNative(const uint8_t *src, uint16_t w, uint16_t h, uint8_t rotation, bool mirror,
+					uint8_t *dst, uint16_t y0, uint16_t y1);
+
+inline bool rotateToNative(const uint8_t *src, uint16_t w, uint16_t h, uint8_t rotation, bool mirror,
+						   uint8_t *dst)
+{
+	return rotateToNative(src, w, h, rotation, mirror, dst, 0, h);
+}
+
+// Native rectangle written by rotateToNative for logical rows [y0, y1) (x/w are byte aligned).
+void nativeRectForRows(uint16_t w, uint16_t h, uint8_t rotation, bool mirror, uint16_t y0, uint16_t y1,
+					   uint16_t *outX, uint16_t *outY, uint16_t *outW, uint16_t *outH);
@@ -0,0 +1,424 @@
+#include "Digest.h"
+
+size_t digestLength(DigestAlgo algo)
+{
+	switch (algo)
+	{
+	case DigestAlgo::Md5:
+		return 16;
+	case DigestAlgo::Sha256:
+		return 32;
+	default:
+		return 0;
+	}
+}
+
+const char *digestName(DigestAlgo algo)
+{
+	switch (algo)
+	{
+	case DigestAlgo::Md5:
+		return "MD5";
+	case DigestAlgo::Sha256:
+		return "SHA-256";
+	default:
+		return "none";
+	}
+}
+
+// ---------------- header parsing ----------------
+
+static int base64Value(char c)
+{
+	if (c >= 'A' && c <= 'Z')
+		return c - 'A';
+	if (c >= 'a' && c <= 'z')
+		return c - 'a' + 26;
+	if (c >= '0' && c <= '9')
+		return c - '0' + 52;
+	if (c == '+' || c == '-')
+		return 62;
+	if (c == '/' || c == '_')
+		return 63;
+	return -1;
+}
+
+// Decodes exactly outLen bytes; stops at '=', ':' or the end of the string.
+static bool base64DecodeExact(const char *in, uint8_t *out, size_t outLen)
+{
+	uint32_t acc = 0;
+	int bits = 0;
+	size_t n = 0;
+
+	for (; *in && *in != '=' && *in != ':' && *in != ','; in++)
+	{
+		int v = base64Value(*in);
+		if (v < 0)
+			return false;
+		acc = (acc << 6) | (uint32_t)v;
+		bits += 6;
+		if (bits >= 8)
+		{
+			bits -= 8;
+			if (n >= outLen)
+				return false;
+			out[n++] = (uint8_t)(acc >> bits);
+		}
+	}
+	return n == outLen;
+}
+
+static bool hexDecodeExact(const char *in, uint8_t *out, size_t outLen)
+{
+	for (size_t i = 0; i < outLen; i++)
+	{
+		int v = 0;
+		for (int k = 0; k < 2; k++)
+		{
+			char c = *in++;
+			int d = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+												   : (c >= 'A' && c <= 'F')	  ? c - 'A' + 10
+																			  : -1;
+			if (d < 0)
+				return false;
+			v = (v << 4) | d;
+		}
+		out[i] = (uint8_t)v;
+	}
+	return true;
+}
+
+// "sha-256=:b64:, md5=..." or "SHA-256=b64,MD5=b64": first entry for a supported algorithm
+static bool findListEntry(const char *value, DigestAlgo &algo, const char *&encoded)
+{
+	const char *p = value;
+	DigestAlgo best = DigestAlgo::None;
+	const char *bestEnc = nullptr;
+
+	while (*p)
+	{
+		while (*p == ' ' || *p == ',')
+			p++;
+		const char *eq = strchr(p, '=');
+		if (!eq)
+			break;
+
+		DigestAlgo a = DigestAlgo::None;
+		if ((size_t)(eq - p) == 7 && strncasecmp(p, "sha-256", 7) == 0)
+			a = DigestAlgo::Sha256;
+		else if ((size_t)(eq - p) == 3 && strncasecmp(p, "md5", 3) == 0)
+			a = DigestAlgo::Md5;
+
+		const char *enc = eq + 1;
+		if (*enc == ':')
+			enc++;
+		if ((uint8_t)a > (uint8_t)best)
+		{
+			best = a;
+			bestEnc = enc;
+		}
+
+		const char *comma = strchr(enc, ',');
+		if (!comma)
+			break;
+		p = comma + 1;
+	}
+
+	algo = best;
+	encoded = bestEnc;
+	return best != DigestAlgo::None;
+}
+
+bool parseDigestHeader(const char *name, const char *value, ExpectedDigest &out)
+{
+	ExpectedDigest d;
+	const char *enc = nullptr;
+	bool ok = false;
+
+	if (strcasecmp(name, "content-digest") == 0 || strcasecmp(name, "repr-digest") == 0 ||
+		strcasecmp(name, "digest") == 0)
+	{
+		d.wholeRepresentation = strcasecmp(name, "content-digest") != 0;
+		ok = findListEntry(value, d.algo, enc) && base64DecodeExact(enc, d.value, digestLength(d.algo));
+	}
+	else if (strcasecmp(name, "content-md5") == 0)
+	{
+		d.algo = DigestAlgo::Md5;
+		ok = base64DecodeExact(value, d.value, 16);
+	}
+	else if (strcasecmp(name, "x-content-sha256") == 0)
+	{
+		d.algo = DigestAlgo::Sha256;
+		ok = strlen(value) >= 64 && hexDecodeExact(value, d.value, 32);
+	}
+	else
+	{
+		return false;
+	}
+
+	if (!ok)
+	{
+		Serial.printf("[DIGEST] Ignoring malformed %s header\n", name);
+		return false;
+	}
+
+	// Prefer the stronger algorithm; at equal strength prefer a body (per-message) digest.
+	if ((uint8_t)d.algo < (uint8_t)out.algo)
+		return false;
+	if (d.algo == out.algo && d.wholeRepresentation && !out.wholeRepresentation)
+		return false;
+
+	out = d;
+	return true;
+}
+
+// ---------------- hashing ----------------
+
+#if defined(ESP_PLATFORM)
+
+// mbedTLS 3 dropped the _ret suffix
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+#define SHA256_STARTS mbedtls_sha256_starts
+#define SHA256_UPDATE mbedtls_sha256_update
+#define SHA256_FINISH mbedtls_sha256_finish
+#define MD5_STARTS mbedtls_md5_starts
+#define MD5_UPDATE mbedtls_md5_update
+#define MD5_FINISH mbedtls_md5_finish
+#else
+#define SHA256_STARTS mbedtls_sha256_starts_ret
+#define SHA256_UPDATE mbedtls_sha256_update_ret
+#define SHA256_FINISH mbedtls_sha256_finish_ret
+#define MD5_STARTS mbedtls_md5_starts_ret
+#define MD5_UPDATE mbedtls_md5_update_ret
+#define MD5_FINISH mbedtls_md5_finish_ret
+#endif
+
+void StreamDigest::begin(DigestAlgo algo)
+{
+	release();
+	_algo = algo;
+	if (algo == DigestAlgo::Sha256)
+	{
+		mbedtls_sha256_init(&_sha);
+		SHA256_STARTS(&_sha, 0);
+	}
+	else if (algo == DigestAlgo::Md5)
+	{
+		mbedtls_md5_init(&_md5);
+		MD5_STARTS(&_md5);
+	}
+}
+
+void StreamDigest::update(const uint8_t *data, size_t len)
+{
+	if (_algo == DigestAlgo::Sha256)
+		SHA256_UPDATE(&_sha, data, len);
+	else if (_algo == DigestAlgo::Md5)
+		MD5_UPDATE(&_md5, data, len);
+}
+
+size_t StreamDigest::finish(uint8_t *out)
+{
+	const size_t n = digestLength(_algo);
+	if (_algo == DigestAlgo::Sha256)
+		SHA256_FINISH(&_sha, out);
+	else if (_algo == DigestAlgo::Md5)
+		MD5_FINISH(&_md5, out);
+	release();
+	return n;
+}
+
+void StreamDigest::release()
+{
+	if (_algo == DigestAlgo::Sha256)
+		mbedtls_sha256_free(&_sha);
+	else if (_algo == DigestAlgo::Md5)
+		mbedtls_md5_free(&_md5);
+	_algo = DigestAlgo::None;
+}
+
+#else // host: portable SHA-256 / MD5
+
+static inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+static inline uint32_t rotl(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+static const uint32_t SHA256_K[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static void sha256Block(uint32_t *s, const uint8_t *p)
+{
+	uint32_t w[64];
+	for (int i = 0; i < 16; i++)
+		w[i] = (uint32_t)p[4 * i] << 24 | (uint32_t)p[4 * i + 1] << 16 | (uint32_t)p[4 * i + 2] << 8 | p[4 * i + 3];
+	for (int i = 16; i < 64; i++)
+	{
+		uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+		uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+		w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+	}
+
+	uint32_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+	for (int i = 0; i < 64; i++)
+	{
+		uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+		uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+	s[0] += a, s[1] += b, s[2] += c, s[3] += d, s[4] += e, s[5] += f, s[6] += g, s[7] += h;
+}
+
+static const uint32_t MD5_K[64] = {
+	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+	0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+	0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+	0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+	0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+	0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+	0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+static const uint8_t MD5_R[64] = {
+	7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+	5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+	4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+	6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+
+static void md5Block(uint32_t *s, const uint8_t *p)
+{
+	uint32_t m[16];
+	for (int i = 0; i < 16; i++)
+		m[i] = (uint32_t)p[4 * i] | (uint32_t)p[4 * i + 1] << 8 | (uint32_t)p[4 * i + 2] << 16 | (uint32_t)p[4 * i + 3] << 24;
+
+	uint32_t a = s[0], b = s[1], c = s[2], d = s[3];
+	for (int i = 0; i < 64; i++)
+	{
+		uint32_t f;
+		int g;
+		if (i < 16)
+			f = (b & c) | (~b & d), g = i;
+		else if (i < 32)
+			f = (d & b) | (~d & c), g = (5 * i + 1) & 15;
+		else if (i < 48)
+			f = b ^ c ^ d, g = (3 * i + 5) & 15;
+		else
+			f = c ^ (b | ~d), g = (7 * i) & 15;
+
+		uint32_t t = d;
+		d = c;
+		c = b;
+		b = b + rotl(a + f + MD5_K[i] + m[g], MD5_R[i]);
+		a = t;
+	}
+	s[0] += a, s[1] += b, s[2] += c, s[3] += d;
+}
+
+void StreamDigest::begin(DigestAlgo algo)
+{
+	static const uint32_t SHA256_IV[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+										  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+	static const uint32_t MD5_IV[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+
+	_algo = algo;
+	memset(&_soft, 0, sizeof(_soft));
+	if (algo == DigestAlgo::Sha256)
+		memcpy(_soft.state, SHA256_IV, sizeof(SHA256_IV));
+	else if (algo == DigestAlgo::Md5)
+		memcpy(_soft.state, MD5_IV, sizeof(MD5_IV));
+}
+
+void StreamDigest::update(const uint8_t *data, size_t len)
+{
+	if (_algo == DigestAlgo::None)
+		return;
+
+	_soft.length += len;
+	while (len)
+	{
+		size_t take = 64 - _soft.used;
+		if (take > len)
+			take = len;
+		memcpy(_soft.block + _soft.used, data, take);
+		_soft.used += take;
+		data += take;
+		len -= take;
+
+		if (_soft.used == 64)
+		{
+			if (_algo == DigestAlgo::Sha256)
+				sha256Block(_soft.state, _soft.block);
+			else
+				md5Block(_soft.state, _soft.block);
+			_soft.used = 0;
+		}
+	}
+}
+
+size_t StreamDigest::finish(uint8_t *out)
+{
+	const size_t n = digestLength(_algo);
+	if (!n)
+		return 0;
+
+	const bool sha = _algo == DigestAlgo::Sha256;
+	const uint64_t bits = _soft.length * 8;
+
+	uint8_t pad[72];
+	size_t padLen = (_soft.used < 56) ? 56 - _soft.used : 120 - _soft.used;
+	memset(pad, 0, sizeof(pad));
+	pad[0] = 0x80;
+	for (int i = 0; i < 8; i++)
+		pad[padLen + i] = sha ? (uint8_t)(bits >> (56 - 8 * i)) : (uint8_t)(bits >> (8 * i));
+
+	const uint64_t keep = _soft.length;
+	update(pad, padLen + 8);
+	_soft.length = keep;
+
+	for (size_t i = 0; i < n / 4; i++)
+	{
+		uint32_t v = _soft.state[i];
+		for (int k = 0; k < 4; k++)
+			out[4 * i + k] = sha ? (uint8_t)(v >> (24 - 8 * k)) : (uint8_t)(v >> (8 * k));
+	}
+
+	release();
+	return n;
+}
+
+void StreamDigest::release()
+{
+	_algo = DigestAlgo::None;
+}
+
+#endif
+
+StreamDigest::~StreamDigest()
+{
+	release();
+}
+
+bool StreamDigest::matches(const ExpectedDigest &expected)
+{
+	uint8_t got[DIGEST_MAX_BYTES];
+	if (expected.algo == DigestAlgo::None || expected.algo != _algo)
+		return false;
+
+	const size_t n = finish(got);
+	uint8_t diff = 0;
+	for (size_t i = 0; i < n; i++)
+		diff |= got[i] ^ expected.value[i];
+	return n && diff == 0;
+}
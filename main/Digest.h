@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Arduino.h>
+
+#if defined(ESP_PLATFORM)
+#include <mbedtls/md5.h>
+#include <mbedtls/sha256.h>
+#endif
+
+// Incremental body digests for integrity checks. On the ESP32, mbedTLS routes SHA-256
+// through the hardware SHA accelerator; host builds use the portable code in Digest.cpp.
+
+enum class DigestAlgo : uint8_t
+{
+	None = 0,
+	Md5 = 1,
+	Sha256 = 2
+};
+
+static constexpr size_t DIGEST_MAX_BYTES = 32;
+
+size_t digestLength(DigestAlgo algo);
+const char *digestName(DigestAlgo algo);
+
+// Expected value announced by the server. Accepted headers, strongest algorithm wins:
+//   Content-Digest: sha-256=:<base64>:      (RFC 9530, this message's body)
+//   Repr-Digest: sha-256=:<base64>:         (RFC 9530, whole representation)
+//   Digest: SHA-256=<base64> / MD5=<base64> (RFC 3230, whole representation)
+//   Content-MD5: <base64>                   (RFC 1864, this message's body)
+//   X-Content-SHA256: <hex>                 (this message's body)
+struct ExpectedDigest
+{
+	DigestAlgo algo = DigestAlgo::None;
+	bool wholeRepresentation = false; // covers the full entity, not a 206 slice
+	uint8_t value[DIGEST_MAX_BYTES];
+};
+
+// Header name is matched case-insensitively. Returns true when the header was a digest
+// the device can check and it replaced a weaker one in out.
+bool parseDigestHeader(const char *name, const char *value, ExpectedDigest &out);
+
+class StreamDigest
+{
+public:
+	StreamDigest() {}
+	~StreamDigest();
+
+	void begin(DigestAlgo algo);
+	void update(const uint8_t *data, size_t len);
+
+	// Writes digestLength(algo()) bytes; the digest must be begun again afterwards.
+	size_t finish(uint8_t *out);
+
+	// finish() and compare against the expected value
+	bool matches(const ExpectedDigest &expected);
+
+	DigestAlgo algo() const { return _algo; }
+
+private:
+	void release();
+
+	DigestAlgo _algo = DigestAlgo::None;
+
+#if defined(ESP_PLATFORM)
+	mbedtls_sha256_context _sha;
+	mbedtls_md5_context _md5;
+#else
+	struct Soft
+	{
+		uint32_t state[8];
+		uint64_t length;
+		uint8_t block[64];
+		size_t used;
+	} _soft;
+#endif
+};
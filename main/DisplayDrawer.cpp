@@ -1,68 +1,62 @@
 #include "DisplayDrawer.h"
+#include "BitRotate.h"
 
 static constexpr int MARGIN_X = 10;
 static constexpr int START_Y = 40;
 static constexpr int LINE_GAP = 34;
 
-DisplayDrawer::DisplayDrawer(
+template <typename Panel>
+DisplayDrawer<Panel>::DisplayDrawer(
 	DisplayType &display,
-	int sck, int miso, int mosi, int cs,
-	int preferredRotation,
-	int targetW,
-	int targetH)
+	int sck, int miso, int mosi, int cs)
 	: _display(display),
-	  _sck(sck), _miso(miso), _mosi(mosi), _cs(cs),
-	  _rotation(preferredRotation),
-	  _preferredRotation(preferredRotation),
-	  _targetW(targetW),
-	  _targetH(targetH)
+	  _sck(sck), _miso(miso), _mosi(mosi), _cs(cs)
 {
 }
 
-int DisplayDrawer::pickRotationForTarget(int targetW, int targetH, int preferred)
+template <typename Panel>
+void DisplayDrawer<Panel>::begin(uint32_t serialBaudForInit, bool initial)
 {
-	// Try preferred first, then the others.
-	int order[4] = {preferred, 0, 1, 2};
+	SPI.begin(_sck, _miso, _mosi, _cs);
 
-	bool used[4] = {false, false, false, false};
+	_initial = initial;
+	_display.init(serialBaudForInit, initial, 2, false);
 
-	for (int i = 0; i < 4; i++)
-	{
-		int r = order[i];
-		if (r < 0 || r > 3)
-			continue;
-		if (used[r])
-			continue;
-		used[r] = true;
-
-		_display.setRotation(r);
-		int w = _display.width();
-		int h = _display.height();
-
-		if (w == targetW && h == targetH)
-			return r;
-	}
+	// Rotation is fixed by PanelTraits so that width x height == frame size
+	_display.setRotation(Panel::ROTATION);
 
-	// If no exact match, keep preferred (but you’ll see it in Serial).
-	_display.setRotation(preferred);
-	return preferred;
+	Serial.printf("[EPD] rotation=%d width=%d height=%d (frame=%ux%u)\n",
+				  Panel::ROTATION, _display.width(), _display.height(),
+				  (unsigned)Panel::WIDTH, (unsigned)Panel::HEIGHT);
 }
 
-void DisplayDrawer::begin(uint32_t serialBaudForInit)
+// Only drivers with a fast full waveform have useFastFullUpdate (see GrayUpload below)
+template <bool FastFull>
+struct FastWaveform
 {
-	SPI.begin(_sck, _miso, _mosi, _cs);
-
-	_display.init(serialBaudForInit, true, 2, false);
+	template <typename Epd>
+	static void select(Epd &, bool) {}
+};
 
-	// Choose a rotation that yields targetW x targetH (400x300)
-	_rotation = pickRotationForTarget(_targetW, _targetH, _preferredRotation);
-	_display.setRotation(_rotation);
+template <>
+struct FastWaveform<true>
+{
+	template <typename Epd>
+	static void select(Epd &epd, bool fast)
+	{
+		epd.useFastFullUpdate = fast;
+	}
+};
 
-	Serial.printf("[EPD] rotation=%d width=%d height=%d (target=%dx%d)\n",
-				  _rotation, _display.width(), _display.height(), _targetW, _targetH);
+template <typename Panel>
+void DisplayDrawer<Panel>::selectWaveform(RefreshMode mode)
+{
+	// Set on every full refresh: the driver's own default differs between GxEPD2 versions
+	FastWaveform<Panel::FAST_FULL>::select(_display.epd2, mode == RefreshMode::Fast);
 }
 
-void DisplayDrawer::showStatus(const char *line1, const char *line2)
+template <typename Panel>
+void DisplayDrawer<Panel>::showStatus(const char *line1, const char *line2, RefreshMode mode)
 {
 	const char *lines[2];
 	size_t count = 0;
@@ -70,10 +64,11 @@ void DisplayDrawer::showStatus(const char *line1, const char *line2)
 	if (line2)
 		lines[count++] = line2;
 
-	drawLinesInternal(lines, count, true);
+	drawLinesInternal(lines, count, true, mode);
 }
 
-void DisplayDrawer::drawLines(const String *lines, size_t count)
+template <typename Panel>
+void DisplayDrawer<Panel>::drawLines(const String *lines, size_t count)
 {
 	const size_t MAX_LOCAL = 24;
 	const char *ptrs[MAX_LOCAL];
@@ -82,17 +77,20 @@ void DisplayDrawer::drawLines(const String *lines, size_t count)
 	for (size_t i = 0; i < n; i++)
 		ptrs[i] = lines[i].c_str();
 
-	drawLinesInternal(ptrs, n, false);
+	drawLinesInternal(ptrs, n, false, RefreshMode::Full);
 }
 
-void DisplayDrawer::drawLines(const char *const *lines, size_t count)
+template <typename Panel>
+void DisplayDrawer<Panel>::drawLines(const char *const *lines, size_t count)
 {
-	drawLinesInternal(lines, count, false);
+	drawLinesInternal(lines, count, false, RefreshMode::Full);
 }
 
-void DisplayDrawer::drawLinesInternal(const char *const *lines, size_t count, bool isStatus)
+template <typename Panel>
+void DisplayDrawer<Panel>::drawLinesInternal(const char *const *lines, size_t count, bool isStatus, RefreshMode mode)
 {
-	_display.setRotation(_rotation);
+	selectWaveform(mode);
+	_display.setRotation(Panel::ROTATION);
 	_display.setFullWindow();
 
 	_display.firstPage();
@@ -122,19 +120,66 @@ void DisplayDrawer::drawLinesInternal(const char *const *lines, size_t count, bo
 	} while (_display.nextPage());
 }
 
-void DisplayDrawer::drawBitmap1bpp(const uint8_t *bitmap, bool invert)
+template <typename Panel>
+bool DisplayDrawer<Panel>::uploadNative(const uint8_t *bitmap, bool invert, int16_t y0, int16_t y1, RefreshMode mode)
+{
+	if (!_direct)
+		return false;
+
+	const uint8_t *native = bitmap;
+	if (Panel::ROTATION != 0)
+	{
+		if (!rotateToNative(bitmap, Panel::WIDTH, Panel::HEIGHT, Panel::ROTATION, false, _native, y0, y1))
+			return false;
+		native = _native;
+	}
+
+	uint16_t x, y, w, h;
+	nativeRectForRows(Panel::WIDTH, Panel::HEIGHT, Panel::ROTATION, false, y0, y1, &x, &y, &w, &h);
+
+	const int16_t nw = Panel::DriverType::WIDTH;
+	const int16_t nh = Panel::DriverType::HEIGHT;
+
+	// GxEPD2 RAM is 1 = white; P4 is 1 = black
+	const bool ramInvert = !invert;
+
+	const uint32_t t0 = millis();
+	_display.epd2.writeImagePart(native, x, y, nw, nh, x, y, w, h, ramInvert);
+	if (mode != RefreshMode::Partial)
+		_display.epd2.refresh(false);
+	else
+		_display.epd2.refresh(x, y, w, h);
+	// Differential controllers keep a "previous" RAM; sync it for the next partial update
+	_display.epd2.writeImagePartAgain(native, x, y, nw, nh, x, y, w, h, ramInvert);
+
+	Serial.printf("[EPD] native upload x=%u y=%u w=%u h=%u %s (%lu ms)\n",
+				  x, y, w, h, refreshModeName(mode), (unsigned long)(millis() - t0));
+	return true;
+}
+
+template <typename Panel>
+void DisplayDrawer<Panel>::drawBitmap1bpp(const uint8_t *bitmap, bool invert, RefreshMode mode)
 {
-	_display.setRotation(_rotation);
+	if (mode == RefreshMode::Partial)
+		mode = RefreshMode::Full;
+	selectWaveform(mode);
+
+	if (uploadNative(bitmap, invert, 0, Panel::HEIGHT, mode))
+	{
+		_initial = false;
+		return;
+	}
+
+	_display.setRotation(Panel::ROTATION);
 
 	_display.setFullWindow(); // Force full-window in the chosen orientation.
 
-	// Critical: draw using the actual logical width/height after rotation selection.
-	const int16_t w = _display.width();
-	const int16_t h = _display.height();
+	// PanelTraits guarantees the rotated logical size equals the frame size.
+	const int16_t w = Panel::WIDTH;
+	const int16_t h = Panel::HEIGHT;
 
-	// If these don’t equal 400x300, your PBM stride won’t match and the image will “misplace”.
-	// This print makes it obvious.
-	Serial.printf("[EPD] drawBitmap1bpp w=%d h=%d invert=%d\n", w, h, invert ? 1 : 0);
+	static_assert(Panel::WIDTH % 8 == 0, "bitmap rows must be byte aligned");
+	Serial.printf("[EPD] drawBitmap1bpp w=%d h=%d invert=%d %s\n", w, h, invert ? 1 : 0, refreshModeName(mode));
 
 	_display.firstPage();
 	do
@@ -148,4 +193,123 @@ void DisplayDrawer::drawBitmap1bpp(const uint8_t *bitmap, bool invert)
 			_display.drawBitmap(0, 0, bitmap, w, h, GxEPD_BLACK);
 
 	} while (_display.nextPage());
+
+	_initial = false;
+}
+
+template <typename Panel>
+void DisplayDrawer<Panel>::drawBitmapBands(const uint8_t *bitmap, uint32_t changedBands, int bandRows, RefreshMode mode)
+{
+	if (changedBands == 0)
+		return;
+
+	// After a power-on init the controller RAM doesn't hold our frame
+	if (_initial || mode != RefreshMode::Partial)
+	{
+		drawBitmap1bpp(bitmap, false, mode);
+		return;
+	}
+
+	const int16_t w = Panel::WIDTH;
+	const int16_t h = Panel::HEIGHT;
+
+	int first = -1;
+	int last = -1;
+	int count = 0;
+	for (int b = 0; b < 32 && b * bandRows < h; b++)
+	{
+		if (changedBands & (1u << b))
+		{
+			if (first < 0)
+				first = b;
+			last = b;
+			count++;
+		}
+	}
+
+	const int16_t y0 = (int16_t)(first * bandRows);
+	int16_t y1 = (int16_t)((last + 1) * bandRows);
+	if (y1 > h)
+		y1 = h;
+
+	Serial.printf("[EPD] partial rows %d..%d (%d band(s) changed)\n", y0, y1 - 1, count);
+
+	if (uploadNative(bitmap, false, y0, y1, RefreshMode::Partial))
+		return;
+
+	_display.setRotation(Panel::ROTATION);
+	_display.setPartialWindow(0, y0, w, y1 - y0);
+
+	_display.firstPage();
+	do
+	{
+		_display.fillScreen(GxEPD_WHITE);
+		// Whole bitmap at the origin; GFX clips it to the partial window.
+		_display.drawBitmap(0, 0, bitmap, w, h, GxEPD_BLACK);
+	} while (_display.nextPage());
+}
+
+// Only drivers with a 4-gray waveform have writeImagePart_4G; the explicit instantiation
+// below compiles every member, so the call is kept out of the other panels' builds.
+template <bool Gray4>
+struct GrayUpload
+{
+	template <typename Epd>
+	static void strip(Epd &, const uint8_t *, int16_t, int16_t, int16_t) {}
+};
+
+template <>
+struct GrayUpload<true>
+{
+	// GxEPD2 4G input: 2 bpp, MSB first, 3 = white
+	template <typename Epd>
+	static void strip(Epd &epd, const uint8_t *packed, int16_t y, int16_t w, int16_t h)
+	{
+		epd.writeImagePart_4G(packed, 2, 0, 0, w, h, 0, y, w, h);
+	}
+};
+
+// Nibble b3..b0 -> bits 6,4,2,0
+static const uint8_t SPREAD_NIBBLE[16] = {
+	0x00, 0x01, 0x04, 0x05, 0x10, 0x11, 0x14, 0x15,
+	0x40, 0x41, 0x44, 0x45, 0x50, 0x51, 0x54, 0x55};
+
+// One byte of each plane (8 pixels of ink) -> two bytes of GxEPD2 2-bpp gray
+static inline void packGray(uint8_t hi, uint8_t lo, uint8_t *out)
+{
+	out[0] = (uint8_t)~((SPREAD_NIBBLE[hi >> 4] << 1) | SPREAD_NIBBLE[lo >> 4]);
+	out[1] = (uint8_t)~((SPREAD_NIBBLE[hi & 0x0F] << 1) | SPREAD_NIBBLE[lo & 0x0F]);
 }
+
+template <typename Panel>
+void DisplayDrawer<Panel>::drawGray2bpp(const uint8_t *planes)
+{
+	if (!Panel::GRAY4 || !_direct)
+	{
+		drawBitmap1bpp(planes, false, RefreshMode::Full);
+		return;
+	}
+
+	const uint8_t *lo = planes + Panel::FRAME_BYTES;
+	const uint32_t t0 = millis();
+
+	for (int16_t y = 0; y < (int16_t)Panel::HEIGHT; y += GRAY_STRIP_ROWS)
+	{
+		const int16_t left = (int16_t)(Panel::HEIGHT - y);
+		const int16_t rows = left < GRAY_STRIP_ROWS ? left : GRAY_STRIP_ROWS;
+		const size_t offset = (size_t)y * Panel::BYTES_PER_ROW;
+		const size_t bytes = (size_t)rows * Panel::BYTES_PER_ROW;
+		for (size_t i = 0; i < bytes; i++)
+			packGray(planes[offset + i], lo[offset + i], _grayStrip + 2 * i);
+		GrayUpload<Panel::GRAY4>::strip(_display.epd2, _grayStrip, y, Panel::WIDTH, rows);
+	}
+	// The 4G write selects the gray waveform; gray is always a normal full refresh
+	selectWaveform(RefreshMode::Full);
+	_display.epd2.refresh(false);
+	_initial = false;
+
+	Serial.printf("[EPD] 4-gray upload %ux%u (%lu ms)\n",
+				  (unsigned)Panel::WIDTH, (unsigned)Panel::HEIGHT, (unsigned long)(millis() - t0));
+}
+
+template class DisplayDrawer<ActivePanel>;
@@ -6,40 +6,69 @@
 #include <GxEPD2_BW.h>
 #include <Fonts/FreeMonoBold12pt7b.h>
 
-// Explicit display type — DO NOT infer from main.ino
-using DisplayType =
-	GxEPD2_BW<GxEPD2_420_GDEY042T81,
-			  GxEPD2_420_GDEY042T81::HEIGHT>;
+#include "PanelTraits.h"
+#include "RefreshPolicy.h"
 
+// Specialized on PanelTraits; explicitly instantiated for ActivePanel in DisplayDrawer.cpp.
+template <typename Panel>
 class DisplayDrawer
 {
 public:
+	using DisplayType = typename Panel::Display;
+
 	DisplayDrawer(
 		DisplayType &display,
-		int sck, int miso, int mosi, int cs,
-		int preferredRotation,
-		int targetW,
-		int targetH);
+		int sck, int miso, int mosi, int cs);
+
+	// initial=false when the panel still shows our last frame (deep-sleep wake): allows
+	// partial refresh; true forces the first refresh to be a full one.
+	void begin(uint32_t serialBaudForInit, bool initial = true);
 
-	void begin(uint32_t serialBaudForInit);
+	// Controller RAM and the glass hold our last frame (begin(initial=false) or drawn since).
+	bool panelKnown() const { return !_initial; }
 
-	void showStatus(const char *line1, const char *line2);
+	// mode (RefreshPolicy.h): Full, or Fast on panels with PanelTraits::FAST_FULL (otherwise
+	// Full). Partial needs panelKnown(); whole-screen draws treat it as Full.
+	void showStatus(const char *line1, const char *line2, RefreshMode mode = RefreshMode::Full);
 
 	void drawLines(const String *lines, size_t count);
 	void drawLines(const char *const *lines, size_t count);
 
-	void drawBitmap1bpp(const uint8_t *bitmap, bool invert);
+	void drawBitmap1bpp(const uint8_t *bitmap, bool invert, RefreshMode mode = RefreshMode::Full);
+
+	// Frames go straight to controller RAM (epd2.writeImagePart, bulk SPI) instead of GFX
+	// drawBitmap; transposed panels are converted with BitRotate first. Default on.
+	void setDirectUpload(bool enabled) { _direct = enabled; }
+
+	// Partial: refresh only the rows covered by changed bands (bit i = rows
+	// [i*bandRows, (i+1)*bandRows)). Full / Fast, or no panelKnown(): drawBitmap1bpp.
+	void drawBitmapBands(const uint8_t *bitmap, uint32_t changedBands, int bandRows, RefreshMode mode);
+
+	// Two-plane gray frame (FrameBuffer<Panel, 2> layout). 4-gray panels get the planes packed
+	// to 2 bpp a strip at a time and a full gray refresh; others show plane 0 (dark = black).
+	void drawGray2bpp(const uint8_t *planes);
 
 private:
-	void drawLinesInternal(const char *const *lines, size_t count, bool isStatus);
-	int pickRotationForTarget(int targetW, int targetH, int preferred);
+	void drawLinesInternal(const char *const *lines, size_t count, bool isStatus, RefreshMode mode);
+
+	// Waveform for the next full refresh (epd2.refresh(false) or a full GFX page loop)
+	void selectWaveform(RefreshMode mode);
+
+	// Upload logical rows [y0, y1) in native order and refresh them (Partial: just that window).
+	// false = not possible here; caller falls back to the GFX path.
+	bool uploadNative(const uint8_t *bitmap, bool invert, int16_t y0, int16_t y1, RefreshMode mode);
 
 private:
 	DisplayType &_display;
 
 	int _sck, _miso, _mosi, _cs;
-	int _rotation;
-	int _preferredRotation;
-	int _targetW;
-	int _targetH;
+	bool _initial = true;
+	bool _direct = true;
+
+	// Native-order scratch, only needed when the frame is rotated relative to controller RAM
+	uint8_t _native[Panel::ROTATION == 0 ? 1 : Panel::FRAME_BYTES];
+
+	// Packed 2-bpp strip for the 4-gray upload; the full 2-bpp frame is never built
+	static constexpr int16_t GRAY_STRIP_ROWS = 16;
+	uint8_t _grayStrip[Panel::GRAY4 ? GRAY_STRIP_ROWS * Panel::WIDTH / 4 : 1];
 };
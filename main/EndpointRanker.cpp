@@ -0,0 +1,102 @@
+#include "EndpointRanker.h"
+#include "Hash.h"
+#include "TimeUtil.h"
+
+RTC_DATA_ATTR static EndpointRanker::Stats rtcEndpointStats[EndpointRanker::MAX_ENDPOINTS];
+
+EndpointRanker::EndpointRanker(const char *const *urls, size_t count)
+	: _urls(urls), _count(count > MAX_ENDPOINTS ? MAX_ENDPOINTS : count)
+{
+	// Slot i belongs to URL i; a changed list (new firmware) resets that slot.
+	for (size_t i = 0; i < _count; i++)
+	{
+		uint32_t h = fnv1aKey(_urls[i]);
+		if (rtcEndpointStats[i].urlHash != h)
+		{
+			memset(&rtcEndpointStats[i], 0, sizeof(Stats));
+			rtcEndpointStats[i].urlHash = h;
+		}
+	}
+}
+
+EndpointRanker::Stats &EndpointRanker::stats(size_t i) const
+{
+	return rtcEndpointStats[i];
+}
+
+// 0 = answered last time, 1 = untried / due for recheck, 2 = failing
+static uint8_t tierOf(const EndpointRanker::Stats &s, uint32_t now)
+{
+	if (s.failStreak == 0)
+		return s.lastOkSec ? 0 : 1;
+	if ((int32_t)(now - s.lastFailSec) >= (int32_t)EndpointRanker::RECHECK_SEC)
+		return 1;
+	return 2;
+}
+
+size_t EndpointRanker::rank(uint8_t *order) const
+{
+	const uint32_t now = rtcNowSec();
+
+	for (size_t i = 0; i < _count; i++)
+		order[i] = (uint8_t)i;
+
+	// Insertion sort: n <= 4, and it keeps configured order for ties
+	for (size_t i = 1; i < _count; i++)
+	{
+		uint8_t cur = order[i];
+		const Stats &c = stats(cur);
+		size_t j = i;
+		while (j > 0)
+		{
+			const Stats &p = stats(order[j - 1]);
+			uint8_t tc = tierOf(c, now);
+			uint8_t tp = tierOf(p, now);
+
+			bool better = tc < tp ||
+						  (tc == tp && tc == 0 && c.ttfbMs < p.ttfbMs) ||
+						  (tc == tp && tc == 2 && c.failStreak < p.failStreak);
+			if (!better)
+				break;
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = cur;
+	}
+
+	return _count;
+}
+
+bool EndpointRanker::isUncertain(size_t i) const
+{
+	return tierOf(stats(i), rtcNowSec()) != 0;
+}
+
+void EndpointRanker::recordSuccess(size_t i, uint32_t ttfbMs)
+{
+	Stats &s = stats(i);
+	if (ttfbMs == 0)
+		ttfbMs = 1;
+	// EWMA 1/4: one slow wake doesn't reorder the list
+	s.ttfbMs = s.ttfbMs ? (s.ttfbMs * 3 + ttfbMs) / 4 : ttfbMs;
+	s.lastOkSec = rtcNowSec();
+	s.failStreak = 0;
+}
+
+void EndpointRanker::recordFailure(size_t i)
+{
+	Stats &s = stats(i);
+	if (s.failStreak < 255)
+		s.failStreak++;
+	s.lastFailSec = rtcNowSec();
+}
+
+void EndpointRanker::log() const
+{
+	for (size_t i = 0; i < _count; i++)
+	{
+		const Stats &s = stats(i);
+		Serial.printf("[EP] #%u ttfb=%u ms fails=%u %s\n",
+					  (unsigned)i, (unsigned)s.ttfbMs, (unsigned)s.failStreak, _urls[i]);
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Orders a fixed list of endpoint URLs by what worked last time.
+// Per-endpoint stats live in RTC memory (keyed by URL hash) and survive deep sleep:
+//   - endpoints that answered recently come first, fastest time-to-first-byte first
+//   - never-tried endpoints keep their configured order after those
+//   - failing endpoints go last until RECHECK_SEC has passed, then count as untried again
+class EndpointRanker
+{
+public:
+	static constexpr size_t MAX_ENDPOINTS = 4;
+	static constexpr uint32_t RECHECK_SEC = 3600;
+
+	struct Stats
+	{
+		uint32_t urlHash;	// 0 = slot unused
+		uint32_t ttfbMs;	// EWMA, 0 = unknown
+		uint32_t lastOkSec; // RTC-backed system clock
+		uint32_t lastFailSec;
+		uint8_t failStreak;
+	};
+
+	EndpointRanker(const char *const *urls, size_t count);
+
+	size_t count() const { return _count; }
+	const char *url(size_t i) const { return _urls[i]; }
+
+	// Fills order[0..count) with endpoint indices, best first. Returns count.
+	size_t rank(uint8_t *order) const;
+
+	// True if we have no recent success for this endpoint (worth racing).
+	bool isUncertain(size_t i) const;
+
+	void recordSuccess(size_t i, uint32_t ttfbMs);
+	void recordFailure(size_t i);
+
+	void log() const;
+
+private:
+	Stats &stats(size_t i) const;
+
+private:
+	const char *const *_urls;
+	size_t _count;
+};
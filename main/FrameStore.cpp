@@ -0,0 +1,100 @@
+#include "FrameStore.h"
+#include <Preferences.h>
+
+static constexpr uint32_t PARTIAL_VERSION = 1;
+
+static const char *KEY_META = "pmeta";
+static const char *KEY_DATA = "pdata";
+static const char *KEY_FRAME = "frame";
+
+FrameStore::FrameStore(const char *nvsNamespace, const char *partition)
+	: _ns(nvsNamespace), _partition(partition) {}
+
+bool FrameStore::loadPartial(PartialFrame &meta, uint8_t *buf, size_t cap)
+{
+	memset(&meta, 0, sizeof(meta));
+
+	Preferences prefs;
+	if (!prefs.begin(_ns, true, _partition))
+		return false;
+
+	bool ok = false;
+	if (prefs.getBytesLength(KEY_META) == sizeof(meta) &&
+		prefs.getBytes(KEY_META, &meta, sizeof(meta)) == sizeof(meta))
+	{
+		meta.etag[sizeof(meta.etag) - 1] = '\0';
+
+		ok = meta.version == PARTIAL_VERSION &&
+			 meta.etag[0] != '\0' &&
+			 meta.dataBytes > 0 &&
+			 meta.dataBytes < meta.bytesNeeded &&
+			 meta.bytesNeeded <= cap &&
+			 prefs.getBytes(KEY_DATA, buf, meta.dataBytes) == meta.dataBytes;
+	}
+
+	prefs.end();
+
+	if (ok)
+		Serial.printf("[STORE] partial frame: %u/%u bytes etag=%s\n",
+					  (unsigned)meta.dataBytes, (unsigned)meta.bytesNeeded, meta.etag);
+	return ok;
+}
+
+bool FrameStore::savePartial(const PartialFrame &meta, const uint8_t *buf)
+{
+	Preferences prefs;
+	if (!prefs.begin(_ns, false, _partition))
+		return false;
+
+	PartialFrame m = meta;
+	m.version = PARTIAL_VERSION;
+
+	// Meta goes away first and is written last: an interrupted save leaves no partial at all.
+	prefs.remove(KEY_META);
+	bool ok = prefs.putBytes(KEY_DATA, buf, m.dataBytes) == m.dataBytes &&
+			  prefs.putBytes(KEY_META, &m, sizeof(m)) == sizeof(m);
+	prefs.end();
+
+	Serial.printf("[STORE] save partial %u/%u bytes: %s\n",
+				  (unsigned)m.dataBytes, (unsigned)m.bytesNeeded, ok ? "OK" : "FAILED");
+	return ok;
+}
+
+void FrameStore::clearPartial()
+{
+	Preferences prefs;
+	if (!prefs.begin(_ns, false, _partition))
+		return;
+
+	if (prefs.isKey(KEY_META))
+	{
+		prefs.remove(KEY_META);
+		prefs.remove(KEY_DATA);
+	}
+	prefs.end();
+}
+
+bool FrameStore::loadFrame(uint8_t *buf, size_t len)
+{
+	Preferences prefs;
+	if (!prefs.begin(_ns, true, _partition))
+		return false;
+
+	bool ok = prefs.getBytesLength(KEY_FRAME) == len &&
+			  prefs.getBytes(KEY_FRAME, buf, len) == len;
+	prefs.end();
+	return ok;
+}
+
+bool FrameStore::saveFrame(const uint8_t *buf, size_t len)
+{
+	Preferences prefs;
+	if (!prefs.begin(_ns, false, _partition))
+		return false;
+
+	bool ok = prefs.putBytes(KEY_FRAME, buf, len) == len;
+	prefs.end();
+
+	Serial.printf("[STORE] save frame %u bytes: %s\n", (unsigned)len, ok ? "OK" : "FAILED");
+	return ok;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Interrupted PBM download, persisted so the next wake can resume with a Range request.
+// Offsets are in bytes of the HTTP entity (header + bitmap), which is what Range addresses.
+struct PartialFrame
+{
+	uint32_t version;
+	char etag[64];		  // validator sent back as If-Range
+	uint16_t w;
+	uint16_t h;
+	uint32_t headerLen;	  // entity bytes before the first bitmap byte
+	uint32_t dataBytes;	  // bitmap bytes already received
+	uint32_t bytesNeeded; // full bitmap size
+
+	uint32_t resumeOffset() const { return headerLen + dataBytes; }
+};
+
+// Flash-backed (NVS) store; a 15 KB frame does not fit in 8 KB of RTC memory. Kept in its
+// own NVS partition (main/partitions.csv): the stock 20 KB nvs can't hold a frame and a
+// partial next to the WiFi data. Without that partition every load / save fails.
+class FrameStore
+{
+public:
+	explicit FrameStore(const char *nvsNamespace = "frame", const char *partition = "frames");
+
+	// Loads metadata and the received bitmap prefix into buf. False if nothing usable.
+	bool loadPartial(PartialFrame &meta, uint8_t *buf, size_t cap);
+
+	bool savePartial(const PartialFrame &meta, const uint8_t *buf);
+
+	void clearPartial();
+
+	// Last complete frame (what the panel should be showing). Basis for the tile manifest.
+	bool loadFrame(uint8_t *buf, size_t len);
+	bool saveFrame(const uint8_t *buf, size_t len);
+
+private:
+	const char *_ns;
+	const char *_partition;
+};
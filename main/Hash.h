@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 32-bit FNV-1a: tile manifests (the server computes the same), URL and SSID keys.
+static constexpr uint32_t FNV1A_SEED = 2166136261u;
+
+static inline uint32_t fnv1a(const uint8_t *data, size_t len, uint32_t h = FNV1A_SEED)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		h ^= data[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+
+// For keys stored in RTC slots where 0 marks an empty slot.
+static inline uint32_t fnv1aKey(const char *s)
+{
+	uint32_t h = FNV1A_SEED;
+	while (*s)
+	{
+		h ^= (uint8_t)*s++;
+		h *= 16777619u;
+	}
+	return h ? h : 1;
+}
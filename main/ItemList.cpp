@@ -0,0 +1,123 @@
+#include "ItemList.h"
+#include "GlyphAtlas.h"
+
+static constexpr int CELL_TOP = (ITEM_PITCH - GLYPH_H) / 2;
+static constexpr int STRIKE_ROW = GLYPH_BASELINE - 6; // about x-height / 2
+static constexpr int STRIKE_ROWS = 2;
+
+static_assert(GLYPH_H <= ITEM_PITCH, "glyph cell taller than an item row");
+
+struct FrameView
+{
+	uint8_t *data;
+	int w;
+	int h;
+	int bytesPerRow;
+	uint8_t edgeMask; // valid pixels of the last byte in a row
+};
+
+// Sets (ink) or clears pixels [x0, x1) of row y a byte at a time.
+static void fillSpan(const FrameView &f, int y, int x0, int x1, bool ink)
+{
+	if (x1 > f.w)
+		x1 = f.w;
+	uint8_t *row = f.data + (size_t)y * f.bytesPerRow;
+	for (int x = x0; x < x1;)
+	{
+		const int b = x >> 3;
+		const int n = (x1 - x < 8 - (x & 7)) ? x1 - x : 8 - (x & 7);
+		const uint8_t m = (uint8_t)((0xFF >> (x & 7)) & (0xFF << (8 - (x & 7) - n)));
+		row[b] = ink ? (row[b] | m) : (row[b] & ~m);
+		x += n;
+	}
+}
+
+// One 16-bit atlas row lands in at most three frame bytes: shift, then OR (or clear on an
+// inverted row) whole bytes instead of plotting pixels.
+static void blitGlyph(const FrameView &f, int x, int y, char c, bool inverted)
+{
+	if (c < GLYPH_FIRST || c > GLYPH_LAST)
+		c = '?';
+
+	const uint16_t *rows = GLYPH_ATLAS + (c - GLYPH_FIRST) * GLYPH_H;
+	const int b0 = x >> 3;
+	const int shift = x & 7;
+
+	for (int r = 0; r < GLYPH_H && y + r < f.h; r++)
+	{
+		const uint16_t bits = pgm_read_word(&rows[r]);
+		if (!bits)
+			continue;
+
+		const uint32_t span = (uint32_t)bits << (8 - shift); // 24 bits, leftmost pixel at bit 23 - shift
+		uint8_t *dst = f.data + (size_t)(y + r) * f.bytesPerRow + b0;
+		for (int k = 0; k < 3 && b0 + k < f.bytesPerRow; k++)
+		{
+			uint8_t v = (uint8_t)(span >> (16 - 8 * k));
+			if (b0 + k == f.bytesPerRow - 1)
+				v &= f.edgeMask;
+			dst[k] = inverted ? (uint8_t)(dst[k] & ~v) : (uint8_t)(dst[k] | v);
+		}
+	}
+}
+
+bool renderItemList(const uint8_t *payload, size_t len, uint8_t *frame, int w, int h, const char **outError)
+{
+	const char *err = nullptr;
+	if (len < 5 || memcmp(payload, "ILS1", 4) != 0)
+		err = "Bad item-list magic";
+
+	// Validate everything before the frame is touched
+	const uint8_t count = len >= 5 ? payload[4] : 0;
+	size_t pos = 5;
+	for (uint8_t i = 0; i < count && !err; i++)
+	{
+		if (pos + 2 > len || pos + 2 + payload[pos + 1] > len)
+			err = "Truncated item list";
+		else
+			pos += 2 + payload[pos + 1];
+	}
+	if (!err && pos != len)
+		err = "Trailing bytes after item list";
+
+	if (err)
+	{
+		if (outError)
+			*outError = err;
+		return false;
+	}
+
+	const FrameView f = {frame, w, h, (w + 7) / 8, (uint8_t)(0xFF << ((8 - (w & 7)) & 7))};
+	memset(frame, 0, (size_t)f.bytesPerRow * h);
+
+	const int maxChars = (w - ITEM_TEXT_X) / GLYPH_W;
+	pos = 5;
+	for (uint8_t i = 0; i < count; i++)
+	{
+		const uint8_t flags = payload[pos];
+		const uint8_t n = payload[pos + 1];
+		const char *text = (const char *)payload + pos + 2;
+		pos += 2 + n;
+
+		const int top = i * ITEM_PITCH;
+		if (top + ITEM_PITCH > h)
+			break;
+
+		const bool heading = flags & ITEM_HEADING;
+		if (heading)
+			for (int y = top; y < top + ITEM_PITCH; y++)
+				fillSpan(f, y, 0, w, true);
+
+		const int chars = n < maxChars ? n : maxChars;
+		for (int k = 0; k < chars; k++)
+			if (text[k] != ' ')
+				blitGlyph(f, ITEM_TEXT_X + k * GLYPH_W, top + CELL_TOP, text[k], heading);
+
+		if ((flags & ITEM_DONE) && chars)
+			for (int y = 0; y < STRIKE_ROWS; y++)
+				fillSpan(f, top + CELL_TOP + STRIKE_ROW + y, ITEM_TEXT_X, ITEM_TEXT_X + chars * GLYPH_W, !heading);
+	}
+
+	Serial.printf("[ITEMS] %u item(s) rendered (%u payload bytes)\n", (unsigned)count, (unsigned)len);
+	return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Compact item-list content, rendered on the device instead of fetched as a bitmap.
+//
+// A client that sends "Accept: application/x-item-list" may get the list itself
+// (a few hundred bytes, Content-Type application/x-item-list) instead of the P4 frame:
+//
+//   "ILS1" u8 count
+//   count x { u8 flags, u8 len, len bytes of text (printable ASCII; others draw as '?') }
+//
+// The layout is fixed so the server's P4 and the device's rendering are the same pixels:
+// item i fills rows [i * ITEM_PITCH, (i + 1) * ITEM_PITCH) (two tile bands, so one edited
+// item refreshes two bands), text starts ITEM_TEXT_X px in and is cut at the frame edge;
+// items past the bottom are dropped. Glyphs come from the flash atlas in GlyphAtlas.h
+// (tools/make_glyph_atlas.py); tools/list_server.py renders from the same atlas.
+
+static constexpr const char *ITEM_LIST_CONTENT_TYPE = "application/x-item-list";
+static constexpr size_t ITEM_LIST_MAX_BYTES = 1024;
+static constexpr int ITEM_PITCH = 32;
+static constexpr int ITEM_TEXT_X = 8;
+
+enum ItemFlags : uint8_t
+{
+	ITEM_HEADING = 1 << 0, // white text on a black row
+	ITEM_DONE = 1 << 1,	   // struck through
+};
+
+// Clears frame (P4 layout, 1 = black, w x h) and draws the list into it.
+// Returns false (error set, frame untouched) if the payload is malformed.
+bool renderItemList(const uint8_t *payload, size_t len, uint8_t *frame, int w, int h, const char **outError);
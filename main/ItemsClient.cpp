@@ -1,7 +1,11 @@
 #include "ItemsClient.h"
+#include "ItemList.h"
 
-ItemsClient::ItemsClient(AppNetworkManager &net, const char *itemsUrl)
-	: _net(net), _itemsUrl(itemsUrl) {}
+ItemsClient::ItemsClient(AppNetworkManager &net, const char *itemsUrl, FrameStore *store)
+	: _net(net), _itemsUrl(itemsUrl), _endpoints(&_itemsUrl, 1), _store(store) {}
+
+ItemsClient::ItemsClient(AppNetworkManager &net, const char *const *itemsUrls, size_t urlCount, FrameStore *store)
+	: _net(net), _itemsUrl(nullptr), _endpoints(itemsUrls, urlCount), _store(store) {}
 
 struct PbmCtx
 {
@@ -9,6 +13,8 @@ struct PbmCtx
 	int expectedH;
 	uint8_t *dst;
 	size_t cap;
+	uint8_t planes; // bit planes in dst; 2 = P5 gray accepted
+
 
 	// header parsing
 	bool inComment = false;
@@ -20,20 +26,51 @@ struct PbmCtx
 	// token parsing (magic, w, h)
 	char token[32];
 	size_t tokenLen = 0;
-	int tokenIndex = 0; // 0=magic,1=w,2=h
+	int tokenIndex = 0; // 0=magic,1=w,2=h,3=maxval (P5 only)
 
 	// data
 	bool inData = false;
 	size_t bytesNeeded = 0;
 	size_t got = 0;
 
+	// P5 gray: bytesNeeded/got count pixels; 8 pixels are packed per plane byte
+	bool gray = false;
+	int maxval = 0;
+	size_t planeBytes = 0;
+	uint8_t hiAcc = 0;
+	uint8_t loAcc = 0;
+
 	// debug/fail
 	bool failed = false;
 	const char *failReason = nullptr;
+
+	// resume (Range)
+	const HttpResponseInfo *resp = nullptr; // filled by the network layer before the first byte
+	bool resumed = false;					// header + bitmap prefix preloaded from FrameStore
+	uint32_t resumeOffset = 0;
+	bool started = false;
+	size_t headerLen = 0; // entity bytes before the first bitmap byte
+	size_t rawSeen = 0;	  // entity bytes seen in this response
+
+	// tile delta (only when a manifest was sent)
+	TileDeltaParser *delta = nullptr;
+	bool sniffed = false;
+	bool isDelta = false;
+
+	// item list (only when the client asked for one): buffered whole, rendered at the end
+	uint8_t *items = nullptr;
+	size_t itemsLen = 0;
+	bool isItems = false;
+
+	// integrity: body digest, started on the first byte when the server sent one
+	StreamDigest *digest = nullptr;
+	bool digestActive = false;
 };
 
 static bool isWs(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
 
+static int headerTokens(const PbmCtx &ctx) { return ctx.gray ? 4 : 3; }
+
 static void failOnce(PbmCtx &ctx, const char *reason)
 {
 	if (ctx.failed)
@@ -57,7 +94,8 @@ static void applyToken(PbmCtx &ctx, const char *tok)
 {
 	if (ctx.tokenIndex == 0)
 	{
-		ctx.okMagic = (strcmp(tok, "P4") == 0);
+		ctx.gray = ctx.planes == 2 && strcmp(tok, "P5") == 0;
+		ctx.okMagic = ctx.gray || strcmp(tok, "P4") == 0;
 	}
 	else if (ctx.tokenIndex == 1)
 	{
@@ -69,7 +107,7 @@ static void applyToken(PbmCtx &ctx, const char *tok)
 
 		if (!ctx.okMagic)
 		{
-			failOnce(ctx, "Bad magic (not P4)");
+			failOnce(ctx, ctx.planes == 2 ? "Bad magic (not P4/P5)" : "Bad magic (not P4)");
 			return;
 		}
 
@@ -80,19 +118,32 @@ static void applyToken(PbmCtx &ctx, const char *tok)
 		}
 
 		const size_t bytesPerRow = ((size_t)ctx.w + 7) / 8;
-		ctx.bytesNeeded = bytesPerRow * (size_t)ctx.h;
+		ctx.planeBytes = bytesPerRow * (size_t)ctx.h;
+		ctx.bytesNeeded = ctx.gray ? (size_t)ctx.w * (size_t)ctx.h : ctx.planeBytes;
 
-		if (ctx.cap < ctx.bytesNeeded)
+		if (ctx.cap < ctx.planeBytes * (ctx.gray ? 2 : 1))
 		{
 			failOnce(ctx, "Output buffer too small");
 			return;
 		}
 
-		ctx.okHeader = true;
+		if (ctx.gray && ctx.w % 8)
+		{
+			failOnce(ctx, "Gray width not byte aligned");
+			return;
+		}
+
+		ctx.okHeader = !ctx.gray;
 	}
-	else
+	else if (ctx.tokenIndex == 3)
 	{
-		// Ignore any extra tokens (shouldn't exist in valid P4 header)
+		ctx.maxval = atoi(tok);
+		if (ctx.maxval < 1 || ctx.maxval > 255)
+		{
+			failOnce(ctx, "Unsupported PGM maxval (8-bit only)");
+			return;
+		}
+		ctx.okHeader = true;
 	}
 }
 
@@ -105,14 +156,45 @@ static void finishToken(PbmCtx &ctx)
 	applyToken(ctx, ctx.token);
 
 	ctx.tokenLen = 0;
-	if (ctx.tokenIndex < 3)
-		ctx.tokenIndex++; // only advance through magic,w,h
+	if (ctx.tokenIndex < 4)
+		ctx.tokenIndex++; // only advance through magic,w,h(,maxval)
+}
+
+// Server ignored or rejected Range (200 instead of 206): parse the body from scratch.
+static void restartParser(PbmCtx &ctx)
+{
+	PbmCtx fresh{};
+	fresh.expectedW = ctx.expectedW;
+	fresh.expectedH = ctx.expectedH;
+	fresh.dst = ctx.dst;
+	fresh.cap = ctx.cap;
+	fresh.planes = ctx.planes;
+	fresh.resp = ctx.resp;
+	fresh.started = true;
+	fresh.digest = ctx.digest;
+	fresh.digestActive = ctx.digestActive;
+	ctx = fresh;
 }
 
 static bool onPbmBytes(const uint8_t *data, size_t len, void *user)
 {
 	PbmCtx &ctx = *(PbmCtx *)user;
 
+	if (!ctx.started)
+	{
+		ctx.started = true;
+
+		const bool rangeHonoured = ctx.resp &&
+								   ctx.resp->httpCode == 206 &&
+								   ctx.resp->rangeStart == (int)ctx.resumeOffset;
+		if (ctx.resumed && !rangeHonoured)
+		{
+			Serial.printf("[PBM] Resume not honoured (HTTP %d); parsing full body\n",
+						  ctx.resp ? ctx.resp->httpCode : 0);
+			restartParser(ctx);
+		}
+	}
+
 	for (size_t i = 0; i < len; i++)
 	{
 		uint8_t b = data[i];
@@ -145,7 +227,7 @@ static bool onPbmBytes(const uint8_t *data, size_t len, void *user)
 			// Whitespace separates tokens
 			if (isWs(c))
 			{
-				if (ctx.tokenIndex < 3)
+				if (ctx.tokenIndex < headerTokens(ctx))
 					finishToken(ctx);
 
 				// After header tokens are complete, PBM allows whitespace before binary data.
@@ -153,8 +235,8 @@ static bool onPbmBytes(const uint8_t *data, size_t len, void *user)
 				continue;
 			}
 
-			// If we still need magic/w/h tokens, accumulate token characters
-			if (ctx.tokenIndex < 3)
+			// If we still need magic/w/h(/maxval) tokens, accumulate token characters
+			if (ctx.tokenIndex < headerTokens(ctx))
 			{
 				if (ctx.tokenLen + 1 >= sizeof(ctx.token))
 				{
@@ -174,11 +256,25 @@ static bool onPbmBytes(const uint8_t *data, size_t len, void *user)
 			}
 
 			ctx.inData = true;
+			ctx.headerLen = ctx.rawSeen + i;
 			// fallthrough to data write for this byte
 		}
 
 		// ---------------- data ----------------
-		if (ctx.got < ctx.bytesNeeded)
+		if (ctx.gray && ctx.got < ctx.bytesNeeded)
+		{
+			// PGM 0 = black -> ink 3; split the 2-bit level across the planes
+			const uint8_t ink = (uint8_t)(3 - (b * 4) / (ctx.maxval + 1));
+			ctx.hiAcc = (uint8_t)((ctx.hiAcc << 1) | (ink >> 1));
+			ctx.loAcc = (uint8_t)((ctx.loAcc << 1) | (ink & 1));
+			if ((ctx.got & 7) == 7)
+			{
+				ctx.dst[ctx.got >> 3] = ctx.hiAcc;
+				ctx.dst[ctx.planeBytes + (ctx.got >> 3)] = ctx.loAcc;
+			}
+			ctx.got++;
+		}
+		else if (ctx.got < ctx.bytesNeeded)
 		{
 			ctx.dst[ctx.got++] = b;
 		}
@@ -188,34 +284,387 @@ static bool onPbmBytes(const uint8_t *data, size_t len, void *user)
 		}
 	}
 
+	ctx.rawSeen += len;
+	return true;
+}
+
+// Manifest requests may be answered with a tile-delta container instead of a P4; the first
+// body byte tells them apart ('T' vs 'P').
+static bool onFrameBytes(const uint8_t *data, size_t len, void *user)
+{
+	PbmCtx &ctx = *(PbmCtx *)user;
+
+	if (!ctx.sniffed && ctx.digest && ctx.resp)
+	{
+		// Whole-representation digests can't be checked against a 206 slice
+		const ExpectedDigest &exp = ctx.resp->digest;
+		if (exp.algo != DigestAlgo::None && !(exp.wholeRepresentation && ctx.resp->httpCode == 206))
+		{
+			ctx.digest->begin(exp.algo);
+			ctx.digestActive = true;
+		}
+	}
+	if (ctx.digestActive)
+		ctx.digest->update(data, len);
+
+	if (ctx.delta && !ctx.sniffed)
+	{
+		ctx.isDelta = data[0] == TileDeltaParser::MAGIC0;
+		if (ctx.isDelta)
+			Serial.println("[PBM] Tile-delta response");
+	}
+	// Item lists go by Content-Type, not the first byte: a resumed 206 body starts somewhere in
+	// a bitmap. renderItemList checks the full "ILS1" magic.
+	if (ctx.items && !ctx.sniffed)
+	{
+		ctx.isItems = ctx.resp && ctx.resp->httpCode == 200 &&
+					  strncmp(ctx.resp->contentType, ITEM_LIST_CONTENT_TYPE, strlen(ITEM_LIST_CONTENT_TYPE)) == 0;
+		if (ctx.isItems)
+			Serial.println("[PBM] Item-list response");
+	}
+
+	ctx.sniffed = true;
+
+	if (ctx.isDelta)
+		return ctx.delta->feed(data, len);
+
+	if (ctx.isItems)
+	{
+		if (ctx.itemsLen + len > ITEM_LIST_MAX_BYTES)
+		{
+			failOnce(ctx, "Item list too large");
+			return false;
+		}
+		memcpy(ctx.items + ctx.itemsLen, data, len);
+		ctx.itemsLen += len;
+		return true;
+	}
+
+	return onPbmBytes(data, len, user);
+}
+
+// Direct-read mode: once the P4 header is parsed, bitmap bytes are received straight into
+// the frame buffer; the header, resume check and tile-delta container go through the
+// callbacks above.
+static uint8_t *reserveFrameBytes(size_t want, size_t *outCap, void *user)
+{
+	PbmCtx &ctx = *(PbmCtx *)user;
+	(void)want;
+
+	if (!ctx.started || ctx.isDelta || ctx.gray || ctx.failed || !ctx.inData || ctx.got >= ctx.bytesNeeded)
+		return nullptr;
+
+	*outCap = ctx.bytesNeeded - ctx.got;
+	return ctx.dst + ctx.got;
+}
+
+static bool commitFrameBytes(size_t len, void *user)
+{
+	PbmCtx &ctx = *(PbmCtx *)user;
+	if (ctx.digestActive)
+		ctx.digest->update(ctx.dst + ctx.got, len);
+	ctx.got += len;
+	ctx.rawSeen += len;
+	return true;
+}
+
+static const HttpBodySink FRAME_SINK = {reserveFrameBytes, commitFrameBytes};
+
+static const char GRAY_ACCEPT_HEADER[] = "Accept: image/x-portable-graymap, image/x-portable-bitmap;q=0.5\r\n";
+static const char ITEMS_ACCEPT_HEADER[] = "Accept: application/x-item-list, image/x-portable-bitmap;q=0.5\r\n";
+static const char ITEMS_GRAY_ACCEPT_HEADER[] =
+	"Accept: application/x-item-list, image/x-portable-graymap, image/x-portable-bitmap;q=0.5\r\n";
+
+static uint8_t itemPayload[ITEM_LIST_MAX_BYTES];
+
+// Preload parser state from a persisted partial: header already consumed, bitmap prefix in dst.
+static void resumeFrom(PbmCtx &ctx, const PartialFrame &p)
+{
+	ctx.resumed = true;
+	ctx.resumeOffset = p.resumeOffset();
+	ctx.okMagic = true;
+	ctx.okHeader = true;
+	ctx.tokenIndex = 3;
+	ctx.w = p.w;
+	ctx.h = p.h;
+	ctx.inData = true;
+	ctx.bytesNeeded = p.bytesNeeded;
+	ctx.planeBytes = p.bytesNeeded; // partials are P4 only
+	ctx.got = p.dataBytes;
+	ctx.headerLen = p.headerLen;
+}
+
+void ItemsClient::savePartial(const PbmCtx &ctx, const HttpResponseInfo &resp, const PartialFrame *prev)
+{
+	// Gray pixels are quantized in place: the received prefix can't be replayed into the parser
+	if (ctx.gray || !ctx.inData || !ctx.okHeader || ctx.got == 0 || ctx.got >= ctx.bytesNeeded)
+		return;
+
+	// A 206 may omit ETag; the validator we resumed with still applies.
+	const bool continued = ctx.resumed && resp.httpCode == 206;
+	if (ctx.resumed && !continued)
+		return; // prefix still belongs to the old validator (no body arrived to replace it)
+
+	const char *etag = resp.etag[0] ? resp.etag : (continued && prev ? prev->etag : "");
+
+	// If-Range needs a strong validator; without one a resumed body could splice two frames.
+	if (!etag[0] || strncmp(etag, "W/", 2) == 0 || strlen(etag) >= sizeof(PartialFrame::etag))
+	{
+		Serial.println("[PBM] No strong ETag; partial frame not kept");
+		return;
+	}
+
+	if (prev && continued && ctx.got <= prev->dataBytes)
+		return; // no progress this wake; avoid rewriting flash
+
+	PartialFrame p;
+	memset(&p, 0, sizeof(p));
+	strncpy(p.etag, etag, sizeof(p.etag) - 1);
+	p.w = (uint16_t)ctx.w;
+	p.h = (uint16_t)ctx.h;
+	p.headerLen = (uint32_t)ctx.headerLen;
+	p.dataBytes = (uint32_t)ctx.got;
+	p.bytesNeeded = (uint32_t)ctx.bytesNeeded;
+
+	_store->savePartial(p, ctx.dst);
+}
+
+bool ItemsClient::verifyDigest(PbmCtx &ctx, const HttpResponseInfo &resp)
+{
+	if (!ctx.digestActive)
+	{
+		if (resp.digest.algo != DigestAlgo::None)
+			Serial.printf("[PBM] %s digest covers the whole entity; not checkable on a 206\n",
+						  digestName(resp.digest.algo));
+		else if (_requireDigest)
+			Serial.println("[PBM] No digest header; frame rejected");
+		else
+			return true;
+		return !_requireDigest;
+	}
+
+	const DigestAlgo algo = ctx.digest->algo();
+	if (!ctx.digest->matches(resp.digest))
+	{
+		Serial.printf("[PBM] %s mismatch; frame discarded\n", digestName(algo));
+		return false;
+	}
+
+	Serial.printf("[PBM] %s verified\n", digestName(algo));
 	return true;
 }
 
 bool ItemsClient::fetchPbmP4(uint8_t *outBuf, size_t outLen, int expectedW, int expectedH, uint32_t timeoutMs)
 {
-	PbmCtx ctx;
-	memset(&ctx, 0, sizeof(ctx));
+	return fetchFrame(outBuf, outLen, expectedW, expectedH, false, nullptr, timeoutMs);
+}
+
+bool ItemsClient::fetchFrame(uint8_t *frame, size_t len, int w, int h, bool haveFrame,
+							 uint32_t *outChangedBands, uint32_t timeoutMs)
+{
+	return fetchPlanes(frame, len, w, h, 1, haveFrame, outChangedBands, timeoutMs);
+}
+
+// Gray frames and item lists come whole; comparing per-band hashes (of every plane)
+// against the retained frame still tells the caller which bands (if any) need a refresh.
+static void bandHashes(const uint8_t *frame, const TileGeometry &geo, uint8_t planes, uint32_t *out)
+{
+	const size_t planeBytes = (size_t)geo.bytesPerRow() * geo.h;
+	for (int b = 0; b < geo.bandCount(); b++)
+	{
+		out[b] = tileHash(frame + geo.bandOffset(b), geo.bandBytes(b));
+		if (planes == 2)
+		{
+			const uint32_t lo = tileHash(frame + planeBytes + geo.bandOffset(b), geo.bandBytes(b));
+			out[b] ^= (lo << 1) | (lo >> 31);
+		}
+	}
+}
+
+bool ItemsClient::fetchPlanes(uint8_t *frame, size_t len, int w, int h, uint8_t planes, bool haveFrame,
+							  uint32_t *outChangedBands, uint32_t timeoutMs)
+{
+	if (outChangedBands)
+		*outChangedBands = 0;
+
+	const TileGeometry geo = {w, h};
+	uint32_t before[TILE_MAX_BANDS];
+	if (haveFrame && (planes == 2 || _itemList))
+		bandHashes(frame, geo, planes, before);
+
+	// Computed once from the retained frame. Later attempts may have overwritten some bytes,
+	// but only with new content, and the server resends every band that differs from the
+	// manifest, so the patched result is still exact.
+	char manifestHeader[240];
+	const char *manifest = nullptr;
+	if (haveFrame && planes == 1) // the tile manifest covers a single 1-bpp plane
+	{
+		const int prefix = snprintf(manifestHeader, sizeof(manifestHeader), "X-Tile-Manifest: ");
+		const size_t m = buildTileManifest(frame, geo, manifestHeader + prefix, sizeof(manifestHeader) - prefix - 2);
+		if (m)
+		{
+			memcpy(manifestHeader + prefix + m, "\r\n", 3);
+			manifest = manifestHeader;
+		}
+	}
+
+	uint8_t order[EndpointRanker::MAX_ENDPOINTS];
+	const size_t n = _endpoints.rank(order);
+	_endpoints.log();
+
+	// Top two disagree with history (untried, recovering, or just failed): let a quick
+	// connect race decide which one goes first instead of paying a full timeout.
+	if (_race && n >= 2 && (_endpoints.isUncertain(order[0]) || _endpoints.isUncertain(order[1])))
+	{
+		const char *top[2] = {_endpoints.url(order[0]), _endpoints.url(order[1])};
+		if (_net.raceConnect(top, 2, 1500) == 1)
+		{
+			uint8_t t = order[0];
+			order[0] = order[1];
+			order[1] = t;
+		}
+	}
+
+	for (size_t k = 0; k < n; k++)
+	{
+		const uint8_t i = order[k];
+		uint32_t ttfbMs = 0;
+
+		if (fetchFrom(_endpoints.url(i), frame, len, w, h, planes, timeoutMs, manifest, outChangedBands, &ttfbMs))
+		{
+			_endpoints.recordSuccess(i, ttfbMs);
+			if (haveFrame && (planes == 2 || _lastWasItems) && outChangedBands)
+			{
+				uint32_t after[TILE_MAX_BANDS];
+				bandHashes(frame, geo, planes, after);
+				*outChangedBands = 0;
+				for (int b = 0; b < geo.bandCount(); b++)
+					if (after[b] != before[b])
+						*outChangedBands |= 1u << b;
+			}
+			return true;
+		}
+
+		_endpoints.recordFailure(i);
+
+		// A damaged body may have been written into the retained frame; restore it so the
+		// manifest sent to the next endpoint still describes what the buffer holds.
+		if (_digestMismatch && haveFrame && _store && !_store->loadFrame(frame, len))
+			manifest = nullptr;
+
+		if (k + 1 < n)
+			Serial.printf("[PBM] Endpoint #%u failed; trying next\n", (unsigned)i);
+	}
+
+	return false;
+}
+
+bool ItemsClient::fetchFrom(const char *url, uint8_t *outBuf, size_t outLen, int expectedW, int expectedH, uint8_t planes,
+							uint32_t timeoutMs, const char *manifestHeader, uint32_t *outChangedBands, uint32_t *outTtfbMs)
+{
+	PbmCtx ctx{};
 	ctx.expectedW = expectedW;
 	ctx.expectedH = expectedH;
 	ctx.dst = outBuf;
 	ctx.cap = outLen;
+	ctx.planes = planes;
+	if (_itemList)
+		ctx.items = itemPayload;
+
+	HttpRequestOptions req;
+	HttpResponseInfo resp;
+	ctx.resp = &resp;
+	req.sink = &FRAME_SINK;
+
+	PartialFrame partial;
+	bool hadPartial = _store && _store->loadPartial(partial, outBuf, outLen);
+	if (hadPartial && partial.w == expectedW && partial.h == expectedH)
+	{
+		resumeFrom(ctx, partial);
+		req.rangeStart = ctx.resumeOffset;
+		req.ifRange = partial.etag;
+		Serial.printf("[PBM] Resuming at entity byte %u (%u/%u bitmap bytes)\n",
+					  (unsigned)ctx.resumeOffset, (unsigned)ctx.got, (unsigned)ctx.bytesNeeded);
+	}
 
-	int httpCode = 0;
-	String err;
-	String ct;
-	int contentLen = -1;
+	// A resumed download has overwritten the retained frame; no manifest for it.
+	const TileGeometry geo = {expectedW, expectedH};
+	TileDeltaParser delta;
+	const bool sendManifest = manifestHeader && !ctx.resumed;
+	if (sendManifest)
+	{
+		delta.begin(outBuf, geo);
+		ctx.delta = &delta;
+	}
 
-	Serial.printf("[PBM] GET %s\n", _itemsUrl);
+	// Gray frames are always fetched whole; an item list may answer either request
+	const char *accept = _itemList ? (planes == 2 ? ITEMS_GRAY_ACCEPT_HEADER : ITEMS_ACCEPT_HEADER)
+								   : (planes == 2 && !sendManifest ? GRAY_ACCEPT_HEADER : nullptr);
+	char extraHeaders[320];
+	snprintf(extraHeaders, sizeof(extraHeaders), "%s%s", sendManifest ? manifestHeader : "", accept ? accept : "");
+	if (extraHeaders[0])
+		req.extraHeaders = extraHeaders;
 
-	bool ok = _net.httpGetStream(
-		_itemsUrl,
-		onPbmBytes,
-		&ctx,
-		timeoutMs,
-		&httpCode,
-		&err,
-		&ct,
-		&contentLen);
+	StreamDigest digest;
+	ctx.digest = &digest;
+	_digestMismatch = false;
+	_lastWasItems = false;
+
+	Serial.printf("[PBM] GET %s\n", url);
+
+	bool ok = _net.httpGetStream(url, onFrameBytes, &ctx, timeoutMs, req, resp);
+	if (outTtfbMs)
+		*outTtfbMs = resp.ttfbMs;
+
+	const int httpCode = resp.httpCode;
+	const char *err = resp.error;
+	const char *ct = resp.contentType;
+	const int contentLen = resp.contentLength;
+
+	// Runs before anything is kept or drawn: a damaged body never costs a refresh.
+	if (ok && !verifyDigest(ctx, resp))
+	{
+		_digestMismatch = true;
+		if (hadPartial && _store)
+			_store->clearPartial(); // the resumed prefix may be what's damaged
+		return false;
+	}
+
+	if (ctx.isItems)
+	{
+		Serial.printf("[PBM] HTTP code: %d\n", httpCode);
+		const char *why = ctx.failReason ? ctx.failReason : err;
+		if (!ok || !renderItemList(ctx.items, ctx.itemsLen, outBuf, expectedW, expectedH, &why))
+		{
+			Serial.printf("[PBM] Item list failed: %s\n", why);
+			return false;
+		}
+		if (planes == 2)
+		{
+			const size_t planeBytes = (size_t)geo.bytesPerRow() * expectedH;
+			memset(outBuf + planeBytes, 0, planeBytes); // rendered text is black and white
+		}
+		if (hadPartial && _store)
+			_store->clearPartial(); // the frame buffer no longer holds the stored prefix
+		_lastWasItems = true;
+		if (outChangedBands)
+			*outChangedBands = geo.allBandsMask();
+		return true;
+	}
+
+	if (ctx.isDelta)
+	{
+		Serial.printf("[PBM] HTTP code: %d\n", httpCode);
+		if (!ok || !delta.complete())
+		{
+			Serial.printf("[PBM] Tile delta failed: %s\n",
+						  delta.failReason() ? delta.failReason() : err);
+			return false;
+		}
+		if (outChangedBands)
+			*outChangedBands = delta.changedMask();
+		return true;
+	}
 
 	// If stream ended while we were still parsing the header token (rare), flush it.
 	if (!ctx.inData && !ctx.failed)
@@ -224,12 +673,26 @@ bool ItemsClient::fetchPbmP4(uint8_t *outBuf, size_t outLen, int expectedW, int
 	}
 
 	Serial.printf("[PBM] HTTP code: %d\n", httpCode);
-	Serial.printf("[PBM] Content-Type: %s\n", ct.c_str());
+	Serial.printf("[PBM] Content-Type: %s\n", ct);
 	Serial.printf("[PBM] Content-Length: %d\n", contentLen);
 
+	const bool complete = ok && ctx.okHeader && ctx.got == ctx.bytesNeeded;
+	if (_store)
+	{
+		if (complete || httpCode == 416 || ctx.failed)
+		{
+			if (hadPartial)
+				_store->clearPartial(); // done, or the stored prefix is unusable
+		}
+		else
+		{
+			savePartial(ctx, resp, hadPartial ? &partial : nullptr);
+		}
+	}
+
 	if (!ok)
 	{
-		Serial.printf("[PBM] GET/stream failed: %s\n", err.c_str());
+		Serial.printf("[PBM] GET/stream failed: %s\n", err);
 		if (ctx.failed && ctx.failReason)
 			Serial.printf("[PBM] Parser reason: %s\n", ctx.failReason);
 		return false;
@@ -255,5 +718,12 @@ bool ItemsClient::fetchPbmP4(uint8_t *outBuf, size_t outLen, int expectedW, int
 		return false;
 	}
 
+	if (ctx.gray)
+		Serial.printf("[PBM] 2-bpp gray (maxval %d) -> 2 planes\n", ctx.maxval);
+	else if (planes == 2)
+		memset(outBuf + ctx.planeBytes, 0, ctx.planeBytes); // 1-bpp frame: no gray ink
+
+	if (outChangedBands)
+		*outChangedBands = geo.allBandsMask();
 	return true;
 }
@@ -1,16 +1,74 @@
 #pragma once
 #include <Arduino.h>
 #include "AppNetworkManager.h"
+#include "FrameStore.h"
+#include "EndpointRanker.h"
+#include "TileDelta.h"
+#include "PanelTraits.h"
+
+struct PbmCtx;
 
 class ItemsClient
 {
 public:
-	ItemsClient(AppNetworkManager &net, const char *itemsUrl);
+	// store (optional): interrupted downloads are persisted there and resumed via Range
+	ItemsClient(AppNetworkManager &net, const char *itemsUrl, FrameStore *store = nullptr);
+
+	// Same content served from several endpoints (e.g. LAN + ngrok). Tried best-first by
+	// EndpointRanker; the first complete bitmap wins.
+	ItemsClient(AppNetworkManager &net, const char *const *itemsUrls, size_t urlCount, FrameStore *store = nullptr);
+
+	// Race TCP connects to the top two endpoints when the ranking is uncertain (default on).
+	void setRaceEnabled(bool enabled) { _race = enabled; }
+
+	// Body digests (Content-Digest, Digest, Content-MD5, X-Content-SHA256) are always
+	// verified when present; with this set, responses without one are rejected too.
+	void setRequireDigest(bool required) { _requireDigest = required; }
+
+	// Also accept the compact item list (ItemList.h); it is rendered into the frame on the
+	// device, so delta bands, FrameStore and partial refresh work as for a P4. Default off.
+	void setItemListEnabled(bool enabled) { _itemList = enabled; }
 
 	// P4 PBM -> outBuf must be >= bytesNeeded = ((w+7)/8)*h
+	// Returns true only for a complete bitmap (a resumed prefix alone never counts).
 	bool fetchPbmP4(uint8_t *outBuf, size_t outLen, int expectedW, int expectedH, uint32_t timeoutMs = 15000);
 
+	// Like fetchPbmP4, but when haveFrame is set, frame holds the retained image and its
+	// tile manifest is sent along. The server may answer with a tile-delta container, which
+	// is patched into frame in place, or with a full P4.
+	// outChangedBands: bit i set = band i (TILE_ROWS rows) changed; 0 = unchanged.
+	bool fetchFrame(uint8_t *frame, size_t len, int w, int h, bool haveFrame,
+					uint32_t *outChangedBands, uint32_t timeoutMs = 15000);
+
+	// Typed variant: geometry and buffer size come from the panel traits and are checked
+	// against the tile protocol limits at compile time. A two-plane buffer also accepts
+	// P5 gray (always fetched whole; a P4 answer leaves the second plane clear).
+	template <typename Panel, uint8_t Planes>
+	bool fetchFrame(FrameBuffer<Panel, Planes> &frame, bool haveFrame,
+					uint32_t *outChangedBands, uint32_t timeoutMs = 15000)
+	{
+		static_assert(Panel::BYTES_PER_ROW <= TILE_MAX_BYTES_PER_ROW, "panel too wide for the tile parser");
+		static_assert((Panel::HEIGHT + TILE_ROWS - 1) / TILE_ROWS <= TILE_MAX_BANDS, "too many bands for a 32-bit mask");
+		return fetchPlanes(frame.data, sizeof(frame.data), Panel::WIDTH, Panel::HEIGHT, Planes, haveFrame,
+						   outChangedBands, timeoutMs);
+	}
+
+private:
+	bool fetchPlanes(uint8_t *frame, size_t len, int w, int h, uint8_t planes, bool haveFrame,
+					 uint32_t *outChangedBands, uint32_t timeoutMs);
+	bool fetchFrom(const char *url, uint8_t *outBuf, size_t outLen, int expectedW, int expectedH, uint8_t planes,
+				   uint32_t timeoutMs, const char *manifestHeader, uint32_t *outChangedBands, uint32_t *outTtfbMs);
+	void savePartial(const PbmCtx &ctx, const HttpResponseInfo &resp, const PartialFrame *prev);
+	bool verifyDigest(PbmCtx &ctx, const HttpResponseInfo &resp);
+
 private:
 	AppNetworkManager &_net;
-	const char *_itemsUrl;
+	const char *_itemsUrl; // single-URL storage for the first constructor
+	EndpointRanker _endpoints;
+	FrameStore *_store;
+	bool _race = true;
+	bool _requireDigest = false;
+	bool _digestMismatch = false; // last fetchFrom failed integrity (frame buffer touched)
+	bool _itemList = false;
+	bool _lastWasItems = false; // last fetchFrom rendered an item list
 };
@@ -0,0 +1,559 @@
+#include "OtaUpdater.h"
+#include "Digest.h"
+
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <esp_system.h>
+
+static constexpr uint32_t PROGRESS_MAGIC = 0x314C444F; // "ODL1"
+static constexpr size_t HEADER_BYTES = 4 + 4 + 4 + 32;
+static constexpr uint32_t SECTOR_BYTES = 4096;
+static constexpr size_t PAGE_BYTES = 256;
+
+enum DeltaOp : uint8_t
+{
+	OP_END = 0,
+	OP_COPY = 1,
+	OP_ADD = 2,
+	OP_INSERT = 3,
+	OP_SEEK = 4,
+};
+
+enum Phase : uint8_t
+{
+	PHASE_HEADER,
+	PHASE_OP,
+	PHASE_OPERAND,
+	PHASE_DATA,
+	PHASE_DONE,
+};
+
+// Everything needed to pick an interrupted apply up again; the target bytes so far are
+// already in flash.
+struct DeltaState
+{
+	uint32_t magic; // PROGRESS_MAGIC while a download is in flight
+	char etag[48];	// validator sent back as If-Range
+	uint8_t targetSubtype;
+	uint8_t phase;
+	uint8_t op;
+	uint8_t shift;	   // operand bits read so far
+	uint32_t operand;  // operand being read, then data bytes left of the op
+	uint32_t received; // delta bytes applied
+	uint32_t srcPos;
+	uint32_t outPos;
+	uint32_t erasedTo;
+	uint32_t headerGot;
+	uint8_t header[HEADER_BYTES];
+};
+
+RTC_DATA_ATTR static DeltaState rtcDelta;
+RTC_DATA_ATTR static uint16_t rtcWakesSinceCheck = UINT16_MAX; // power-on checks at once
+
+// NVS, not RTC memory: RTC variables do not keep their addresses across builds.
+struct TrialRecord
+{
+	uint8_t subtype;  // partition of the image on trial
+	uint8_t previous; // partition to go back to
+	uint8_t failures; // crash resets + failed fetches with the network up
+	uint8_t crashes;
+	uint8_t sha[8]; // image digest prefix; a crashing image is not taken again
+};
+
+static const char *NVS_NS = "ota";
+static const char *KEY_TRIAL = "trial";
+static const char *KEY_REJECTED = "rejected";
+
+struct ApplyCtx
+{
+	DeltaState *st;
+	const esp_partition_t *src;
+	const esp_partition_t *dst;
+	const HttpResponseInfo *resp;
+	uint8_t rejected[8]; // digest prefix of an image that was rolled back
+	bool started;
+	const char *fail;
+	size_t pageFill;
+	uint8_t page[PAGE_BYTES];
+};
+
+static uint32_t rd32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t sourceSize(const DeltaState &st) { return rd32(st.header + 4); }
+static uint32_t targetSize(const DeltaState &st) { return rd32(st.header + 8); }
+
+static void resetDelta(DeltaState &st, uint8_t targetSubtype)
+{
+	memset(&st, 0, sizeof(st));
+	st.targetSubtype = targetSubtype;
+	st.phase = PHASE_HEADER;
+}
+
+// Writes the buffered page, erasing the sectors it reaches into first.
+static bool flushPage(ApplyCtx &c)
+{
+	DeltaState &st = *c.st;
+	if (!c.pageFill)
+		return true;
+
+	while (st.erasedTo < st.outPos)
+	{
+		if (esp_partition_erase_range(c.dst, st.erasedTo, SECTOR_BYTES) != ESP_OK)
+		{
+			c.fail = "Flash erase failed";
+			return false;
+		}
+		st.erasedTo += SECTOR_BYTES;
+	}
+
+	if (esp_partition_write(c.dst, st.outPos - c.pageFill, c.page, c.pageFill) != ESP_OK)
+	{
+		c.fail = "Flash write failed";
+		return false;
+	}
+	c.pageFill = 0;
+	return true;
+}
+
+static bool emit(ApplyCtx &c, const uint8_t *p, size_t n)
+{
+	while (n)
+	{
+		const size_t k = (n < PAGE_BYTES - c.pageFill) ? n : PAGE_BYTES - c.pageFill;
+		memcpy(c.page + c.pageFill, p, k);
+		c.pageFill += k;
+		c.st->outPos += k;
+		p += k;
+		n -= k;
+		if (c.pageFill == PAGE_BYTES && !flushPage(c))
+			return false;
+	}
+	return true;
+}
+
+// n source bytes from the cursor, each plus add[i] when add is given (ADD), else as they are (COPY).
+static bool fromSource(ApplyCtx &c, const uint8_t *add, size_t n)
+{
+	uint8_t buf[PAGE_BYTES];
+	while (n)
+	{
+		const size_t k = n < sizeof(buf) ? n : sizeof(buf);
+		if (esp_partition_read(c.src, c.st->srcPos, buf, k) != ESP_OK)
+		{
+			c.fail = "Flash read failed";
+			return false;
+		}
+		if (add)
+		{
+			for (size_t i = 0; i < k; i++)
+				buf[i] += add[i];
+			add += k;
+		}
+		if (!emit(c, buf, k))
+			return false;
+		c.st->srcPos += k;
+		n -= k;
+	}
+	return true;
+}
+
+static void checkHeader(ApplyCtx &c)
+{
+	DeltaState &st = *c.st;
+	if (memcmp(st.header, "ODL1", 4) != 0)
+		c.fail = "Bad delta magic";
+	else if (sourceSize(st) > c.src->size)
+		c.fail = "Delta source larger than the running partition";
+	else if (targetSize(st) == 0 || targetSize(st) > c.dst->size)
+		c.fail = "Delta target does not fit the update partition";
+	else if (memcmp(st.header + 12, c.rejected, sizeof(c.rejected)) == 0)
+		c.fail = "Image was rolled back before";
+	else
+	{
+		st.phase = PHASE_OP;
+		Serial.printf("[OTA] delta: %u -> %u image bytes\n", (unsigned)sourceSize(st), (unsigned)targetSize(st));
+	}
+}
+
+// Operand complete: COPY and SEEK happen here, ADD and INSERT wait for their data.
+static void startOp(ApplyCtx &c)
+{
+	DeltaState &st = *c.st;
+	const uint32_t n = st.operand;
+	const uint32_t srcLeft = sourceSize(st) - st.srcPos;
+	const uint32_t outLeft = targetSize(st) - st.outPos;
+	st.phase = PHASE_OP;
+
+	switch (st.op)
+	{
+	case OP_COPY:
+		if (n > srcLeft || n > outLeft)
+			c.fail = "Delta op out of range";
+		else
+			fromSource(c, nullptr, n);
+		break;
+	case OP_ADD:
+	case OP_INSERT:
+		if ((st.op == OP_ADD && n > srcLeft) || n > outLeft)
+			c.fail = "Delta op out of range";
+		else if (n)
+			st.phase = PHASE_DATA;
+		break;
+	case OP_SEEK:
+	{
+		const int64_t pos = (int64_t)st.srcPos + (int32_t)((n >> 1) ^ (0u - (n & 1)));
+		if (pos < 0 || pos > (int64_t)sourceSize(st))
+			c.fail = "Delta seek out of range";
+		else
+			st.srcPos = (uint32_t)pos;
+		break;
+	}
+	}
+}
+
+static bool feed(ApplyCtx &c, const uint8_t *data, size_t len)
+{
+	DeltaState &st = *c.st;
+	size_t i = 0;
+	while (i < len && !c.fail)
+	{
+		switch (st.phase)
+		{
+		case PHASE_HEADER:
+		{
+			const size_t k = (len - i < HEADER_BYTES - st.headerGot) ? len - i : HEADER_BYTES - st.headerGot;
+			memcpy(st.header + st.headerGot, data + i, k);
+			st.headerGot += k;
+			i += k;
+			if (st.headerGot == HEADER_BYTES)
+				checkHeader(c);
+			break;
+		}
+		case PHASE_OP:
+			st.op = data[i++];
+			st.operand = 0;
+			st.shift = 0;
+			if (st.op == OP_END)
+				st.phase = PHASE_DONE;
+			else if (st.op > OP_SEEK)
+				c.fail = "Unknown delta op";
+			else
+				st.phase = PHASE_OPERAND;
+			break;
+		case PHASE_OPERAND:
+		{
+			const uint8_t b = data[i++];
+			if (st.shift > 28)
+			{
+				c.fail = "Bad delta operand";
+				break;
+			}
+			st.operand |= (uint32_t)(b & 0x7F) << st.shift;
+			st.shift += 7;
+			if (!(b & 0x80))
+				startOp(c);
+			break;
+		}
+		case PHASE_DATA:
+		{
+			const size_t k = (len - i < st.operand) ? len - i : st.operand;
+			if (st.op == OP_ADD)
+				fromSource(c, data + i, k);
+			else
+				emit(c, data + i, k);
+			i += k;
+			st.operand -= k;
+			if (!st.operand)
+				st.phase = PHASE_OP;
+			break;
+		}
+		default:
+			c.fail = "Trailing bytes after delta";
+			break;
+		}
+	}
+	return !c.fail;
+}
+
+static bool onDeltaBytes(const uint8_t *data, size_t len, void *user)
+{
+	ApplyCtx &c = *(ApplyCtx *)user;
+	DeltaState &st = *c.st;
+
+	if (!c.started)
+	{
+		c.started = true;
+		const bool rangeHonoured = c.resp->httpCode == 206 && c.resp->rangeStart == (int)st.received;
+		if (st.received && !rangeHonoured)
+		{
+			Serial.printf("[OTA] resume not honoured (HTTP %d); starting over\n", c.resp->httpCode);
+			resetDelta(st, st.targetSubtype);
+		}
+	}
+
+	if (!feed(c, data, len))
+		return false;
+	st.received += len;
+	return true;
+}
+
+static bool imageMatches(const esp_partition_t *part, uint32_t len, const uint8_t *sha256)
+{
+	StreamDigest digest;
+	digest.begin(DigestAlgo::Sha256);
+
+	uint8_t buf[512];
+	for (uint32_t off = 0; off < len;)
+	{
+		const uint32_t k = (len - off < sizeof(buf)) ? len - off : sizeof(buf);
+		if (esp_partition_read(part, off, buf, k) != ESP_OK)
+			return false;
+		digest.update(buf, k);
+		off += k;
+	}
+
+	uint8_t got[DIGEST_MAX_BYTES];
+	digest.finish(got);
+	return memcmp(got, sha256, 32) == 0;
+}
+
+OtaUpdater::OtaUpdater(AppNetworkManager &net)
+	: _net(net) {}
+
+// Only an image that crashed is rejected for good; one that merely couldn't reach the
+// server (server down, expired key) is offered again at a later check.
+static void rollBack(Preferences &prefs, const TrialRecord &t)
+{
+	if (t.crashes)
+		prefs.putBytes(KEY_REJECTED, t.sha, sizeof(t.sha));
+	prefs.end();
+
+	const esp_partition_t *prev = esp_partition_find_first(ESP_PARTITION_TYPE_APP, (esp_partition_subtype_t)t.previous, nullptr);
+	if (!prev || esp_ota_set_boot_partition(prev) != ESP_OK)
+	{
+		Serial.println("[OTA] rollback failed: previous image not bootable; keeping this one");
+		return;
+	}
+
+	Serial.printf("[OTA] new image failed %u checks (%u crash(es)); back to %s\n",
+				  (unsigned)t.failures, (unsigned)t.crashes, prev->label);
+	Serial.flush();
+	esp_restart();
+}
+
+void OtaUpdater::begin()
+{
+	Preferences prefs;
+	if (!prefs.begin(NVS_NS, false))
+		return;
+
+	TrialRecord t;
+	if (prefs.getBytesLength(KEY_TRIAL) != sizeof(t) || prefs.getBytes(KEY_TRIAL, &t, sizeof(t)) != sizeof(t))
+	{
+		prefs.end();
+		return;
+	}
+
+	const esp_partition_t *running = esp_ota_get_running_partition();
+	if (!running || running->subtype != t.subtype)
+	{
+		Serial.println("[OTA] staged image is not the one running (bootloader rollback?); trial dropped");
+		prefs.remove(KEY_TRIAL);
+	}
+	else
+	{
+		// Timer, button and power-on boots say nothing about the image; a panic or watchdog
+		// reset does (a crash loop never gets as far as a fetch).
+		const esp_reset_reason_t reason = esp_reset_reason();
+		if (reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT || reason == ESP_RST_TASK_WDT ||
+			reason == ESP_RST_WDT)
+		{
+			t.crashes++;
+			t.failures++;
+		}
+		if (t.failures >= OTA_TRIAL_FAILURES)
+		{
+			prefs.remove(KEY_TRIAL);
+			rollBack(prefs, t);
+			return;
+		}
+		prefs.putBytes(KEY_TRIAL, &t, sizeof(t));
+		_trial = true;
+		Serial.printf("[OTA] new image on trial, %u/%u failed checks\n", (unsigned)t.failures, (unsigned)OTA_TRIAL_FAILURES);
+	}
+	prefs.end();
+}
+
+void OtaUpdater::fetchFailed()
+{
+	if (!_trial)
+		return;
+
+	Preferences prefs;
+	if (!prefs.begin(NVS_NS, false))
+		return;
+
+	TrialRecord t;
+	if (prefs.getBytesLength(KEY_TRIAL) == sizeof(t) && prefs.getBytes(KEY_TRIAL, &t, sizeof(t)) == sizeof(t))
+	{
+		t.failures++;
+		if (t.failures >= OTA_TRIAL_FAILURES)
+		{
+			prefs.remove(KEY_TRIAL);
+			rollBack(prefs, t);
+			return;
+		}
+		prefs.putBytes(KEY_TRIAL, &t, sizeof(t));
+		Serial.printf("[OTA] image on trial: fetch failed (%u/%u)\n", (unsigned)t.failures, (unsigned)OTA_TRIAL_FAILURES);
+	}
+	prefs.end();
+}
+
+void OtaUpdater::confirm()
+{
+	if (!_trial)
+		return;
+
+	esp_ota_mark_app_valid_cancel_rollback(); // no-op unless the bootloader rolls back itself
+
+	Preferences prefs;
+	if (prefs.begin(NVS_NS, false))
+	{
+		prefs.remove(KEY_TRIAL);
+		prefs.end();
+	}
+	_trial = false;
+	Serial.println("[OTA] new image confirmed");
+}
+
+bool OtaUpdater::poll(const char *url, uint16_t checkEveryWakes, uint32_t timeoutMs)
+{
+	DeltaState &st = rtcDelta;
+	bool resuming = st.magic == PROGRESS_MAGIC;
+
+	if (rtcWakesSinceCheck < UINT16_MAX)
+		rtcWakesSinceCheck++;
+	if (_trial || (!resuming && rtcWakesSinceCheck < checkEveryWakes))
+		return false; // no second update on top of an unconfirmed one
+	rtcWakesSinceCheck = 0;
+
+	if (strncmp(url, "https://", 8) != 0 || _net.tlsConfig().profile == TlsProfile::Insecure)
+	{
+		Serial.println("[OTA] disabled: needs an https URL and the pinned-ca or psk TLS profile");
+		return false;
+	}
+
+	const esp_partition_t *running = esp_ota_get_running_partition();
+	const esp_partition_t *target = esp_ota_get_next_update_partition(nullptr);
+	if (!running || !target)
+	{
+		Serial.println("[OTA] no partition to update into");
+		return false;
+	}
+	if (resuming && st.targetSubtype != target->subtype)
+		resuming = false;
+	if (!resuming)
+		resetDelta(st, target->subtype);
+
+	char id[17];
+	esp_ota_get_app_elf_sha256(id, sizeof(id));
+	char full[256];
+	snprintf(full, sizeof(full), "%s%cfrom=%s", url, strchr(url, '?') ? '&' : '?', id);
+
+	HttpRequestOptions req;
+	HttpResponseInfo resp;
+	if (resuming)
+	{
+		req.rangeStart = st.received;
+		req.ifRange = st.etag;
+		Serial.printf("[OTA] resuming at delta byte %u (%u/%u image bytes)\n",
+					  (unsigned)st.received, (unsigned)st.outPos, (unsigned)targetSize(st));
+	}
+	else
+	{
+		Serial.printf("[OTA] GET %s\n", full);
+	}
+
+	ApplyCtx c = {};
+	Preferences prefs;
+	if (prefs.begin(NVS_NS, true))
+	{
+		prefs.getBytes(KEY_REJECTED, c.rejected, sizeof(c.rejected));
+		prefs.end();
+	}
+	c.st = &st;
+	c.src = running;
+	c.dst = target;
+	c.resp = &resp;
+
+	const uint32_t startMs = millis();
+	const bool ok = _net.httpGetStream(full, onDeltaBytes, &c, timeoutMs, req, resp);
+	if (!c.fail)
+		flushPage(c); // what was applied is in flash before the state is kept
+
+	if (ok && resp.httpCode == 204)
+	{
+		Serial.println("[OTA] firmware is current");
+		st.magic = 0;
+		return false;
+	}
+
+	if (!ok && !c.fail && st.received)
+	{
+		const char *etag = resp.etag[0] ? resp.etag : st.etag;
+		if (etag[0] && strncmp(etag, "W/", 2) != 0 && strlen(etag) < sizeof(st.etag))
+		{
+			if (etag != st.etag)
+				strncpy(st.etag, etag, sizeof(st.etag) - 1);
+			st.magic = PROGRESS_MAGIC;
+			Serial.printf("[OTA] paused at delta byte %u (%u/%u image bytes): %s\n", (unsigned)st.received,
+						  (unsigned)st.outPos, (unsigned)targetSize(st), resp.error);
+			return false;
+		}
+	}
+
+	st.magic = 0;
+	if (!c.fail && ok && (st.phase != PHASE_DONE || st.outPos != targetSize(st)))
+		c.fail = "Delta ended early";
+	if (!ok || c.fail)
+	{
+		Serial.printf("[OTA] update failed (HTTP %d): %s\n", resp.httpCode, c.fail ? c.fail : resp.error);
+		return false;
+	}
+
+	if (!imageMatches(target, targetSize(st), st.header + 12))
+	{
+		Serial.println("[OTA] image digest mismatch; not booting it");
+		return false;
+	}
+
+	// Recorded first: if setting the boot partition fails, begin() finds the trial is not running.
+	if (prefs.begin(NVS_NS, false))
+	{
+		TrialRecord t = {(uint8_t)target->subtype, (uint8_t)running->subtype, 0, 0, {0}};
+		memcpy(t.sha, st.header + 12, sizeof(t.sha));
+		prefs.putBytes(KEY_TRIAL, &t, sizeof(t));
+		prefs.end();
+	}
+
+	if (esp_ota_set_boot_partition(target) != ESP_OK)
+	{
+		Serial.println("[OTA] image rejected as boot partition");
+		return false;
+	}
+
+	Serial.printf("[OTA] %u-byte image verified, boots from %s (%u delta bytes, %u ms)\n",
+				  (unsigned)targetSize(st), target->label, (unsigned)st.received, (unsigned)(millis() - startMs));
+	return true;
+}
+
+void OtaUpdater::restart()
+{
+	Serial.println("[OTA] restarting into the new image");
+	Serial.flush();
+	esp_restart();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "AppNetworkManager.h"
+
+// Delta firmware updates, streamed through httpGetStream's ChunkCallback straight into the
+// inactive OTA partition. tools/ota_delta.py builds the deltas; tools/list_server.py --ota
+// serves them.
+//
+// GET <url>?from=<first 16 hex digits of the running image's ELF SHA-256> answers 204 when
+// the device is current, else 200 with an application/x-ota-delta from the running image:
+//
+//   "ODL1" u32le sourceSize, u32le targetSize, SHA-256 of the target image (32 bytes)
+//   ops, each a code byte and an LEB128 operand:
+//     1 COPY n    n source bytes from the cursor
+//     2 ADD n     n bytes follow, each added (mod 256) to the source byte at the cursor
+//     3 INSERT n  n literal bytes follow
+//     4 SEEK d    cursor += d (zigzag)
+//     0 END
+//
+// bsdiff-style: a relinked image is mostly the old one, shifted, with pointers that differ
+// in a byte or two, so ADD runs stay short and most of the image is COPY. The source is read
+// back from the running partition and the target is written in order (sectors erased just
+// ahead), never held in RAM. An interrupted download keeps its place in RTC memory and
+// resumes with Range / If-Range on a later wake. The finished image is hashed back from
+// flash before it is made bootable; the device then restarts into it.
+//
+// Only https URLs with an authenticating TLS profile (PinnedCa or Psk) are used: the
+// header's SHA-256 is no signature, whoever serves the delta chooses the image.
+//
+// The new image runs on trial until confirm(). OTA_TRIAL_FAILURES failed checks (crash resets,
+// and fetches that failed with WiFi up) make the previous image bootable again; wakes that
+// never tried a fetch (dormant, AP down, rate-limited button) don't count. Only an image that
+// crashed is refused for good. With the bootloader's own rollback enabled
+// (CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE) the first wake has to confirm.
+//
+//   [OTA] 1048576-byte image verified, boots from ota_1 (41230 delta bytes, 14210 ms)
+
+static constexpr uint8_t OTA_TRIAL_FAILURES = 3;
+
+class OtaUpdater
+{
+public:
+	explicit OtaUpdater(AppNetworkManager &net);
+
+	// Boot-time trial bookkeeping: a crash reset counts as a failed check. Rolls back
+	// (restarts) once a new image has OTA_TRIAL_FAILURES of them.
+	void begin();
+
+	// Checks for an update every checkEveryWakes calls (and on power-on), or continues an
+	// interrupted one on every call. True once a verified image is set to boot; restart() then.
+	bool poll(const char *url, uint16_t checkEveryWakes, uint32_t timeoutMs);
+
+	// The image on trial did its job (a fetch went through): keep it.
+	void confirm();
+
+	// The image on trial got WiFi up but no frame through: a failed check (may roll back).
+	void fetchFailed();
+
+	// Reboot into the staged image. Not a deep sleep: RTC variables have to start from the new
+	// image's initial values, its layout differs.
+	void restart();
+
+	bool onTrial() const { return _trial; }
+
+private:
+	AppNetworkManager &_net;
+	bool _trial = false;
+};
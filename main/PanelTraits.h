@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Arduino.h>
+#include <GxEPD2_BW.h>
+
+// Compile-time panel description: driver, logical frame size (what the server renders),
+// rotation and buffer sizes. DisplayDrawer, FrameBuffer and ItemsClient::fetchFrame are
+// specialized on it, so a variant build carries no runtime geometry checks.
+//
+// Driver      GxEPD2 driver class (native WIDTH x HEIGHT in controller RAM order)
+// FrameW/H    server bitmap size; must equal the native size or its transpose
+// SwapRot     GxEPD2 rotation used when the frame is the transpose (1 or 3)
+// Gray4       controller has a 4-gray waveform (driver writeImagePart_4G) and the frame is native
+// FastFull    driver has a fast full-refresh waveform (runtime useFastFullUpdate switch)
+template <typename Driver, uint16_t FrameW, uint16_t FrameH, uint8_t SwapRot = 1, bool Gray4 = false,
+		  bool FastFull = false>
+struct PanelTraits
+{
+	using DriverType = Driver;
+
+	static constexpr uint16_t WIDTH = FrameW;
+	static constexpr uint16_t HEIGHT = FrameH;
+	static constexpr uint16_t BYTES_PER_ROW = (FrameW + 7) / 8;
+	static constexpr size_t FRAME_BYTES = (size_t)BYTES_PER_ROW * FrameH;
+
+	static constexpr bool NATIVE = Driver::WIDTH == FrameW && Driver::HEIGHT == FrameH;
+	static constexpr bool TRANSPOSED = Driver::WIDTH == FrameH && Driver::HEIGHT == FrameW;
+	static constexpr uint8_t ROTATION = NATIVE ? 0 : SwapRot;
+	static constexpr bool GRAY4 = Gray4;
+	static constexpr bool FAST_FULL = FastFull;
+
+	static_assert(NATIVE || TRANSPOSED, "frame size does not match the panel in any rotation");
+	static_assert(SwapRot == 1 || SwapRot == 3, "transposed rotation must be 1 or 3");
+	static_assert(FrameW % 8 == 0, "frame width must be byte aligned (P4 rows, GxEPD2 windows)");
+	static_assert(!Gray4 || NATIVE, "4-gray upload is native orientation only");
+
+	// Full-height page buffer: one firstPage()/nextPage() pass per refresh
+	using Display = GxEPD2_BW<Driver, Driver::HEIGHT>;
+};
+
+using Panel29 = PanelTraits<GxEPD2_290_T94_V2, 296, 128>;	   // 2.9"  296x128 landscape
+using Panel42 = PanelTraits<GxEPD2_420_GDEY042T81, 400, 300, 1, true, true>; // 4.2"  400x300, 4-gray, fast full
+using Panel75 = PanelTraits<GxEPD2_750_T7, 800, 480>;		   // 7.5"  800x480
+
+// Build-time panel selection: -DPANEL_VARIANT=29|42|75 (default 42)
+#ifndef PANEL_VARIANT
+#define PANEL_VARIANT 42
+#endif
+
+#if PANEL_VARIANT == 29
+using ActivePanel = Panel29;
+#elif PANEL_VARIANT == 42
+using ActivePanel = Panel42;
+#elif PANEL_VARIANT == 75
+using ActivePanel = Panel75;
+#else
+#error "Unsupported PANEL_VARIANT (29, 42, 75)"
+#endif
+
+// Build-time frame depth: -DFRAME_GRAY=1 fetches 2-bpp gray (P5 PGM, quantized while
+// streaming) into two bit planes; P4 frames are still accepted. Default 1 bpp.
+#ifndef FRAME_GRAY
+#define FRAME_GRAY 0
+#endif
+
+// Frame bitmap sized exactly for one panel, as 1 or 2 bit planes of P4 layout (MSB first,
+// FRAME_BYTES each). Plane 0 alone is the 1-bpp image (1 = black); with two planes the
+// ink level is (plane0 << 1) | plane1: 0 white, 1 light gray, 2 dark gray, 3 black.
+template <typename Panel, uint8_t Planes = 1>
+struct FrameBuffer
+{
+	static_assert(Planes == 1 || Planes == 2, "1 or 2 bit planes");
+	static constexpr uint8_t PLANES = Planes;
+	static constexpr size_t PLANE_BYTES = Panel::FRAME_BYTES;
+	static constexpr size_t SIZE = PLANE_BYTES * Planes;
+	uint8_t data[SIZE];
+};
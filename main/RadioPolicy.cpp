@@ -0,0 +1,138 @@
+#include "RadioPolicy.h"
+#include "Hash.h"
+#include <esp_wifi.h>
+
+RTC_DATA_ATTR static RadioPolicy::History rtcRadio;
+
+const char *radioProfileName(RadioProfile profile)
+{
+	switch (profile)
+	{
+	case RadioProfile::Strong:
+		return "strong";
+	case RadioProfile::Weak:
+		return "weak";
+	default:
+		return "normal";
+	}
+}
+
+RadioPolicy::RadioPolicy(const char *ssid)
+	: _ssid(ssid)
+{
+	const uint32_t h = fnv1aKey(ssid ? ssid : "");
+	if (rtcRadio.ssidHash != h)
+	{
+		memset(&rtcRadio, 0, sizeof(rtcRadio));
+		rtcRadio.ssidHash = h;
+	}
+}
+
+int RadioPolicy::averageRssi() const
+{
+	int sum = 0;
+	for (uint8_t i = 0; i < rtcRadio.samples; i++)
+		sum += rtcRadio.rssi[i];
+	return rtcRadio.samples ? sum / (int)rtcRadio.samples : 0;
+}
+
+RadioProfile RadioPolicy::choose() const
+{
+	// Failing links get the defaults back: a lowered TX power must never be why we're stuck
+	if (rtcRadio.failStreak || rtcRadio.samples == 0)
+		return RadioProfile::Normal;
+
+	int8_t worst = rtcRadio.rssi[0];
+	for (uint8_t i = 1; i < rtcRadio.samples; i++)
+		if (rtcRadio.rssi[i] < worst)
+			worst = rtcRadio.rssi[i];
+
+	if (rtcRadio.samples >= 2 && worst >= STRONG_RSSI && rtcRadio.assocMs < SLOW_ASSOC_MS)
+		return RadioProfile::Strong;
+	if (averageRssi() < WEAK_RSSI)
+		return RadioProfile::Weak;
+	return RadioProfile::Normal;
+}
+
+void RadioPolicy::apply(RadioProfile profile)
+{
+	const bool weak = profile == RadioProfile::Weak;
+
+	// 802.11b's DSSS rates decode at lower signal levels than OFDM; HT40 halves the margin
+	esp_wifi_set_protocol(WIFI_IF_STA, weak ? (WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G)
+											: (WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N));
+	esp_wifi_set_bandwidth(WIFI_IF_STA, WIFI_BW_HT20);
+	WiFi.setTxPower(profile == RadioProfile::Strong ? STRONG_TX_POWER : WIFI_POWER_19_5dBm);
+
+	Serial.printf("[RADIO] profile=%s tx=%d (0.25 dBm) rssi avg=%d n=%u assoc=%u ms fails=%u\n",
+				  radioProfileName(profile), (int)WiFi.getTxPower(), averageRssi(),
+				  (unsigned)rtcRadio.samples, (unsigned)rtcRadio.assocMs, (unsigned)rtcRadio.failStreak);
+}
+
+const uint8_t *RadioPolicy::bssid() const
+{
+	return rtcRadio.channel ? rtcRadio.bssid : nullptr;
+}
+
+uint8_t RadioPolicy::channel() const
+{
+	return rtcRadio.channel;
+}
+
+uint8_t RadioPolicy::failStreak() const
+{
+	return rtcRadio.failStreak;
+}
+
+bool RadioPolicy::probe(uint8_t channel, uint8_t *outBssid, uint8_t *outChannel, int8_t *outRssi)
+{
+	const uint32_t t0 = millis();
+	const int16_t n = WiFi.scanNetworks(false, false, false, PROBE_MS_PER_CHANNEL, channel, _ssid);
+
+	int best = -1;
+	for (int16_t i = 0; i < n; i++)
+	{
+		if (WiFi.SSID(i) == _ssid && (best < 0 || WiFi.RSSI(i) > WiFi.RSSI(best)))
+			best = i;
+	}
+
+	if (best >= 0)
+	{
+		memcpy(outBssid, WiFi.BSSID(best), 6);
+		*outChannel = (uint8_t)WiFi.channel(best);
+		*outRssi = (int8_t)WiFi.RSSI(best);
+	}
+	WiFi.scanDelete();
+
+	Serial.printf("[RADIO] probe ch=%u: %s (%lu ms)\n", (unsigned)channel,
+				  best >= 0 ? "AP found" : "no AP", (unsigned long)(millis() - t0));
+	return best >= 0;
+}
+
+void RadioPolicy::recordSuccess(uint32_t assocMs, int8_t rssi, const uint8_t *bssid, uint8_t channel)
+{
+	History &h = rtcRadio;
+	h.rssi[h.next] = rssi;
+	h.next = (uint8_t)((h.next + 1) % HISTORY);
+	if (h.samples < HISTORY)
+		h.samples++;
+
+	const uint32_t ms = assocMs > 0xFFFF ? 0xFFFF : assocMs;
+	h.assocMs = h.assocMs ? (uint16_t)((h.assocMs * 3 + ms) / 4) : (uint16_t)ms;
+	h.failStreak = 0;
+
+	if (bssid && channel)
+	{
+		memcpy(h.bssid, bssid, sizeof(h.bssid));
+		h.channel = channel;
+	}
+}
+
+void RadioPolicy::recordFailure(bool apMissing)
+{
+	if (rtcRadio.failStreak < 255)
+		rtcRadio.failStreak++;
+	// The AP may have moved channel; the next attempt scans before it trusts the cache
+	if (apMissing)
+		rtcRadio.channel = 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+// Link-quality driven radio settings, from a short history kept in RTC memory (survives
+// deep sleep; keyed by SSID hash, so a new network starts from defaults):
+//   - Strong: every recent association at >= STRONG_RSSI, and associating quickly (average
+//     under SLOW_ASSOC_MS) -> reduced TX power. A strong signal that still takes long to
+//     join (retries, a busy channel) keeps full power.
+//   - Weak:   average below WEAK_RSSI -> full TX power, 802.11b/g only, HT20 (range)
+//   - Normal: anything else, no history, or a failure streak -> core defaults
+// The AP's BSSID and channel are cached too, so association can skip the all-channel scan.
+enum class RadioProfile : uint8_t
+{
+	Normal,
+	Strong,
+	Weak,
+};
+
+const char *radioProfileName(RadioProfile profile);
+
+class RadioPolicy
+{
+public:
+	static constexpr uint8_t HISTORY = 4;
+	static constexpr int8_t STRONG_RSSI = -55;
+	static constexpr int8_t WEAK_RSSI = -75;
+	static constexpr uint16_t SLOW_ASSOC_MS = 2500; // association + DHCP, cached channel
+	static constexpr wifi_power_t STRONG_TX_POWER = WIFI_POWER_11dBm;
+	static constexpr uint32_t PROBE_MS_PER_CHANNEL = 60;
+
+	struct History
+	{
+		uint32_t ssidHash; // 0 = empty
+		int8_t rssi[HISTORY];
+		uint8_t samples;
+		uint8_t next;
+		uint16_t assocMs; // EWMA of association time
+		uint8_t failStreak;
+		uint8_t channel; // 0 = no cached AP
+		uint8_t bssid[6];
+	};
+
+	explicit RadioPolicy(const char *ssid);
+
+	RadioProfile choose() const;
+
+	// After WiFi.mode(WIFI_STA), before WiFi.begin().
+	void apply(RadioProfile profile);
+
+	// Cached AP from the last association (nullptr / 0 when unknown)
+	const uint8_t *bssid() const;
+	uint8_t channel() const;
+	uint8_t failStreak() const;
+
+	// Active scan for our SSID (one channel, or all when 0). Fills the strongest AP found.
+	bool probe(uint8_t channel, uint8_t *outBssid, uint8_t *outChannel, int8_t *outRssi);
+
+	void recordSuccess(uint32_t assocMs, int8_t rssi, const uint8_t *bssid, uint8_t channel);
+	void recordFailure(bool apMissing);
+
+private:
+	int averageRssi() const;
+
+private:
+	const char *_ssid;
+};
@@ -0,0 +1,64 @@
+#include "RefreshPolicy.h"
+
+// Partial / fast refreshes since the last normal full one; 0 after power-on, whose first
+// refresh is always a full one.
+RTC_DATA_ATTR static uint8_t rtcUnclean = 0;
+
+const char *refreshModeName(RefreshMode mode)
+{
+	switch (mode)
+	{
+	case RefreshMode::Fast:
+		return "fast";
+	case RefreshMode::Partial:
+		return "partial";
+	default:
+		return "full";
+	}
+}
+
+RefreshPolicy::RefreshPolicy(bool fastFull, int8_t tempOffsetC)
+	: _fastFull(fastFull), _tempOffsetC(tempOffsetC)
+{
+}
+
+void RefreshPolicy::begin()
+{
+	// The die sensor isn't calibrated, and on many classic ESP32s it is stuck at raw 128,
+	// which reads as a constant 53.3 C. That value and anything outside a plausible room
+	// range count as unknown.
+	const float die = temperatureRead();
+	const float room = die - _tempOffsetC;
+	const bool stuck = die > STUCK_DIE_C - 0.05f && die < STUCK_DIE_C + 0.05f;
+	_tempC = (!stuck && room > -30.0f && room < 70.0f) ? (int8_t)(room + (room < 0 ? -0.5f : 0.5f))
+														: TEMP_UNKNOWN;
+}
+
+RefreshMode RefreshPolicy::choose(int changed, int total, bool panelKnown) const
+{
+	const bool tempOk = _tempC != TEMP_UNKNOWN && _tempC >= FAST_MIN_C && _tempC <= FAST_MAX_C;
+
+	RefreshMode mode;
+	if (!panelKnown || !tempOk || rtcUnclean >= MAX_UNCLEAN)
+		mode = RefreshMode::Full;
+	else if (changed * 2 <= total)
+		mode = RefreshMode::Partial; // beyond half the bands a full refresh is about as fast
+	else
+		mode = _fastFull ? RefreshMode::Fast : RefreshMode::Full;
+
+	if (_tempC == TEMP_UNKNOWN)
+		Serial.printf("[EPD] refresh %s: %d/%d bands, temp ?, %u since full\n",
+					  refreshModeName(mode), changed, total, (unsigned)rtcUnclean);
+	else
+		Serial.printf("[EPD] refresh %s: %d/%d bands, %d C, %u since full\n",
+					  refreshModeName(mode), changed, total, (int)_tempC, (unsigned)rtcUnclean);
+	return mode;
+}
+
+void RefreshPolicy::record(RefreshMode mode)
+{
+	if (mode == RefreshMode::Full)
+		rtcUnclean = 0;
+	else if (rtcUnclean < UINT8_MAX)
+		rtcUnclean++;
+}
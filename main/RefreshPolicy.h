@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Panel waveform for each update:
+//   - Partial: only the changed rows, when the controller holds our last frame and at most
+//     half the bands changed
+//   - Fast:    full refresh on the fast waveform (GDEY042T81: about half the time of the
+//     normal one) for bigger changes
+//   - Full:    the normal, temperature-compensated full refresh. Used after power-on (panel
+//     content unknown), outside FAST_MIN_C..FAST_MAX_C or when the temperature is unknown,
+//     and once MAX_UNCLEAN partial / fast refreshes have piled up since the last one, to
+//     clear their ghosting.
+// The count since the last full refresh is kept in RTC memory (survives deep sleep).
+//
+//   [EPD] refresh fast: 12/19 bands, 24 C, 3 since full
+enum class RefreshMode : uint8_t
+{
+	Full,
+	Fast,
+	Partial,
+};
+
+const char *refreshModeName(RefreshMode mode);
+
+class RefreshPolicy
+{
+public:
+	static constexpr uint8_t MAX_UNCLEAN = 8;
+	static constexpr int8_t FAST_MIN_C = 10; // fast and partial waveforms are room-temperature LUTs
+	static constexpr int8_t FAST_MAX_C = 40;
+	static constexpr int8_t TEMP_UNKNOWN = INT8_MIN;
+	static constexpr float STUCK_DIE_C = (128 - 32) / 1.8f; // classic ESP32 sensor stuck at raw 128
+
+	// fastFull: the panel has a fast waveform (PanelTraits::FAST_FULL) and it is wanted.
+	// tempOffsetC: ESP32 die minus room temperature right after a wake, per board.
+	RefreshPolicy(bool fastFull, int8_t tempOffsetC);
+
+	// Samples the temperature; call early in the wake, before the radio warms the die.
+	void begin();
+	int8_t temperatureC() const { return _tempC; }
+
+	// changed of total bands differ from the panel; panelKnown = controller RAM and glass
+	// hold our last frame (not after a power-on).
+	RefreshMode choose(int changed, int total, bool panelKnown) const;
+
+	// After each refresh: Full clears the count, Partial / Fast add to it.
+	void record(RefreshMode mode);
+
+private:
+	bool _fastFull;
+	int8_t _tempOffsetC;
+	int8_t _tempC = TEMP_UNKNOWN;
+};
@@ -0,0 +1,122 @@
+#include "StandbyChannel.h"
+
+#if defined(CONFIG_PM_ENABLE) && CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+
+StandbyChannel::StandbyChannel(const char *notifyHost, uint16_t notifyPort, uint16_t listenPort)
+	: _host(notifyHost), _port(notifyPort), _listenPort(listenPort) {}
+
+bool StandbyChannel::begin()
+{
+	if (WiFi.status() != WL_CONNECTED)
+		return false;
+
+	if (!WiFi.hostByName(_host, _server) || (uint32_t)_server == 0)
+	{
+		Serial.printf("[STBY] notifier %s not resolvable\n", _host);
+		return false;
+	}
+
+	if (!_udp.begin(_listenPort))
+	{
+		Serial.printf("[STBY] UDP bind %u failed\n", (unsigned)_listenPort);
+		return false;
+	}
+	_open = true;
+
+	// Modem sleep: the AP buffers frames for us and announces them in the DTIM beacon.
+	WiFi.setSleep(WIFI_PS_MAX_MODEM);
+
+#if defined(CONFIG_PM_ENABLE) && CONFIG_PM_ENABLE
+	// Let the idle task enter light sleep between beacons.
+	esp_pm_config_esp32_t pm = {};
+	pm.max_freq_mhz = 80;
+	pm.min_freq_mhz = 10;
+	pm.light_sleep_enable = true;
+	if (esp_pm_configure(&pm) != ESP_OK)
+		Serial.println("[STBY] automatic light sleep unavailable");
+#else
+	setCpuFrequencyMhz(80);
+#endif
+
+	subscribe();
+	Serial.printf("[STBY] listening on UDP %u; notifier %s:%u\n",
+				  (unsigned)_listenPort, _server.toString().c_str(), (unsigned)_port);
+	return true;
+}
+
+void StandbyChannel::end()
+{
+	if (_open)
+		_udp.stop();
+	_open = false;
+	WiFi.setSleep(false);
+#if !(defined(CONFIG_PM_ENABLE) && CONFIG_PM_ENABLE)
+	setCpuFrequencyMhz(240);
+#endif
+}
+
+void StandbyChannel::subscribe()
+{
+	char msg[24];
+	int n = snprintf(msg, sizeof(msg), "SUB1 %u\n", (unsigned)_listenPort);
+
+	_udp.beginPacket(_server, _port);
+	_udp.write((const uint8_t *)msg, (size_t)n);
+	_udp.endPacket();
+	_lastSubscribeMs = millis();
+}
+
+// Duplicates (notifier retries) share a sequence number and are dropped.
+bool StandbyChannel::readNotify()
+{
+	int size = _udp.parsePacket();
+	if (size <= 0)
+		return false;
+
+	char buf[32];
+	int n = _udp.read((uint8_t *)buf, sizeof(buf) - 1);
+	if (n <= 0)
+		return false;
+	buf[n] = '\0';
+
+	if ((uint32_t)_udp.remoteIP() != (uint32_t)_server || strncmp(buf, "NOTIFY1 ", 8) != 0)
+	{
+		Serial.println("[STBY] ignoring unexpected datagram");
+		return false;
+	}
+
+	uint32_t seq = strtoul(buf + 8, nullptr, 10);
+	if (_haveSeq && seq == _lastSeq)
+		return false;
+
+	_haveSeq = true;
+	_lastSeq = seq;
+	Serial.printf("[STBY] notify seq=%u\n", (unsigned)seq);
+	return true;
+}
+
+bool StandbyChannel::waitForNotify(uint32_t timeoutMs)
+{
+	const uint32_t startMs = millis();
+
+	while (_open && (millis() - startMs) < timeoutMs)
+	{
+		if (WiFi.status() != WL_CONNECTED)
+		{
+			Serial.println("[STBY] WiFi lost");
+			return false;
+		}
+
+		if (readNotify())
+			return true;
+
+		if ((millis() - _lastSubscribeMs) >= SUBSCRIBE_INTERVAL_MS)
+			subscribe();
+
+		// Idle: with PM the CPU light-sleeps here; the radio only wakes for DTIM beacons.
+		delay(50);
+	}
+	return false;
+}
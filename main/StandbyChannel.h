@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+// Connected standby: stay associated in modem sleep (radio wakes for DTIM beacons only)
+// and wait for a UDP notify from the server instead of deep-sleeping between polls.
+//
+//   device -> notifier  "SUB1 <listenPort>\n"   on begin() and every SUBSCRIBE_INTERVAL_MS
+//   notifier -> device  "NOTIFY1 <seq>\n"        when a new frame is available
+//
+// Subscriptions double as keepalives: they refresh the notifier's view of our address
+// and the AP's ARP/NAT state. tools/notify.py is a local stand-in notifier.
+class StandbyChannel
+{
+public:
+	static constexpr uint32_t SUBSCRIBE_INTERVAL_MS = 60000;
+
+	StandbyChannel(const char *notifyHost, uint16_t notifyPort, uint16_t listenPort);
+
+	// Binds the listen port, resolves the notifier and subscribes. Enables modem sleep
+	// (WIFI_PS_MAX_MODEM) and, when the core is built with power management, automatic
+	// light sleep between packets.
+	bool begin();
+	void end();
+
+	// true = notify received; false = timeout or WiFi lost (check WiFi.status()).
+	bool waitForNotify(uint32_t timeoutMs);
+
+	uint32_t lastSeq() const { return _lastSeq; }
+
+private:
+	void subscribe();
+	bool readNotify();
+
+private:
+	const char *_host;
+	uint16_t _port;
+	uint16_t _listenPort;
+
+	WiFiUDP _udp;
+	IPAddress _server;
+	bool _open = false;
+	uint32_t _lastSubscribeMs = 0;
+	uint32_t _lastSeq = 0;
+	bool _haveSeq = false;
+};
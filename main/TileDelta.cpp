@@ -0,0 +1,165 @@
+#include "TileDelta.h"
+#include "Hash.h"
+
+int TileGeometry::bandRows(int band) const
+{
+	int rows = h - band * TILE_ROWS;
+	return rows > TILE_ROWS ? TILE_ROWS : rows;
+}
+
+uint32_t TileGeometry::allBandsMask() const
+{
+	int n = bandCount();
+	return (n >= 32) ? 0xFFFFFFFFu : ((1u << n) - 1);
+}
+
+uint32_t tileHash(const uint8_t *data, size_t len)
+{
+	return fnv1a(data, len);
+}
+
+static const char B64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static size_t base64Encode(const uint8_t *in, size_t len, char *out, size_t cap)
+{
+	size_t need = ((len + 2) / 3) * 4;
+	if (need + 1 > cap)
+		return 0;
+
+	size_t o = 0;
+	for (size_t i = 0; i < len; i += 3)
+	{
+		uint32_t v = (uint32_t)in[i] << 16;
+		if (i + 1 < len)
+			v |= (uint32_t)in[i + 1] << 8;
+		if (i + 2 < len)
+			v |= in[i + 2];
+
+		out[o++] = B64[(v >> 18) & 63];
+		out[o++] = B64[(v >> 12) & 63];
+		out[o++] = (i + 1 < len) ? B64[(v >> 6) & 63] : '=';
+		out[o++] = (i + 2 < len) ? B64[v & 63] : '=';
+	}
+	out[o] = '\0';
+	return o;
+}
+
+size_t buildTileManifest(const uint8_t *frame, const TileGeometry &geo, char *out, size_t cap)
+{
+	const int n = geo.bandCount();
+	if (n > TILE_MAX_BANDS)
+		return 0;
+
+	uint8_t raw[TILE_MAX_BANDS * 4];
+	for (int b = 0; b < n; b++)
+	{
+		uint32_t h = tileHash(frame + geo.bandOffset(b), geo.bandBytes(b));
+		raw[b * 4 + 0] = (uint8_t)h;
+		raw[b * 4 + 1] = (uint8_t)(h >> 8);
+		raw[b * 4 + 2] = (uint8_t)(h >> 16);
+		raw[b * 4 + 3] = (uint8_t)(h >> 24);
+	}
+
+	int prefix = snprintf(out, cap, "v1;rows=%d;", TILE_ROWS);
+	if (prefix <= 0 || (size_t)prefix >= cap)
+		return 0;
+
+	size_t b64 = base64Encode(raw, (size_t)n * 4, out + prefix, cap - (size_t)prefix);
+	return b64 ? (size_t)prefix + b64 : 0;
+}
+
+void TileDeltaParser::begin(uint8_t *frame, const TileGeometry &geo)
+{
+	_frame = frame;
+	_geo = geo;
+	_headerGot = 0;
+	_headerDone = false;
+	_tileCount = 0;
+	_tilesDone = 0;
+	_band = -1;
+	_tileGot = 0;
+	_changed = 0;
+	_failed = false;
+	_failReason = nullptr;
+}
+
+bool TileDeltaParser::fail(const char *reason)
+{
+	if (!_failed)
+	{
+		_failed = true;
+		_failReason = reason;
+		Serial.printf("[TILE] Callback abort: %s (tiles %u/%u)\n",
+					  reason, (unsigned)_tilesDone, (unsigned)_tileCount);
+	}
+	return false;
+}
+
+bool TileDeltaParser::onHeader()
+{
+	if (memcmp(_header, "TDL1", 4) != 0)
+		return fail("Bad magic (not TDL1)");
+
+	const int w = _header[4] | (_header[5] << 8);
+	const int h = _header[6] | (_header[7] << 8);
+	if (w != _geo.w || h != _geo.h)
+		return fail("Dimensions mismatch");
+	if (_header[8] != TILE_ROWS)
+		return fail("Tile rows mismatch");
+	if (_geo.bytesPerRow() > TILE_MAX_BYTES_PER_ROW || _geo.bandCount() > TILE_MAX_BANDS)
+		return fail("Frame too large for tile buffer");
+
+	_tileCount = _header[9];
+	_headerDone = true;
+	Serial.printf("[TILE] %u changed band(s) of %d\n", (unsigned)_tileCount, _geo.bandCount());
+	return true;
+}
+
+bool TileDeltaParser::feed(const uint8_t *data, size_t len)
+{
+	size_t i = 0;
+	while (i < len)
+	{
+		if (_failed)
+			return false;
+
+		if (!_headerDone)
+		{
+			_header[_headerGot++] = data[i++];
+			if (_headerGot == sizeof(_header) && !onHeader())
+				return false;
+			continue;
+		}
+
+		if (_tilesDone == _tileCount)
+			return fail("Trailing bytes after last tile");
+
+		if (_band < 0)
+		{
+			_band = data[i++];
+			_tileGot = 0;
+			if (_band >= _geo.bandCount())
+				return fail("Band index out of range");
+			continue;
+		}
+
+		// Bulk copy as much of this band as the chunk holds
+		const size_t need = _geo.bandBytes(_band) - _tileGot;
+		size_t n = len - i;
+		if (n > need)
+			n = need;
+		memcpy(_tile + _tileGot, data + i, n);
+		_tileGot += n;
+		i += n;
+
+		if (_tileGot == _geo.bandBytes(_band))
+		{
+			memcpy(_frame + _geo.bandOffset(_band), _tile, _tileGot);
+			_changed |= 1u << _band;
+			_tilesDone++;
+			_band = -1;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Tile-manifest delta protocol for 1-bpp frames.
+//
+// The frame is split into horizontal bands of TILE_ROWS rows x full width (the last band
+// may be shorter). The device sends one FNV-1a hash per band of the frame it retains:
+//
+//   X-Tile-Manifest: v1;rows=16;<base64 of uint32 LE hashes, band 0..n-1>
+//
+// The server answers either with a full P4 PBM, or with a tile-delta container
+// (Content-Type: application/x-tile-delta) carrying only the bands that differ:
+//
+//   "TDL1" u16le width, u16le height, u8 tileRows, u8 tileCount
+//   tileCount x { u8 bandIndex, bytesPerRow * rowsInBand bitmap bytes (P4 layout) }
+//
+// tileCount == 0 means "unchanged".
+
+static constexpr int TILE_ROWS = 16;
+static constexpr int TILE_MAX_BYTES_PER_ROW = 100; // up to 800 px wide panels
+static constexpr int TILE_MAX_BANDS = 32;		   // changed-band mask is a uint32_t
+
+struct TileGeometry
+{
+	int w;
+	int h;
+
+	int bytesPerRow() const { return (w + 7) / 8; }
+	int bandCount() const { return (h + TILE_ROWS - 1) / TILE_ROWS; }
+	int bandRows(int band) const;
+	size_t bandOffset(int band) const { return (size_t)band * TILE_ROWS * bytesPerRow(); }
+	size_t bandBytes(int band) const { return (size_t)bandRows(band) * bytesPerRow(); }
+	uint32_t allBandsMask() const;
+};
+
+uint32_t tileHash(const uint8_t *data, size_t len);
+
+// Writes the X-Tile-Manifest header value for frame into out. Returns length, 0 if it doesn't fit.
+size_t buildTileManifest(const uint8_t *frame, const TileGeometry &geo, char *out, size_t cap);
+
+// Streaming container parser. Each band is staged in a small buffer and copied into the
+// frame only when complete, so an interrupted body never leaves a half-written band.
+class TileDeltaParser
+{
+public:
+	static constexpr uint8_t MAGIC0 = 'T';
+
+	void begin(uint8_t *frame, const TileGeometry &geo);
+
+	bool feed(const uint8_t *data, size_t len); // false on malformed input
+	bool complete() const { return !_failed && _headerDone && _tilesDone == _tileCount; }
+
+	uint32_t changedMask() const { return _changed; }
+	const char *failReason() const { return _failReason; }
+
+private:
+	bool fail(const char *reason);
+	bool onHeader();
+
+private:
+	uint8_t *_frame = nullptr;
+	TileGeometry _geo = {0, 0};
+
+	uint8_t _header[10];
+	size_t _headerGot = 0;
+	bool _headerDone = false;
+	uint8_t _tileCount = 0;
+	uint8_t _tilesDone = 0;
+
+	int _band = -1; // -1: expecting band index byte
+	size_t _tileGot = 0;
+	uint8_t _tile[TILE_MAX_BYTES_PER_ROW * TILE_ROWS];
+
+	uint32_t _changed = 0;
+	bool _failed = false;
+	const char *_failReason = nullptr;
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+// Seconds on the RTC-backed system clock: keeps counting through deep sleep (not reset
+// like millis()). An NTP step forward only makes stored stamps look older.
+static inline uint32_t rtcNowSec()
+{
+	return (uint32_t)time(nullptr);
+}
@@ -0,0 +1,44 @@
+#include "WakeArena.h"
+
+void *WakeArena::alloc(size_t size, size_t align)
+{
+	size_t start = (_used + (align - 1)) & ~(align - 1);
+	if (start + size > CAPACITY)
+	{
+		_failures++;
+		Serial.printf("[ARENA] out of space: need %u, used %u/%u\n",
+					  (unsigned)size, (unsigned)_used, (unsigned)CAPACITY);
+		return nullptr;
+	}
+
+	_used = start + size;
+	if (_used > _highWater)
+		_highWater = _used;
+	return _buf + start;
+}
+
+char *WakeArena::strndup(const char *s, size_t n)
+{
+	if (!s)
+		return nullptr;
+
+	size_t len = strnlen(s, n);
+	char *p = (char *)alloc(len + 1, 1);
+	if (!p)
+		return nullptr;
+	memcpy(p, s, len);
+	p[len] = '\0';
+	return p;
+}
+
+void WakeArena::rewind(size_t mark)
+{
+	if (mark <= _used)
+		_used = mark;
+}
+
+WakeArena &wakeArena()
+{
+	static WakeArena arena;
+	return arena;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Bump allocator for one wake. Storage is a static block outside the heap, so URL
+// pieces, header lines and redirect targets never fragment the heap the TLS handshake
+// needs. Nothing is freed individually: callers take a mark() and rewind() to it when a
+// request is done; a wake ends in deep sleep, which discards everything.
+class WakeArena
+{
+public:
+	static constexpr size_t CAPACITY = 4096;
+
+	// nullptr when full (counted in failures()); callers must handle it.
+	void *alloc(size_t size, size_t align = 4);
+
+	// NUL-terminated copy of up to n chars of s
+	char *strndup(const char *s, size_t n);
+	char *strdup(const char *s) { return s ? strndup(s, strlen(s)) : nullptr; }
+
+	size_t mark() const { return _used; }
+	void rewind(size_t mark);
+
+	size_t used() const { return _used; }
+	size_t highWater() const { return _highWater; }
+	uint16_t failures() const { return _failures; }
+
+private:
+	alignas(8) uint8_t _buf[CAPACITY];
+	size_t _used = 0;
+	size_t _highWater = 0;
+	uint16_t _failures = 0;
+};
+
+// The arena shared by networking and parsing code for the current wake.
+WakeArena &wakeArena();
+
+// Rewinds the wake arena when leaving a scope.
+class ArenaScope
+{
+public:
+	ArenaScope() : _mark(wakeArena().mark()) {}
+	~ArenaScope() { wakeArena().rewind(_mark); }
+
+	ArenaScope(const ArenaScope &) = delete;
+	ArenaScope &operator=(const ArenaScope &) = delete;
+
+private:
+	size_t _mark;
+};
@@ -0,0 +1,130 @@
+#include "WakeInputs.h"
+#include "TimeUtil.h"
+
+#include "esp_sleep.h"
+#include <driver/rtc_io.h>
+
+// Button rate limit; zeroed on power-on.
+RTC_DATA_ATTR static uint32_t rtcLastButtonFetchSec = 0;
+RTC_DATA_ATTR static uint32_t rtcButtonWindowStartSec = 0;
+RTC_DATA_ATTR static uint8_t rtcButtonWindowCount = 0;
+
+static constexpr uint32_t WINDOW_SEC = 3600;
+
+WakeInputs::WakeInputs(int buttonPin, int chargerPin, uint32_t debounceMs, uint32_t minFetchIntervalSec, uint8_t maxFetchesPerHour)
+	: _buttonPin(buttonPin), _chargerPin(chargerPin), _debounceMs(debounceMs),
+	  _minIntervalSec(minFetchIntervalSec), _maxPerHour(maxFetchesPerHour) {}
+
+WakeSource WakeInputs::source() const
+{
+	switch (esp_sleep_get_wakeup_cause())
+	{
+	case ESP_SLEEP_WAKEUP_UNDEFINED:
+		return WakeSource::PowerOn;
+	case ESP_SLEEP_WAKEUP_TIMER:
+		return WakeSource::Timer;
+	case ESP_SLEEP_WAKEUP_EXT0:
+		return WakeSource::Button;
+	case ESP_SLEEP_WAKEUP_EXT1:
+		if (_chargerPin >= 0 && (esp_sleep_get_ext1_wakeup_status() & (1ULL << _chargerPin)))
+			return WakeSource::Charger;
+		return WakeSource::Other;
+	default:
+		return WakeSource::Other;
+	}
+}
+
+const char *WakeInputs::sourceName(WakeSource source)
+{
+	switch (source)
+	{
+	case WakeSource::PowerOn:
+		return "POWER-ON";
+	case WakeSource::Timer:
+		return "TIMER";
+	case WakeSource::Button:
+		return "BUTTON";
+	case WakeSource::Charger:
+		return "CHARGER";
+	default:
+		return "OTHER";
+	}
+}
+
+bool WakeInputs::allowButtonFetch()
+{
+	const uint32_t now = rtcNowSec();
+
+	// Clock stepped backwards (power-on, NTP): start over rather than block.
+	if (now < rtcLastButtonFetchSec || now < rtcButtonWindowStartSec)
+	{
+		rtcLastButtonFetchSec = 0;
+		rtcButtonWindowStartSec = 0;
+		rtcButtonWindowCount = 0;
+	}
+
+	if (rtcLastButtonFetchSec && (now - rtcLastButtonFetchSec) < _minIntervalSec)
+	{
+		Serial.printf("[BTN] rate limited: last fetch %u s ago (min %u s)\n",
+					  (unsigned)(now - rtcLastButtonFetchSec), (unsigned)_minIntervalSec);
+		return false;
+	}
+
+	if (rtcButtonWindowCount == 0 || (now - rtcButtonWindowStartSec) >= WINDOW_SEC)
+	{
+		rtcButtonWindowStartSec = now;
+		rtcButtonWindowCount = 0;
+	}
+	if (rtcButtonWindowCount >= _maxPerHour)
+	{
+		Serial.printf("[BTN] rate limited: %u fetch(es) this hour\n", (unsigned)rtcButtonWindowCount);
+		return false;
+	}
+
+	rtcButtonWindowCount++;
+	rtcLastButtonFetchSec = now;
+	return true;
+}
+
+bool WakeInputs::buttonReleased(uint32_t timeoutMs) const
+{
+	pinMode(_buttonPin, INPUT_PULLUP);
+
+	const uint32_t start = millis();
+	uint32_t highSince = millis();
+	while (millis() - start < timeoutMs)
+	{
+		if (digitalRead(_buttonPin) == LOW)
+			highSince = millis();
+		else if (millis() - highSince >= _debounceMs)
+			return true;
+		delay(2);
+	}
+	return false;
+}
+
+void WakeInputs::arm(uint32_t releaseTimeoutMs)
+{
+	if (_buttonPin >= 0)
+	{
+		if (buttonReleased(releaseTimeoutMs))
+		{
+			// ext0 keeps the RTC peripherals powered, so the RTC pull-up holds in deep sleep
+			rtc_gpio_pullup_en((gpio_num_t)_buttonPin);
+			rtc_gpio_pulldown_dis((gpio_num_t)_buttonPin);
+			esp_sleep_enable_ext0_wakeup((gpio_num_t)_buttonPin, 0);
+		}
+		else
+		{
+			Serial.println("[BTN] button held; wake disarmed for this cycle");
+		}
+	}
+
+	if (_chargerPin >= 0)
+	{
+		pinMode(_chargerPin, INPUT);
+		if (digitalRead(_chargerPin) == LOW)
+			esp_sleep_enable_ext1_wakeup(1ULL << _chargerPin, ESP_EXT1_WAKEUP_ANY_HIGH);
+		// else: already on external power; re-armed on the first wake after unplugging
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+
+enum class WakeSource : uint8_t
+{
+	PowerOn = 0, // reset / first boot
+	Timer = 1,	 // regular poll
+	Button = 2,	 // ext0: on-demand refresh
+	Charger = 3, // ext1: external power attached
+	Other = 4
+};
+
+// GPIO wake sources next to the sleep timer:
+//   ext0  refresh button, active low (RTC pull-up, button to GND)
+//   ext1  charger sense, active high (e.g. USB VBUS through a divider)
+// A pin of -1 disables that source. Both must be RTC-capable GPIOs.
+class WakeInputs
+{
+public:
+	// Button fetches are rate limited across deep sleeps (RTC memory): at most one per
+	// minFetchIntervalSec and maxFetchesPerHour per rolling hour.
+	WakeInputs(int buttonPin, int chargerPin,
+			   uint32_t debounceMs = 50, uint32_t minFetchIntervalSec = 30, uint8_t maxFetchesPerHour = 12);
+
+	WakeSource source() const;
+	static const char *sourceName(WakeSource source);
+
+	// true = this button press may use the network (and is counted); false = show the
+	// retained frame only.
+	bool allowButtonFetch();
+
+	// Arm ext0/ext1 for the next deep sleep. Waits (bounded) for the button to be released
+	// and stable for the debounce time, so a held or bouncing button doesn't re-wake us at once;
+	// a source whose level is already active is left disarmed for this cycle.
+	void arm(uint32_t releaseTimeoutMs = 3000);
+
+private:
+	bool buttonReleased(uint32_t timeoutMs) const;
+
+private:
+	int _buttonPin;
+	int _chargerPin;
+	uint32_t _debounceMs;
+	uint32_t _minIntervalSec;
+	uint8_t _maxPerHour;
+};
@@ -0,0 +1,123 @@
+#include "WakeLoop.h"
+
+static constexpr uint32_t WAIT_SLICE_MS = 10;
+
+int WakeLoop::add(const char *name, StepFn step, void *ctx)
+{
+	for (uint8_t i = 0; i < MAX_TASKS; i++)
+	{
+		Task &t = _tasks[i];
+		if (t.state == State::Pending)
+			continue;
+
+		t.name = name;
+		t.step = step;
+		t.ctx = ctx;
+		t.startMs = millis();
+		t.state = State::Pending;
+		return i;
+	}
+
+	Serial.printf("[LOOP] no slot for %s\n", name);
+	return -1;
+}
+
+WakeLoop::State WakeLoop::state(int id) const
+{
+	return (id >= 0 && id < MAX_TASKS) ? _tasks[id].state : State::Free;
+}
+
+void WakeLoop::setDeadline(uint32_t msFromNow)
+{
+	_hasDeadline = msFromNow > 0;
+	_deadlineAt = millis() + msFromNow;
+}
+
+uint32_t WakeLoop::remainingMs() const
+{
+	if (!_hasDeadline)
+		return UINT32_MAX;
+	const int32_t left = (int32_t)(_deadlineAt - millis());
+	return left > 0 ? (uint32_t)left : 0;
+}
+
+uint32_t WakeLoop::clamp(uint32_t timeoutMs) const
+{
+	if (!_hasDeadline)
+		return timeoutMs;
+	uint32_t left = remainingMs();
+	if (left == 0)
+		left = 1; // callers read 0 as "no limit"
+	return (timeoutMs && timeoutMs < left) ? timeoutMs : left;
+}
+
+void WakeLoop::finish(uint8_t i, State s)
+{
+	Task &t = _tasks[i];
+	t.state = s;
+	Serial.printf("[LOOP] %s %s after %u ms\n", t.name, s == State::Done ? "done" : "failed",
+				  (unsigned)(millis() - t.startMs));
+}
+
+void WakeLoop::poll()
+{
+	if (_polling)
+		return;
+	_polling = true;
+
+	const bool late = _hasDeadline && remainingMs() == 0;
+	for (uint8_t i = 0; i < MAX_TASKS; i++)
+	{
+		if (_tasks[i].state != State::Pending)
+			continue;
+
+		const State s = late ? State::Failed : _tasks[i].step(_tasks[i].ctx);
+		if (s != State::Pending)
+			finish(i, s);
+	}
+
+	_polling = false;
+}
+
+void WakeLoop::wait(uint32_t ms)
+{
+	const uint32_t start = millis();
+	do
+	{
+		poll();
+		const uint32_t spent = millis() - start;
+		const uint32_t left = ms > spent ? ms - spent : 0;
+		delay(left < WAIT_SLICE_MS ? left : WAIT_SLICE_MS);
+	} while ((millis() - start) < ms);
+	yield();
+}
+
+bool WakeLoop::runUntil(int id, uint32_t timeoutMs)
+{
+	const uint32_t start = millis();
+	timeoutMs = clamp(timeoutMs);
+
+	poll();
+	while (state(id) == State::Pending && (!timeoutMs || (millis() - start) < timeoutMs))
+		wait(WAIT_SLICE_MS);
+
+	return state(id) == State::Done;
+}
+
+void WakeLoop::abandon()
+{
+	for (uint8_t i = 0; i < MAX_TASKS; i++)
+	{
+		Task &t = _tasks[i];
+		if (t.state != State::Pending)
+			continue;
+		t.state = State::Failed;
+		Serial.printf("[LOOP] %s abandoned after %u ms\n", t.name, (unsigned)(millis() - t.startMs));
+	}
+}
+
+WakeLoop &wakeLoop()
+{
+	static WakeLoop loop;
+	return loop;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Cooperative, single-threaded task loop for one wake. The slow part of SNTP and DNS
+// happens in lwIP's tcpip thread; what the wake task has to do is start them, notice
+// completion and act on it (store the address, log, give up at the deadline). Each such
+// job is a resumable step function polled here. The HTTP fetch keeps its blocking code
+// and pumps the loop wherever it used to delay(), so the waits overlap instead of adding
+// up. One deadline covers the wake: tasks still pending at it are failed.
+//
+//   [LOOP] ntp done after 412 ms
+class WakeLoop
+{
+public:
+	static constexpr uint8_t MAX_TASKS = 6;
+
+	enum class State : uint8_t
+	{
+		Free,
+		Pending,
+		Done,
+		Failed,
+	};
+
+	// Called on every poll until it returns something other than Pending.
+	using StepFn = State (*)(void *ctx);
+
+	// Task id, or -1 when the table is full (run the work inline instead). name and ctx
+	// must outlive the task.
+	int add(const char *name, StepFn step, void *ctx);
+	State state(int id) const;
+
+	// Wake deadline, relative to now; 0 = none.
+	void setDeadline(uint32_t msFromNow);
+	uint32_t remainingMs() const; // UINT32_MAX without a deadline
+	uint32_t clamp(uint32_t timeoutMs) const; // timeoutMs (0 = none), capped by the deadline
+
+	// One step of every pending task.
+	void poll();
+
+	// delay() replacement for wait loops: keeps the tasks moving while ms pass.
+	void wait(uint32_t ms);
+
+	// Pumps until the task leaves Pending, timeoutMs (0 = none) passes or the deadline.
+	// True if Done.
+	bool runUntil(int id, uint32_t timeoutMs);
+
+	// Fails whatever is still pending (logged); call before deep sleep.
+	void abandon();
+
+private:
+	void finish(uint8_t i, State s);
+
+	struct Task
+	{
+		const char *name;
+		StepFn step;
+		void *ctx;
+		uint32_t startMs;
+		State state;
+	};
+
+	Task _tasks[MAX_TASKS] = {};
+	uint32_t _deadlineAt = 0;
+	bool _hasDeadline = false;
+	bool _polling = false; // a step that waits must not re-enter poll()
+};
+
+// The loop shared by networking code for the current wake.
+WakeLoop &wakeLoop();
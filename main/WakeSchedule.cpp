@@ -0,0 +1,75 @@
+#include "WakeSchedule.h"
+#include <sys/time.h>
+
+// MAC hash (0 = not derived yet) and jitter generator state; re-derived on power-on.
+RTC_DATA_ATTR static uint32_t rtcDeviceHash = 0;
+RTC_DATA_ATTR static uint32_t rtcJitterState = 0;
+
+static constexpr uint64_t US_PER_SEC = 1000000ULL;
+
+// splitmix64 finalizer: neighbouring MACs (one batch) land far apart
+static uint32_t hashMac(uint64_t mac)
+{
+	uint64_t z = mac + 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	z ^= z >> 31;
+	return (uint32_t)z ? (uint32_t)z : 1;
+}
+
+// xorshift32
+static uint32_t nextJitter()
+{
+	uint32_t x = rtcJitterState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	rtcJitterState = x;
+	return x;
+}
+
+WakeSchedule::WakeSchedule(bool spread, uint8_t jitterPct)
+	: _spread(spread), _jitterPct(jitterPct > 25 ? 25 : jitterPct) {}
+
+uint64_t WakeSchedule::sleepUs(uint32_t periodSec)
+{
+	if (periodSec == 0 || (!_spread && _jitterPct == 0))
+		return (uint64_t)periodSec * US_PER_SEC;
+
+	if (rtcDeviceHash == 0)
+	{
+		rtcDeviceHash = hashMac(ESP.getEfuseMac());
+		rtcJitterState = rtcDeviceHash;
+	}
+
+	const uint64_t periodUs = (uint64_t)periodSec * US_PER_SEC;
+	int64_t sleep = (int64_t)periodUs;
+	const uint32_t phaseSec = rtcDeviceHash % periodSec;
+
+	if (_spread)
+	{
+		struct timeval tv;
+		gettimeofday(&tv, nullptr);
+		const uint64_t nowUs = (uint64_t)tv.tv_sec * US_PER_SEC + (uint64_t)tv.tv_usec;
+
+		// Up to the next instant of our phase; a wake that came early (jitter, RTC drift)
+		// must not be followed by a short hop to the slot it just missed.
+		const uint64_t into = (nowUs % periodUs + periodUs - (uint64_t)phaseSec * US_PER_SEC) % periodUs;
+		sleep = (int64_t)(periodUs - into);
+		if (sleep < (int64_t)(periodUs / 2))
+			sleep += (int64_t)periodUs;
+	}
+
+	int32_t jitterSec = 0;
+	const uint32_t spanSec = periodSec * _jitterPct / 100;
+	if (spanSec)
+		jitterSec = (int32_t)(nextJitter() % (2 * spanSec + 1)) - (int32_t)spanSec;
+	sleep += (int64_t)jitterSec * (int64_t)US_PER_SEC;
+	if (sleep < (int64_t)US_PER_SEC)
+		sleep = US_PER_SEC;
+
+	Serial.printf("[SLEEP] phase %u of %u s, jitter %+d s -> %llu s\n",
+				  _spread ? (unsigned)phaseSec : 0u, (unsigned)periodSec, (int)jitterSec,
+				  (unsigned long long)(sleep / US_PER_SEC));
+	return (uint64_t)sleep;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Timer-wake spacing for a fleet. With one fixed interval, units powered on together (a
+// power cut, a batch flashed on the bench) stay in step and reach the server in the same
+// second. Instead:
+//   - each unit wakes at its own phase of the interval, a hash of its MAC, on the RTC clock
+//     (keeps counting through deep sleep; wall time once NTP has run), so the fleet spreads
+//     evenly over the interval whenever its units were powered on;
+//   - each wake moves by up to +-jitterPct of the interval, from a MAC-seeded generator in
+//     RTC memory, so two units whose phases happen to be close don't meet every time.
+// Both are deterministic per device. The first sleep after power-on is 0.5 to 1.5 intervals.
+//
+//   [SLEEP] phase 347 of 600 s, jitter -12 s -> 281 s
+class WakeSchedule
+{
+public:
+	// spread = false, jitterPct = 0: every sleep is the plain interval
+	WakeSchedule(bool spread, uint8_t jitterPct);
+
+	// Deep-sleep length for an interval of periodSec, counted from now.
+	uint64_t sleepUs(uint32_t periodSec);
+
+private:
+	bool _spread;
+	uint8_t _jitterPct;
+};
@@ -0,0 +1,63 @@
+#include "WakeTrace.h"
+#include "WakeArena.h"
+
+#include <esp_heap_caps.h>
+
+// Holds the previous wake until wakeTraceBegin(); zeroed on power-on.
+RTC_DATA_ATTR static WakeRecord rtcWake;
+
+static void logRecord(const char *label, const WakeRecord &r)
+{
+	Serial.printf("[WAKE] #%u %s: %u phase(s), arena hi=%u fail=%u\n",
+				  (unsigned)r.wakeCount, label, (unsigned)r.phaseCount,
+				  (unsigned)r.arenaHighWater, (unsigned)r.arenaFailures);
+	for (uint8_t i = 0; i < r.phaseCount && i < WAKE_TRACE_MAX_PHASES; i++)
+	{
+		const WakePhase &p = r.phases[i];
+		Serial.printf("[WAKE]   %-7s %6u ms free=%u big=%u min=%u\n",
+					  p.name, (unsigned)p.ms, (unsigned)p.freeHeap,
+					  (unsigned)p.largestFree, (unsigned)p.minFree);
+	}
+}
+
+void wakeTraceBegin()
+{
+	const uint32_t count = rtcWake.wakeCount;
+	if (count)
+		logRecord("prev", rtcWake);
+
+	memset(&rtcWake, 0, sizeof(rtcWake));
+	rtcWake.wakeCount = count + 1;
+	wakeTraceMark("boot");
+}
+
+void wakeTraceMark(const char *phase)
+{
+	WakeRecord &r = rtcWake;
+	// Last slot is overwritten rather than dropping the latest boundary
+	uint8_t i = (r.phaseCount < WAKE_TRACE_MAX_PHASES) ? r.phaseCount++ : (uint8_t)(WAKE_TRACE_MAX_PHASES - 1);
+
+	WakePhase &p = r.phases[i];
+	strncpy(p.name, phase ? phase : "?", sizeof(p.name) - 1);
+	p.name[sizeof(p.name) - 1] = '\0';
+	p.ms = millis();
+	p.freeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+	p.largestFree = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+	p.minFree = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+
+	Serial.printf("[WAKE] %-7s free=%u big=%u min=%u arena=%u\n",
+				  p.name, (unsigned)p.freeHeap, (unsigned)p.largestFree,
+				  (unsigned)p.minFree, (unsigned)wakeArena().used());
+}
+
+void wakeTraceEnd()
+{
+	wakeTraceMark("sleep");
+	rtcWake.arenaHighWater = (uint16_t)wakeArena().highWater();
+	rtcWake.arenaFailures = wakeArena().failures();
+}
+
+const WakeRecord &wakeTraceCurrent()
+{
+	return rtcWake;
+}
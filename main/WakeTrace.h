@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Heap watermarks per wake phase, kept in RTC memory with the wake record so the
+// previous wake can be inspected after a failed (or crashed) TLS handshake.
+//
+//   [WAKE] #42 prev: boot free=231k big=110k min=229k | tls ... | arena hi=812 fail=0
+
+static constexpr size_t WAKE_TRACE_MAX_PHASES = 12;
+
+struct WakePhase
+{
+	char name[8];
+	uint32_t ms;		  // millis() at the mark
+	uint32_t freeHeap;	  // bytes free (8-bit capable heap)
+	uint32_t largestFree; // largest allocatable block: what a TLS record buffer needs
+	uint32_t minFree;	  // lowest free heap seen since boot
+};
+
+struct WakeRecord
+{
+	uint32_t wakeCount;
+	uint8_t phaseCount;
+	uint16_t arenaHighWater;
+	uint16_t arenaFailures;
+	WakePhase phases[WAKE_TRACE_MAX_PHASES];
+};
+
+// Logs the previous wake's record, then starts a new one (call first thing in setup()).
+void wakeTraceBegin();
+
+// Records heap state at a phase boundary (name is truncated to 7 chars).
+void wakeTraceMark(const char *phase);
+
+// Copies arena statistics into the record; call before deep sleep.
+void wakeTraceEnd();
+
+const WakeRecord &wakeTraceCurrent();
@@ -10,17 +10,102 @@
 #include "DisplayDrawer.h"
 #include "AppNetworkManager.h"
 #include "ItemsClient.h"
+#include "BatteryMonitor.h"
+#include "FrameStore.h"
+#include "TileDelta.h"
+#include "Hash.h"
+#include "WakeTrace.h"
+#include "WakeLoop.h"
+#include "StandbyChannel.h"
+#include "WakeInputs.h"
+#include "OtaUpdater.h"
+#include "WakeSchedule.h"
+#include "RefreshPolicy.h"
 
 // ==================== CONFIG ====================
 
 static const char *WIFI_SSID = "";
 static const char *WIFI_PASS = "";
-static const char *ITEMS_URL = "http://raspberrypi4.local:3001/list/items.pbm";
+// Same PBM from every endpoint; tried fastest-first (ranking kept in RTC memory)
+static const char *const ITEMS_URLS[] = {
+	"http://raspberrypi4.local:3001/list/items.pbm",
+	// "https://<subdomain>.ngrok-free.app/list/items.pbm",
+};
+
+// Let the server send the list itself (a few hundred bytes, drawn on the device from the
+// glyph atlas, see ItemList.h) instead of the 15 KB bitmap. Servers without it send a P4.
+static constexpr bool ITEM_LIST_CONTENT = true;
+
+// https endpoints only. Psk (per-device key, shared with our server) is the cheapest
+// handshake and authenticates both ends; PinnedCa wants an ECDSA P-256 chain.
+static TlsProfile TLS_PROFILE = TlsProfile::Insecure;
+static const char *TLS_CA_PEM = nullptr;
+static const char *TLS_PSK_IDENTITY = "eink-01";
+static const char *TLS_PSK_HEX = ""; // 16..32 bytes as hex
+
+// Delta firmware updates (OtaUpdater.h; tools/list_server.py --ota DIR), opt-in. The URL
+// must be https with TLS_PROFILE PinnedCa or Psk: the delta's SHA-256 catches damage, not
+// a forged image. Checked on power-on and then every OTA_CHECK_EVERY_WAKES fetches; a
+// started download continues on every wake until done. nullptr = off.
+static const char *OTA_URL = nullptr; // e.g. "https://raspberrypi4.local:3443/ota/delta"
+static constexpr uint16_t OTA_CHECK_EVERY_WAKES = 144; // about a day at 10 min
+static constexpr uint32_t OTA_TIMEOUT_MS = 20000;
+
+// One deadline for association, DNS, NTP and the fetch (they overlap on the wake loop)
+static constexpr uint32_t NET_DEADLINE_MS = 30000;
 
 static constexpr uint64_t SLEEP_MINUTES = 10;
 static constexpr uint64_t uS_TO_S_FACTOR = 1000000ULL;
 static constexpr uint64_t SLEEP_DURATION_US = SLEEP_MINUTES * 60ULL * uS_TO_S_FACTOR;
 
+// Fleet spreading (WakeSchedule.h): timer wakes land on a MAC-derived phase of the interval,
+// moved by up to +-SLEEP_JITTER_PCT of it, so units powered on together don't all reach the
+// server in the same second. false / 0 = plain interval sleeps.
+static constexpr bool SLEEP_PHASE_SPREAD = true;
+static constexpr uint8_t SLEEP_JITTER_PCT = 3;
+
+// Connected standby (USB-powered boards): after the boot fetch, stay associated in modem
+// sleep and refresh as soon as the notifier pings (tools/notify.py); the regular poll
+// still runs every policy.sleepMinutes. Normal battery tier only.
+static constexpr bool STANDBY_ENABLED = false;
+static const char *NOTIFY_HOST = "raspberrypi4.local";
+static constexpr uint16_t NOTIFY_PORT = 3002;		   // notifier (SUB1 datagrams go here)
+static constexpr uint16_t STANDBY_LISTEN_PORT = 3003; // NOTIFY1 datagrams arrive here
+static constexpr uint32_t STANDBY_MAX_MINUTES = 240;  // then a short deep sleep: battery check, fresh association
+
+// Wake inputs (RTC GPIOs; -1 = unused). The button shows the retained frame at once and
+// fetches fresh data; button fetches are rate limited across sleeps.
+#define BUTTON_PIN 33		// ext0, momentary to GND
+#define CHARGER_SENSE_PIN -1 // ext1, high while USB power is present (e.g. VBUS divider on GPIO 34)
+static constexpr uint32_t BUTTON_DEBOUNCE_MS = 50;
+static constexpr uint32_t BUTTON_MIN_FETCH_INTERVAL_SEC = 30;
+static constexpr uint8_t BUTTON_MAX_FETCHES_PER_HOUR = 12;
+
+// Battery sense: Li-Po+ -> 100k -> BAT_ADC_PIN -> 100k -> GND (taken before the TP4056 load switch / Pololu)
+// Must be an ADC1 pin: ADC2 is unusable while WiFi is on. -1 = no divider fitted; a pin
+// that reads below BatteryMonitor::MIN_PLAUSIBLE_MV is treated the same (Normal tier).
+#define BAT_ADC_PIN 35
+static constexpr float BAT_DIVIDER_RATIO = 2.0f;
+static constexpr float BAT_CAL_SCALE = 1.0f;   // multimeter / reported, per board
+static constexpr int BAT_CAL_OFFSET_MV = 0;	   // additive correction after scaling
+static constexpr uint8_t BAT_SAMPLES = 16;
+
+struct PowerPolicy
+{
+	uint64_t sleepMinutes;
+	bool syncTime;		// NTP alongside the fetch (timestamps only)
+	bool statusScreens; // "Loading..." / failure screens (each is a full refresh)
+	bool fetch;			// bring the radio up at all
+};
+
+// Index = BatteryTier
+static const PowerPolicy POWER_POLICY[] = {
+	/* NORMAL   */ {SLEEP_MINUTES, true, true, true},
+	/* LOW      */ {30, false, false, true},
+	/* CRITICAL */ {60, false, false, true},
+	/* DORMANT  */ {360, false, false, false}, // voltage re-check only (e.g. after charging)
+};
+
 // Waveshare ESP32 e-Paper Driver Board pins
 #define EPD_SCK 13
 #define EPD_MOSI 14
@@ -30,7 +115,26 @@ static constexpr uint64_t SLEEP_DURATION_US = SLEEP_MINUTES * 60ULL * uS_TO_S_FA
 #define EPD_RST 26
 #define EPD_BUSY 25
 
-static uint8_t pbmBuf[15000]; // 400x300 => ((400+7)/8)*300 = 15000
+// Panel variant is chosen at build time (-DPANEL_VARIANT=29|42|75, see PanelTraits.h)
+using Panel = ActivePanel;
+
+// -DFRAME_GRAY=1: two bit planes (P5 gray or P4); 4-gray panels refresh with gray levels
+static FrameBuffer<Panel, FRAME_GRAY ? 2 : 1> frameBuf;
+
+// Refresh waveforms (RefreshPolicy.h): partial for small edits, the fast full waveform for
+// bigger ones on panels that have it, and a normal full refresh after power-on, outside the
+// fast waveform's temperature range and every RefreshPolicy::MAX_UNCLEAN updates.
+// false = normal full refreshes instead of fast ones.
+static constexpr bool FAST_FULL_REFRESH = true;
+static constexpr int8_t PANEL_TEMP_OFFSET_C = 10; // ESP32 die minus room temperature at wake, per board
+static constexpr int FRAME_BANDS = (Panel::HEIGHT + TILE_ROWS - 1) / TILE_ROWS;
+
+// Survive deep sleep; reset on power-on
+RTC_DATA_ATTR static uint8_t rtcBatteryTier = (uint8_t)BatteryTier::Normal;
+RTC_DATA_ATTR static bool rtcLowBatteryFrameShown = false;
+RTC_DATA_ATTR static bool rtcPanelShowsFrame = false; // panel == FrameStore frame (not a status screen)
+RTC_DATA_ATTR static uint32_t rtcStatusHash = 0;
+RTC_DATA_ATTR static bool rtcNoBatterySenseLogged = false;	   // status screen on the panel when !rtcPanelShowsFrame
 
 static void printWakeReason()
 {
@@ -41,6 +145,12 @@ static void printWakeReason()
 	case ESP_SLEEP_WAKEUP_TIMER:
 		Serial.println("TIMER");
 		break;
+	case ESP_SLEEP_WAKEUP_EXT0:
+		Serial.println("EXT0 (button)");
+		break;
+	case ESP_SLEEP_WAKEUP_EXT1:
+		Serial.printf("EXT1 (mask=0x%llx)\n", (unsigned long long)esp_sleep_get_ext1_wakeup_status());
+		break;
 	case ESP_SLEEP_WAKEUP_UNDEFINED:
 		Serial.println("UNDEFINED (power-on/reset)");
 		break;
@@ -50,21 +160,6 @@ static void printWakeReason()
 	}
 }
 
-static bool syncTimeUtc(uint32_t timeoutMs = 5000)
-{
-	configTime(0, 0, "pool.ntp.org", "time.nist.gov"); // SNTP: returns UTC epoch; we will format with gmtime_r()
-
-	const uint32_t start = millis();
-	while (millis() - start < timeoutMs)
-	{
-		time_t now = time(nullptr);
-		if (now > 1700000000) // sanity: ~2023-11+
-			return true;
-		delay(100);
-	}
-	return false;
-}
-
 static String nowStringUtc()
 {
 	time_t now = time(nullptr);
@@ -83,14 +178,17 @@ class App
 {
 public:
 	App()
-		: display(GxEPD2_420_GDEY042T81(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY)),
+		: display(Panel::DriverType(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY)),
 		  drawer(display,
-				 EPD_SCK, EPD_MISO, EPD_MOSI, EPD_CS,
-				 /*preferredRotation*/ 1,
-				 /*targetW*/ 400,
-				 /*targetH*/ 300),
+				 EPD_SCK, EPD_MISO, EPD_MOSI, EPD_CS),
 		  net(WIFI_SSID, WIFI_PASS),
-		  itemsClient(net, ITEMS_URL)
+		  itemsClient(net, ITEMS_URLS, sizeof(ITEMS_URLS) / sizeof(ITEMS_URLS[0]), &frameStore),
+		  battery(BAT_ADC_PIN, BAT_DIVIDER_RATIO, BAT_CAL_SCALE, BAT_CAL_OFFSET_MV),
+		  wakeInputs(BUTTON_PIN, CHARGER_SENSE_PIN,
+					 BUTTON_DEBOUNCE_MS, BUTTON_MIN_FETCH_INTERVAL_SEC, BUTTON_MAX_FETCHES_PER_HOUR),
+		  ota(net),
+		  schedule(SLEEP_PHASE_SPREAD, SLEEP_JITTER_PCT),
+		  refresh(FAST_FULL_REFRESH && Panel::FAST_FULL, PANEL_TEMP_OFFSET_C)
 	{
 	}
 
@@ -100,12 +198,35 @@ public:
 		delay(300);
 
 		printWakeReason();
+		wakeTraceBegin();
+		ota.begin(); // may roll a failed update back (and restart)
 
-		drawer.begin(115200);
+		readBattery(); // before the radio comes on
+		refresh.begin(); // die temperature, before the radio warms it
+
+		if (tier == BatteryTier::Dormant)
+		{
+			dormantFlow();
+			goToSleep();
+			return;
+		}
+
+		drawer.begin(115200, /*initial*/ !rtcPanelShowsFrame);
 
-		net.setInsecureHttps(true); // TLS policy: insecure by choice
+		TlsConfig tls;
+		tls.profile = TLS_PROFILE;
+		tls.caPem = TLS_CA_PEM;
+		tls.pskIdentity = TLS_PSK_IDENTITY;
+		tls.pskHex = TLS_PSK_HEX;
+		net.setTlsConfig(tls);
+		itemsClient.setItemListEnabled(ITEM_LIST_CONTENT);
 
-		bootFlow();
+		// Timer, charger and power-on wakes share the regular flow (the battery tier is
+		// re-evaluated above on every wake); the button has its own low-latency path.
+		if (wakeInputs.source() == WakeSource::Button)
+			buttonFlow();
+		else
+			bootFlow();
 
 		goToSleep(); // Always go to sleep after the one-shot flow
 	}
@@ -116,46 +237,245 @@ public:
 	}
 
 private:
+	void readBattery()
+	{
+		battery.begin();
+		const uint32_t mv = battery.sampleMilliVolts(BAT_SAMPLES);
+		if (mv < BatteryMonitor::MIN_PLAUSIBLE_MV)
+		{
+			// No sense wired (older boards): run as on a full battery rather than go Dormant
+			if (!rtcNoBatterySenseLogged)
+				Serial.printf("[BAT] no battery sense (%u mV); tiers off\n", (unsigned)mv);
+			rtcNoBatterySenseLogged = true;
+			tier = BatteryTier::Normal;
+			rtcBatteryTier = (uint8_t)tier;
+			policy = POWER_POLICY[(uint8_t)tier];
+			rtcLowBatteryFrameShown = false;
+			return;
+		}
+		rtcNoBatterySenseLogged = false;
+		const uint8_t pct = BatteryMonitor::percentFromMilliVolts(mv);
+
+		tier = BatteryMonitor::tierFor(pct, (BatteryTier)rtcBatteryTier);
+		rtcBatteryTier = (uint8_t)tier;
+		policy = POWER_POLICY[(uint8_t)tier];
+
+		if (tier != BatteryTier::Dormant)
+			rtcLowBatteryFrameShown = false; // re-arm for the next discharge
+
+		Serial.printf("[BAT] %u mV (%u%%) tier=%s sleep=%llu min\n",
+					  (unsigned)mv, (unsigned)pct, BatteryMonitor::tierName(tier),
+					  (unsigned long long)policy.sleepMinutes);
+	}
+
+	void dormantFlow()
+	{
+		if (rtcLowBatteryFrameShown)
+			return; // frame already on the panel; e-ink keeps it for free
+
+		drawer.begin(115200);
+		drawer.showStatus("Battery low", "Please charge");
+		refresh.record(RefreshMode::Full);
+		display.hibernate();
+		rtcLowBatteryFrameShown = true;
+		rtcPanelShowsFrame = false;
+		rtcStatusHash = 0;
+	}
+
+	// A repeated failure (e.g. the AP is off all night) doesn't redraw the same screen.
+	void showStatus(const char *line1, const char *line2)
+	{
+		if (!policy.statusScreens)
+			return;
+
+		const uint32_t hash = fnv1a((const uint8_t *)line1, strlen(line1)) ^
+							  (line2 ? fnv1a((const uint8_t *)line2, strlen(line2)) * 31u : 0);
+		if (!rtcPanelShowsFrame && hash == rtcStatusHash)
+		{
+			Serial.printf("[APP] \"%s\" already shown; no refresh\n", line1);
+			return;
+		}
+
+		const RefreshMode mode = refresh.choose(FRAME_BANDS, FRAME_BANDS, drawer.panelKnown());
+		drawer.showStatus(line1, line2, mode);
+		refresh.record(mode);
+		rtcPanelShowsFrame = false;
+		rtcStatusHash = hash;
+	}
+
 	void bootFlow()
 	{
-		drawer.showStatus("Loading...", nullptr);
+		// Retained frame = basis for the tile manifest; without one the first fetch is a full P4.
+		const bool haveFrame = frameStore.loadFrame(frameBuf.data, sizeof(frameBuf.data));
+		if (!haveFrame)
+			showStatus("Loading...", nullptr);
+
+		fetchFlow(haveFrame, policy.syncTime);
+	}
+
+	// On-demand refresh: put the retained frame back up immediately (the panel may show a
+	// status screen), then fetch and refresh only what changed. No NTP on this path.
+	void buttonFlow()
+	{
+		const bool haveFrame = frameStore.loadFrame(frameBuf.data, sizeof(frameBuf.data));
+		if (haveFrame && !rtcPanelShowsFrame)
+		{
+			drawFrame();
+			rtcPanelShowsFrame = true;
+			wakeTraceMark("draw");
+		}
+
+		if (!wakeInputs.allowButtonFetch())
+		{
+			display.hibernate();
+			return;
+		}
+
+		fetchFlow(haveFrame, false);
+	}
+
+	void fetchFlow(bool haveFrame, bool syncTime)
+	{
+		wakeLoop().setDeadline(NET_DEADLINE_MS);
+		net.setTimeSyncEnabled(syncTime); // false on the button path: no NTP wait before the fetch
+
 		// drawer.showStatus("WiFi", "Connecting...");
 		if (!net.connectWiFi(15000))
 		{
-			drawer.showStatus("WiFi FAILED", "Timeout");
+			WiFi.mode(WIFI_OFF); // radio off before the (slow) status refresh
+			showStatus("WiFi FAILED", "Timeout");
 			return;
 		}
+		wakeTraceMark("wifi");
 
-		// drawer.showStatus("TIME", "Syncing UTC..."); // Sync UTC time via NTP (optional but needed for timestamps)
-		const bool timeOk = syncTimeUtc(5000);
+		// NTP (started by connectWiFi) and endpoint lookups run while the fetch waits on
+		// the socket; only the failure screen's timestamp waits for the time.
+		net.prefetchDns(ITEMS_URLS, sizeof(ITEMS_URLS) / sizeof(ITEMS_URLS[0]));
 
-		String ip = WiFi.localIP().toString();
-		// drawer.showStatus("WiFi Connected", ip.c_str());
+		// drawer.showStatus("WiFi Connected", WiFi.localIP().toString().c_str());
 
 		// drawer.showStatus("HTTP", "Fetching PBM...");
-		if (!itemsClient.fetchPbmP4(pbmBuf, sizeof(pbmBuf), 400, 300, 15000))
+		if (!fetchAndShow(haveFrame))
 		{
+			ota.fetchFailed(); // counts against an image on trial (may roll back)
+			const bool timeOk = syncTime && net.syncTimeNtp(5000);
 			const String ts = timeOk ? nowStringUtc() : String("UTC unavailable");
-			drawer.showStatus("Fetching FAILED", ts.c_str());
+			showStatus("Fetching FAILED", ts.c_str());
 			return;
 		}
+		ota.confirm(); // an updated image that got a frame through is good
+
+		// After the frame, over the same connection; whatever the deadline leaves
+		if (OTA_URL && tier == BatteryTier::Normal)
+			otaStaged = ota.poll(OTA_URL, OTA_CHECK_EVERY_WAKES, OTA_TIMEOUT_MS);
+		if (otaStaged)
+			return; // restart into it instead of standby
 
-		// drawer.showStatus("Display", "Rendering...");
-		drawer.drawBitmap1bpp(pbmBuf, false);
+		if (STANDBY_ENABLED && tier == BatteryTier::Normal)
+			standbyFlow();
+	}
+
+	// Fetch (delta against frameBuf when haveFrame) and refresh what changed.
+	bool fetchAndShow(bool haveFrame)
+	{
+		uint32_t changedBands = 0;
+		if (!itemsClient.fetchFrame(frameBuf, haveFrame, &changedBands, 15000))
+			return false;
+		wakeTraceMark("fetch");
 
+		if (changedBands == 0 && rtcPanelShowsFrame)
+		{
+			Serial.println("[APP] Frame unchanged; no refresh");
+		}
+		else
+		{
+			if (changedBands)
+				frameStore.saveFrame(frameBuf.data, sizeof(frameBuf.data));
+
+			// drawer.showStatus("Display", "Rendering...");
+			if (rtcPanelShowsFrame && frameBuf.PLANES == 1)
+			{
+				const RefreshMode mode = refresh.choose(__builtin_popcount(changedBands), FRAME_BANDS,
+														drawer.panelKnown());
+				drawer.drawBitmapBands(frameBuf.data, changedBands, TILE_ROWS, mode);
+				refresh.record(mode);
+			}
+			else
+				drawFrame();
+			rtcPanelShowsFrame = true;
+		}
+
+		wakeTraceMark("draw");
 		display.hibernate(); // Put panel/controller into low power; image remains on e-ink
+		return true;
+	}
+
+	// Whole frame: a gray refresh is always a normal full one
+	void drawFrame()
+	{
+		if (frameBuf.PLANES == 2)
+		{
+			drawer.drawGray2bpp(frameBuf.data);
+			refresh.record(RefreshMode::Full);
+			return;
+		}
+
+		const RefreshMode mode = refresh.choose(FRAME_BANDS, FRAME_BANDS, drawer.panelKnown());
+		drawer.drawBitmap1bpp(frameBuf.data, false, mode);
+		refresh.record(mode);
+	}
+
+	// Stay on WiFi and fetch over the kept-alive connection on each notify (or poll interval).
+	void standbyFlow()
+	{
+		StandbyChannel channel(NOTIFY_HOST, NOTIFY_PORT, STANDBY_LISTEN_PORT);
+		if (!channel.begin())
+			return;
+
+		const uint32_t pollMs = (uint32_t)(policy.sleepMinutes * 60000ULL);
+		const uint32_t startMs = millis();
+		bool haveFrame = true; // frameBuf holds the frame on the panel
+
+		while ((millis() - startMs) < STANDBY_MAX_MINUTES * 60000UL)
+		{
+			const bool notified = channel.waitForNotify(pollMs);
+			if (WiFi.status() != WL_CONNECTED)
+				break;
+
+			const uint32_t t0 = millis();
+			wakeLoop().setDeadline(NET_DEADLINE_MS);
+			const bool ok = fetchAndShow(haveFrame);
+			// A failed fetch can leave new bands (part of a tile delta or P4) in frameBuf that
+			// were never drawn; the next manifest must describe the panel, not that mix.
+			haveFrame = ok || frameStore.loadFrame(frameBuf.data, sizeof(frameBuf.data));
+			Serial.printf("[STBY] %s -> fetch %s (%u ms)\n", notified ? "notify" : "poll",
+						  ok ? "ok" : "failed", (unsigned)(millis() - t0));
+		}
+
+		channel.end();
+		sleepOverrideSec = 1; // come straight back (battery check with the radio off)
 	}
 
 	void goToSleep()
 	{
+		wakeLoop().abandon();
+		net.closeConnection();
+		wakeTraceEnd();
 		WiFi.disconnect(true);
 		WiFi.mode(WIFI_OFF);
 
-		esp_sleep_enable_timer_wakeup(SLEEP_DURATION_US);
+		if (otaStaged)
+			ota.restart();
 
-		Serial.printf("[SLEEP] deep sleep for %llu minutes (%llu us)\n",
-					  (unsigned long long)SLEEP_MINUTES,
-					  (unsigned long long)SLEEP_DURATION_US);
+		wakeInputs.arm();
+
+		const uint64_t sleepUs = sleepOverrideSec ? sleepOverrideSec * uS_TO_S_FACTOR
+												  : schedule.sleepUs((uint32_t)(policy.sleepMinutes * 60));
+		esp_sleep_enable_timer_wakeup(sleepUs);
+
+		Serial.printf("[SLEEP] deep sleep for %llu s (%llu us)\n",
+					  (unsigned long long)(sleepUs / uS_TO_S_FACTOR),
+					  (unsigned long long)sleepUs);
 		Serial.flush();
 
 		esp_deep_sleep_start();
@@ -163,17 +483,33 @@ private:
 
 private:
 	// IMPORTANT: declaration order matters (constructed top → bottom)
-	GxEPD2_BW<GxEPD2_420_GDEY042T81,
-			  GxEPD2_420_GDEY042T81::HEIGHT>
-		display;
+	Panel::Display display;
 
-	DisplayDrawer drawer;
+	DisplayDrawer<Panel> drawer;
 	AppNetworkManager net;
+	FrameStore frameStore;
 	ItemsClient itemsClient;
+	BatteryMonitor battery;
+	WakeInputs wakeInputs;
+	OtaUpdater ota;
+	WakeSchedule schedule;
+	RefreshPolicy refresh;
+
+	BatteryTier tier = BatteryTier::Normal;
+	PowerPolicy policy = POWER_POLICY[0];
+	uint64_t sleepOverrideSec = 0; // non-zero replaces policy.sleepMinutes once
+	bool otaStaged = false;		   // restart into a new image instead of sleeping
 };
 
 static App app;
 
+// Arduino core (with app rollback in the bootloader): leave a freshly updated image pending
+// verification; OtaUpdater::confirm() marks it valid.
+extern "C" bool verifyRollbackLater()
+{
+	return true;
+}
+
 void setup()
 {
 	app.begin();
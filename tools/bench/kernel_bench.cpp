@@ -0,0 +1,656 @@
+// Micro-benchmarks for the CPU-bound kernels of the wake path, with allocation counts.
+//
+// The firmware sources are included here (one translation unit), so the file-local parsers
+// (parseUrl, readBody, onPbmBytes, the OTA delta applier) are measured as they ship, not
+// through copies. Each kernel runs on fixed synthetic input; its result is checked once and
+// then timed as the best of several repeats. Output is one line per kernel:
+//
+//   kernel            bytes       ns/B      cyc/B  allocs
+//   pbm.p4            15011      0.210          -       0
+//
+// bytes is what one pass consumes (wire bytes for the HTTP kernels, frame bytes for render
+// and rotate, image bytes for ota.apply). allocs counts heap allocations per pass: malloc
+// and friends on the host, the heap hooks on the ESP32 (-1 when CONFIG_HEAP_USE_HOOKS is
+// off). tools/bench/kernel_gate.py compares the lines against kernel_baseline.txt.
+//
+// Host (simulator stubs, portable SHA-256):
+//   g++ -O2 -std=gnu++17 -Itools/sim/include -Itools/sim -Imain tools/bench/kernel_bench.cpp tools/sim/SimCore.cpp tools/sim/SimLink.cpp -o /tmp/kernel_bench
+//   /tmp/kernel_bench [kernel-prefix]
+//
+// ESP32 (cycle counts from CCOUNT; results on the serial port, ota.apply is skipped):
+//   arduino-cli compile -b esp32:esp32:esp32 --build-property "compiler.cpp.extra_flags=-I$PWD/main -I$PWD/tools/bench" tools/bench/kernel_bench
+//   arduino-cli upload ... && arduino-cli monitor -c baudrate=115200 | tee /tmp/kernel_esp32.log
+
+#include "WakeArena.cpp"
+#include "WakeTrace.cpp"
+#include "WakeLoop.cpp"
+#include "RadioPolicy.cpp"
+#include "EndpointRanker.cpp"
+#include "Digest.cpp"
+#include "TileDelta.cpp"
+#include "ItemList.cpp"
+#include "BitRotate.cpp"
+#include "FrameStore.cpp"
+#include "AppNetworkManager.cpp"
+#include "ItemsClient.cpp"
+#include "OtaUpdater.cpp"
+
+#include <stdarg.h>
+#include <vector>
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#else
+#include "Sim.h"
+#include <chrono>
+#include <cstdio>
+#endif
+
+// ---------------- platform ----------------
+
+static volatile uint32_t gAllocs = 0;
+
+#if defined(ESP_PLATFORM)
+
+#if defined(CONFIG_HEAP_USE_HOOKS)
+static constexpr bool ALLOCS_COUNTED = true;
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void *, size_t, uint32_t) { gAllocs++; }
+#else
+static constexpr bool ALLOCS_COUNTED = false;
+#endif
+
+static constexpr uint32_t REPEAT_TICKS = 4000000; // cycles per timed repeat
+static constexpr int REPEATS = 5;
+static uint32_t ticks() { return ESP.getCycleCount(); }
+
+static void out(const char *fmt, ...)
+{
+	char line[160];
+	va_list ap;
+	va_start(ap, fmt);
+	vsnprintf(line, sizeof(line), fmt, ap);
+	va_end(ap);
+	Serial.print(line);
+}
+
+#else
+
+// glibc: the program's malloc overrides the library's, operator new included
+static constexpr bool ALLOCS_COUNTED = true;
+extern "C"
+{
+	void *__libc_malloc(size_t);
+	void *__libc_calloc(size_t, size_t);
+	void *__libc_realloc(void *, size_t);
+	void __libc_free(void *);
+
+	void *malloc(size_t n) noexcept
+	{
+		gAllocs++;
+		return __libc_malloc(n);
+	}
+	void *calloc(size_t k, size_t n) noexcept
+	{
+		gAllocs++;
+		return __libc_calloc(k, n);
+	}
+	void *realloc(void *p, size_t n) noexcept
+	{
+		gAllocs++;
+		return __libc_realloc(p, n);
+	}
+	void free(void *p) noexcept { __libc_free(p); }
+}
+
+static constexpr uint32_t REPEAT_TICKS = 10000000; // ns per timed repeat
+static constexpr int REPEATS = 15;
+static uint32_t ticks()
+{
+	using namespace std::chrono;
+	return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void out(const char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+}
+
+#endif
+
+// ---------------- inputs ----------------
+
+static constexpr int FRAME_W = 400; // 4.2" panel, native
+static constexpr int FRAME_H = 300;
+static constexpr size_t FRAME_BYTES = FRAME_W / 8 * FRAME_H;
+static constexpr size_t SEGMENT = 1460; // TCP payload per read, as on a LAN
+
+static std::vector<uint8_t> gInput;
+static std::vector<uint8_t> gBody;	 // P4 entity before framing
+static std::vector<uint8_t> gExpect; // what the kernel should produce
+static uint8_t gFrame[FRAME_BYTES * 2];
+static uint32_t gSeed;
+
+static uint8_t rnd()
+{
+	gSeed = gSeed * 1103515245u + 12345u;
+	return (uint8_t)(gSeed >> 16);
+}
+
+static void fill(uint8_t *p, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		p[i] = rnd();
+}
+
+static void append(std::vector<uint8_t> &v, const char *s) { v.insert(v.end(), s, s + strlen(s)); }
+
+// Response body bytes, delivered in SEGMENT-sized reads like a socket.
+class MemClient : public WiFiClient
+{
+public:
+	void load(const uint8_t *data, size_t len)
+	{
+		_data = data;
+		_len = len;
+		_pos = 0;
+	}
+
+	int available() override
+	{
+		const size_t seg = SEGMENT - _pos % SEGMENT;
+		return (int)(_len - _pos < seg ? _len - _pos : seg);
+	}
+	int read() override { return _pos < _len ? _data[_pos++] : -1; }
+	int read(uint8_t *buf, size_t size) override
+	{
+		const size_t n = size < (size_t)available() ? size : (size_t)available();
+		memcpy(buf, _data + _pos, n);
+		_pos += n;
+		return (int)n;
+	}
+	int peek() override { return _pos < _len ? _data[_pos] : -1; }
+	uint8_t connected() override { return _pos < _len; }
+	void stop() override {}
+
+private:
+	const uint8_t *_data = nullptr;
+	size_t _len = 0;
+	size_t _pos = 0;
+};
+
+static MemClient gClient;
+
+// Chunked framing as list_server.py sends it: 1 KB chunks, then the last-chunk and an empty trailer.
+static void chunk(std::vector<uint8_t> &wire, const uint8_t *body, size_t len)
+{
+	for (size_t off = 0; off < len; off += 1024)
+	{
+		const size_t n = len - off < 1024 ? len - off : 1024;
+		char size[12];
+		snprintf(size, sizeof(size), "%x\r\n", (unsigned)n);
+		append(wire, size);
+		wire.insert(wire.end(), body + off, body + off + n);
+		append(wire, "\r\n");
+	}
+	append(wire, "0\r\n\r\n");
+}
+
+static size_t p4Body(std::vector<uint8_t> &v)
+{
+	v.clear();
+	append(v, "P4\n# bench\n400 300\n");
+	const size_t head = v.size();
+	v.resize(head + FRAME_BYTES);
+	fill(v.data() + head, FRAME_BYTES);
+	gExpect.assign(v.begin() + head, v.end());
+	return v.size();
+}
+
+// ---------------- kernels ----------------
+
+static bool sumBytes(const uint8_t *data, size_t len, void *user)
+{
+	uint32_t &sum = *(uint32_t *)user;
+	for (size_t i = 0; i < len; i += 64)
+		sum += data[i];
+	sum += (uint32_t)len << 16;
+	return true;
+}
+
+struct UrlCase
+{
+	const char *url;
+	const char *host;
+	uint16_t port;
+};
+
+static const UrlCase URLS[] = {
+	{"http://raspberrypi4.local:3001/items.pbm", "raspberrypi4.local", 3001},
+	{"https://lists.example.com/v2/devices/kitchen/frame?w=400&h=300", "lists.example.com", 443},
+	{"http://192.168.1.20/items.pbm", "192.168.1.20", 80},
+	{"https://example.org:8443/", "example.org", 8443},
+	{"http://raspberrypi4.local:3001/ota/delta", "raspberrypi4.local", 3001},
+};
+
+static size_t prepUrls()
+{
+	size_t n = 0;
+	for (const UrlCase &u : URLS)
+		n += strlen(u.url);
+	return n;
+}
+
+static bool runUrls()
+{
+	ArenaScope scope;
+	for (const UrlCase &u : URLS)
+	{
+		const char *host;
+		const char *path;
+		uint16_t port;
+		if (!parseUrl(u.url, host, port, path) || port != u.port || strcmp(host, u.host) != 0 || path[0] != '/')
+			return false;
+	}
+	return true;
+}
+
+static size_t prepChunked()
+{
+	p4Body(gBody);
+	gInput.clear();
+	chunk(gInput, gBody.data(), gBody.size());
+	return gInput.size();
+}
+
+static size_t prepLength()
+{
+	return p4Body(gInput);
+}
+
+static bool runBody(bool chunked)
+{
+	ResponseHead head;
+	head.chunked = chunked;
+	HttpResponseInfo resp;
+	uint32_t sum = 0;
+	gClient.load(gInput.data(), gInput.size());
+	const int len = chunked ? -1 : (int)gInput.size();
+	return readBody(gClient, head, len, sumBytes, &sum, nullptr, millis(), 0, resp) && (sum >> 16) > 0;
+}
+
+static bool runChunked() { return runBody(true); }
+static bool runLength() { return runBody(false); }
+
+static size_t prepP4() { return p4Body(gInput); }
+
+static size_t prepP5()
+{
+	gInput.clear();
+	append(gInput, "P5\n400 300\n255\n");
+	const size_t head = gInput.size();
+	gInput.resize(head + (size_t)FRAME_W * FRAME_H);
+	fill(gInput.data() + head, (size_t)FRAME_W * FRAME_H);
+	return gInput.size();
+}
+
+static bool runPbm(uint8_t planes)
+{
+	PbmCtx ctx{};
+	ctx.expectedW = FRAME_W;
+	ctx.expectedH = FRAME_H;
+	ctx.dst = gFrame;
+	ctx.cap = sizeof(gFrame);
+	ctx.planes = planes;
+	for (size_t off = 0; off < gInput.size(); off += SEGMENT)
+	{
+		const size_t n = gInput.size() - off < SEGMENT ? gInput.size() - off : SEGMENT;
+		if (!onPbmBytes(gInput.data() + off, n, &ctx))
+			return false;
+	}
+	return ctx.got == ctx.bytesNeeded && (planes == 2 || memcmp(gFrame, gExpect.data(), FRAME_BYTES) == 0);
+}
+
+static bool runP4() { return runPbm(1); }
+static bool runP5() { return runPbm(2); }
+
+// The fetch path end to end, minus the socket: chunked framing, direct reads into the
+// frame through FRAME_SINK and the Content-Digest check.
+static ExpectedDigest gFrameDigest;
+
+static size_t prepFrame()
+{
+	const size_t n = prepChunked();
+	StreamDigest d;
+	d.begin(DigestAlgo::Sha256);
+	d.update(gBody.data(), gBody.size());
+	gFrameDigest.algo = DigestAlgo::Sha256;
+	d.finish(gFrameDigest.value);
+	return n;
+}
+
+static bool runFrame()
+{
+	StreamDigest digest;
+	HttpResponseInfo resp;
+	resp.httpCode = 200;
+	resp.digest = gFrameDigest;
+	ResponseHead head;
+	head.chunked = true;
+
+	PbmCtx ctx{};
+	ctx.expectedW = FRAME_W;
+	ctx.expectedH = FRAME_H;
+	ctx.dst = gFrame;
+	ctx.cap = FRAME_BYTES;
+	ctx.planes = 1;
+	ctx.resp = &resp;
+	ctx.digest = &digest;
+
+	gClient.load(gInput.data(), gInput.size());
+	return readBody(gClient, head, -1, onFrameBytes, &ctx, &FRAME_SINK, millis(), 0, resp) &&
+		   ctx.got == FRAME_BYTES && digest.matches(resp.digest) &&
+		   memcmp(gFrame, gExpect.data(), FRAME_BYTES) == 0;
+}
+
+static constexpr TileGeometry GEO = {FRAME_W, FRAME_H};
+static TileDeltaParser gTiles;
+
+// Every other band changed
+static size_t prepTiles()
+{
+	const uint8_t count = (uint8_t)((GEO.bandCount() + 1) / 2);
+	gInput.clear();
+	append(gInput, "TDL1");
+	const uint8_t head[] = {(uint8_t)FRAME_W, FRAME_W >> 8, (uint8_t)FRAME_H, FRAME_H >> 8, TILE_ROWS, count};
+	gInput.insert(gInput.end(), head, head + sizeof(head));
+	for (int b = 0; b < GEO.bandCount(); b += 2)
+	{
+		gInput.push_back((uint8_t)b);
+		const size_t at = gInput.size();
+		gInput.resize(at + GEO.bandBytes(b));
+		fill(gInput.data() + at, GEO.bandBytes(b));
+	}
+	return gInput.size();
+}
+
+static bool runTiles()
+{
+	gTiles.begin(gFrame, GEO);
+	for (size_t off = 0; off < gInput.size(); off += SEGMENT)
+	{
+		const size_t n = gInput.size() - off < SEGMENT ? gInput.size() - off : SEGMENT;
+		if (!gTiles.feed(gInput.data() + off, n))
+			return false;
+	}
+	return gTiles.complete();
+}
+
+static size_t prepManifest()
+{
+	fill(gFrame, FRAME_BYTES);
+	return FRAME_BYTES;
+}
+
+static bool runManifest()
+{
+	char manifest[256];
+	return buildTileManifest(gFrame, GEO, manifest, sizeof(manifest)) > 0;
+}
+
+static size_t prepItems()
+{
+	static const char *const TEXT[] = {
+		"Groceries", "Milk", "Eggs (a dozen)", "Sourdough loaf", "Coffee beans",
+		"Chores", "Water the plants", "Return library books", "Call the plumber"};
+	gInput.clear();
+	append(gInput, "ILS1");
+	gInput.push_back((uint8_t)(sizeof(TEXT) / sizeof(TEXT[0])));
+	for (size_t i = 0; i < sizeof(TEXT) / sizeof(TEXT[0]); i++)
+	{
+		gInput.push_back((i % 5 == 0 ? ITEM_HEADING : 0) | (i % 3 == 2 ? ITEM_DONE : 0));
+		gInput.push_back((uint8_t)strlen(TEXT[i]));
+		append(gInput, TEXT[i]);
+	}
+	return FRAME_BYTES;
+}
+
+static bool runItems()
+{
+	return renderItemList(gInput.data(), gInput.size(), gFrame, FRAME_W, FRAME_H, nullptr);
+}
+
+// The CPU half of drawBitmap1bpp on a transposed panel (2.9", 296x128 on a 128x296 controller)
+static constexpr uint16_t ROT_W = 296;
+static constexpr uint16_t ROT_H = 128;
+
+static size_t prepRotate()
+{
+	gInput.resize((size_t)ROT_W / 8 * ROT_H);
+	fill(gInput.data(), gInput.size());
+	return gInput.size();
+}
+
+static bool runRotate()
+{
+	return rotateToNative(gInput.data(), ROT_W, ROT_H, 1, false, gFrame);
+}
+
+static size_t prepSha() { return prepManifest(); }
+
+static bool runSha()
+{
+	StreamDigest d;
+	uint8_t sum[DIGEST_MAX_BYTES];
+	d.begin(DigestAlgo::Sha256);
+	for (size_t off = 0; off < FRAME_BYTES; off += SEGMENT)
+		d.update(gFrame + off, FRAME_BYTES - off < SEGMENT ? FRAME_BYTES - off : SEGMENT);
+	return d.finish(sum) == 32;
+}
+
+#if !defined(ESP_PLATFORM)
+// A relinked image in miniature: long COPY runs, short ADD patches, a few INSERTs, one SEEK.
+static constexpr uint32_t OTA_IMAGE_BYTES = 128 * 1024;
+static DeltaState gOtaState;
+
+static void opcode(uint8_t op, uint32_t n)
+{
+	gInput.push_back(op);
+	do
+	{
+		gInput.push_back((uint8_t)((n & 0x7F) | (n > 0x7F ? 0x80 : 0)));
+		n >>= 7;
+	} while (n);
+}
+
+static size_t prepOta()
+{
+	std::vector<uint8_t> &src = sim::appPartition(sim::runningPartition());
+	fill(src.data(), OTA_IMAGE_BYTES);
+
+	gInput.clear();
+	gExpect.clear();
+	append(gInput, "ODL1");
+	const uint32_t sizes[2] = {OTA_IMAGE_BYTES, OTA_IMAGE_BYTES};
+	gInput.insert(gInput.end(), (const uint8_t *)sizes, (const uint8_t *)sizes + 8);
+	gInput.insert(gInput.end(), 32, 0xA5);
+
+	uint32_t s = 0;
+	opcode(OP_SEEK, 2 * 64); // skip the first 64 source bytes
+	s = 64;
+	while (gExpect.size() < OTA_IMAGE_BYTES)
+	{
+		const uint32_t left = OTA_IMAGE_BYTES - (uint32_t)gExpect.size();
+		uint32_t n = left < 900 ? left : 900;
+		if (s + n > OTA_IMAGE_BYTES)
+			n = OTA_IMAGE_BYTES - s;
+		if (n)
+		{
+			opcode(OP_COPY, n);
+			gExpect.insert(gExpect.end(), src.begin() + s, src.begin() + s + n);
+			s += n;
+		}
+		if (gExpect.size() + 12 > OTA_IMAGE_BYTES || s + 4 > OTA_IMAGE_BYTES)
+		{
+			const uint32_t rest = OTA_IMAGE_BYTES - (uint32_t)gExpect.size();
+			opcode(OP_INSERT, rest);
+			for (uint32_t k = 0; k < rest; k++)
+				gInput.push_back(0), gExpect.push_back(0);
+			break;
+		}
+		opcode(OP_ADD, 4); // a relocated pointer
+		for (int k = 0; k < 4; k++)
+		{
+			gInput.push_back((uint8_t)(k + 1));
+			gExpect.push_back((uint8_t)(src[s++] + k + 1));
+		}
+		opcode(OP_INSERT, 8);
+		for (int k = 0; k < 8; k++)
+		{
+			const uint8_t b = rnd();
+			gInput.push_back(b);
+			gExpect.push_back(b);
+		}
+	}
+	gInput.push_back(OP_END);
+	return OTA_IMAGE_BYTES;
+}
+
+static bool runOta()
+{
+	ApplyCtx c;
+	memset(&c, 0, sizeof(c));
+	c.st = &gOtaState;
+	c.src = esp_ota_get_running_partition();
+	c.dst = esp_ota_get_next_update_partition(nullptr);
+	resetDelta(gOtaState, c.dst->subtype);
+	for (size_t off = 0; off < gInput.size(); off += SEGMENT)
+	{
+		const size_t n = gInput.size() - off < SEGMENT ? gInput.size() - off : SEGMENT;
+		if (!feed(c, gInput.data() + off, n))
+			return false;
+	}
+	if (gOtaState.phase != PHASE_DONE || !flushPage(c))
+		return false;
+	const std::vector<uint8_t> &dst = sim::appPartition(1 - sim::runningPartition());
+	return memcmp(dst.data(), gExpect.data(), OTA_IMAGE_BYTES) == 0;
+}
+#endif
+
+struct Kernel
+{
+	const char *name;
+	size_t (*prepare)(); // builds the input, returns bytes per pass
+	bool (*run)();		 // one pass; false = wrong result
+};
+
+static const Kernel KERNELS[] = {
+	{"url.parse", prepUrls, runUrls},
+	{"http.chunked", prepChunked, runChunked},
+	{"http.length", prepLength, runLength},
+	{"pbm.p4", prepP4, runP4},
+	{"pbm.p5", prepP5, runP5},
+	{"frame.p4", prepFrame, runFrame},
+	{"tile.delta", prepTiles, runTiles},
+	{"tile.manifest", prepManifest, runManifest},
+	{"items.render", prepItems, runItems},
+	{"bitmap.rotate", prepRotate, runRotate},
+	{"digest.sha256", prepSha, runSha},
+#if !defined(ESP_PLATFORM)
+	{"ota.apply", prepOta, runOta},
+#endif
+};
+
+// ---------------- harness ----------------
+
+// k is prepared. Best of REPEATS, each at least REPEAT_TICKS long; ticks are ns on the host,
+// cycles on the ESP32.
+static bool measure(const Kernel &k, double &ticksPerPass, int32_t &allocs)
+{
+	if (!k.run()) // warm-up and result check
+		return false;
+
+	const uint32_t a0 = gAllocs;
+	k.run();
+	allocs = ALLOCS_COUNTED ? (int32_t)(gAllocs - a0) : -1;
+
+	uint32_t t0 = ticks();
+	k.run();
+	const uint32_t once = ticks() - t0;
+	const uint32_t iters = once ? REPEAT_TICKS / once + 1 : 1000;
+
+	ticksPerPass = 0;
+	for (int r = 0; r < REPEATS; r++)
+	{
+		t0 = ticks();
+		for (uint32_t i = 0; i < iters; i++)
+			k.run();
+		const double t = (double)(ticks() - t0) / iters;
+		if (r == 0 || t < ticksPerPass)
+			ticksPerPass = t;
+	}
+	return true;
+}
+
+static int runAll(const char *only)
+{
+	int failures = 0;
+#if defined(ESP_PLATFORM)
+	const uint32_t mhz = getCpuFrequencyMhz();
+	out("platform esp32 %u MHz\n", (unsigned)mhz);
+#else
+	out("platform host\n");
+#endif
+	out("%-16s %8s %10s %10s %7s\n", "kernel", "bytes", "ns/B", "cyc/B", "allocs");
+
+	for (const Kernel &k : KERNELS)
+	{
+		if (only && strncmp(k.name, only, strlen(only)) != 0)
+			continue;
+
+		gSeed = 1;
+		const size_t bytes = k.prepare();
+		double perPass;
+		int32_t allocs;
+		if (!measure(k, perPass, allocs))
+		{
+			out("%-16s %8u %10s %10s %7s  WRONG RESULT\n", k.name, (unsigned)bytes, "-", "-", "-");
+			failures++;
+			continue;
+		}
+
+#if defined(ESP_PLATFORM)
+		out("%-16s %8u %10.3f %10.3f %7d\n", k.name, (unsigned)bytes,
+			perPass * 1000.0 / mhz / bytes, perPass / bytes, (int)allocs);
+#else
+		out("%-16s %8u %10.3f %10s %7d\n", k.name, (unsigned)bytes, perPass / bytes, "-", (int)allocs);
+#endif
+	}
+	out("done, %d wrong result(s)\n", failures);
+	return failures;
+}
+
+#if defined(ESP_PLATFORM)
+
+void setup()
+{
+	Serial.begin(115200);
+	delay(1000);
+	runAll(nullptr);
+}
+
+void loop()
+{
+	delay(1000);
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+	return runAll(argc > 1 ? argv[1] : nullptr) ? 1 : 0;
+}
+
+#endif
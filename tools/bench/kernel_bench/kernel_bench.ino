@@ -0,0 +1,2 @@
+// ESP32 build of ../kernel_bench.cpp; see there for the arduino-cli line.
+#include "kernel_bench.cpp"
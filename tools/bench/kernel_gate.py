@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Regression gate for tools/bench/kernel_bench.cpp results.
+
+Reads kernel_bench output: the host binary's stdout, or an ESP32 serial capture (other log
+lines are skipped). Several files may be given; each kernel's best time is used, which
+takes most of the scheduling noise out of host runs. The time compared is ns/B on the host
+and cycles/B (CCOUNT) on the ESP32, against kernel_baseline.txt for the same platform.
+
+The baseline is per machine and not part of the repository: the first run on a machine
+(no entries for its platform yet) records it and passes.
+
+Fails (exit 1) when a kernel is more than --threshold percent (25 host, 5 ESP32) slower
+than its baseline, allocates more often per pass, produced a wrong result, or is missing
+from the results.
+
+    /tmp/kernel_bench > /tmp/k1; /tmp/kernel_bench > /tmp/k2; /tmp/kernel_bench > /tmp/k3
+    python3 tools/bench/kernel_gate.py /tmp/k1 /tmp/k2 /tmp/k3
+    python3 tools/bench/kernel_gate.py /tmp/kernel_esp32.log
+    python3 tools/bench/kernel_gate.py /tmp/k1 /tmp/k2 /tmp/k3 --save   # accept as the new baseline
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# CCOUNT is repeatable to a fraction of a percent; host timings are not
+DEFAULT_THRESHOLD = {"host": 25.0, "esp32": 5.0}
+DEFAULT_BASELINE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "kernel_baseline.txt")
+
+PLATFORM = re.compile(r"^platform (host|esp32)\b")
+RESULT = re.compile(r"^(\S+)\s+(\d+)\s+(-|[\d.]+)\s+(-|[\d.]+)\s+(-?\d+)\s*$")
+WRONG = re.compile(r"^(\S+)\s+\d+\s+-\s+-\s+-\s+WRONG RESULT")
+
+
+class Result:
+    def __init__(self, per_byte, allocs):
+        self.per_byte = per_byte
+        self.allocs = allocs
+
+
+def read_results(paths):
+    """-> platform, {kernel: Result}, [kernels with a wrong result]"""
+    platform = None
+    results = {}
+    wrong = []
+    for path in paths:
+        with (sys.stdin if path == "-" else open(path, errors="replace")) as f:
+            current = None
+            for line in f:
+                line = line.strip()
+                m = PLATFORM.match(line)
+                if m:
+                    current = m.group(1)
+                    if platform and current != platform:
+                        sys.exit("%s: %s results mixed with %s" % (path, current, platform))
+                    platform = current
+                    continue
+                m = WRONG.match(line)
+                if m:
+                    wrong.append(m.group(1))
+                    continue
+                m = RESULT.match(line)
+                if not m or not current:
+                    continue
+                value = m.group(3) if current == "host" else m.group(4)
+                if value == "-":
+                    continue
+                r = Result(float(value), int(m.group(5)))
+                old = results.get(m.group(1))
+                if old:
+                    r.per_byte = min(r.per_byte, old.per_byte)
+                    r.allocs = max(r.allocs, old.allocs)
+                results[m.group(1)] = r
+    if not platform:
+        sys.exit("no kernel_bench results (\"platform ...\" line) in the input")
+    return platform, results, wrong
+
+
+def read_baseline(path):
+    """-> {(platform, kernel): Result}, in file order"""
+    base = {}
+    if not os.path.exists(path):
+        return base
+    with open(path) as f:
+        for line in f:
+            line = line.split("#", 1)[0].split()
+            if len(line) == 4:
+                base[(line[0], line[1])] = Result(float(line[2]), int(line[3]))
+    return base
+
+
+def write_baseline(path, base):
+    unit = {"host": "ns/B", "esp32": "cycles/B"}
+    with open(path, "w") as f:
+        f.write("# kernel_bench baseline: platform kernel per-byte allocs-per-pass\n")
+        f.write("# per-byte is %s on the host, %s on the ESP32 (CCOUNT).\n" % (unit["host"], unit["esp32"]))
+        f.write("# Written by tools/bench/kernel_gate.py (first run or --save); machine specific, not committed.\n")
+        for (platform, kernel), r in base.items():
+            f.write("%-6s %-16s %10.3f %4d\n" % (platform, kernel, r.per_byte, r.allocs))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("results", nargs="+", help="kernel_bench output files ('-' = stdin)")
+    ap.add_argument("--baseline", default=DEFAULT_BASELINE, help="baseline file (default: %(default)s)")
+    ap.add_argument("--threshold", type=float, help="allowed slowdown in percent (default: 25 host, 5 ESP32)")
+    ap.add_argument("--save", action="store_true", help="replace this platform's baseline with the results")
+    args = ap.parse_args()
+
+    platform, results, wrong = read_results(args.results)
+    base = read_baseline(args.baseline)
+    threshold = args.threshold if args.threshold is not None else DEFAULT_THRESHOLD[platform]
+
+    first = not any(p == platform for p, _ in base)
+    if args.save or (first and not wrong):
+        if wrong:
+            sys.exit("not saving: wrong result from %s" % ", ".join(wrong))
+        base = {k: v for k, v in base.items() if k[0] != platform}
+        for kernel, r in results.items():
+            base[(platform, kernel)] = r
+        write_baseline(args.baseline, base)
+        if not args.save:
+            print("no %s baseline yet: this run recorded as the baseline" % platform)
+        print("%s: %d kernel(s) saved to %s" % (platform, len(results), args.baseline))
+        return 0
+
+    failures = ["%s: wrong result" % k for k in wrong]
+    limit = 1.0 + threshold / 100.0
+    print("%-16s %10s %10s %8s %8s  %s" % ("kernel", "baseline", "now", "change", "allocs", platform))
+    for (p, kernel), b in base.items():
+        if p != platform:
+            continue
+        r = results.get(kernel)
+        if r is None:
+            failures.append("%s: missing from the results" % kernel)
+            print("%-16s %10.3f %10s" % (kernel, b.per_byte, "-"))
+            continue
+
+        change = (r.per_byte / b.per_byte - 1.0) * 100.0 if b.per_byte else 0.0
+        verdict = ""
+        if r.per_byte > b.per_byte * limit:
+            verdict = "SLOWER"
+            failures.append("%s: %.1f%% slower" % (kernel, change))
+        if r.allocs > b.allocs >= 0:
+            verdict = (verdict + " MORE ALLOCS").strip()
+            failures.append("%s: %d allocation(s) per pass, baseline %d" % (kernel, r.allocs, b.allocs))
+        if not verdict and r.per_byte * limit < b.per_byte:
+            verdict = "faster (--save to keep)"
+        print("%-16s %10.3f %10.3f %+7.1f%% %3d/%-3d  %s" %
+              (kernel, b.per_byte, r.per_byte, change, r.allocs, b.allocs, verdict))
+
+    for kernel in sorted(k for k in results if (platform, k) not in base):
+        print("%-16s %10s %10.3f %8s %3d      new (--save to gate it)" % (kernel, "-", results[kernel].per_byte, "", results[kernel].allocs))
+
+    if failures:
+        print("\nFAIL (threshold %.0f%%):\n  %s" % (threshold, "\n  ".join(failures)))
+        return 1
+    print("\nok (threshold %.0f%%)" % threshold)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""Battery-life projection from recorded wake traces.
+
+Per-wake durations come from either source (several files may be mixed):
+  - device serial logs: the "[WAKE] #N prev:" records WakeTrace prints at boot
+    (phase marks boot / wifi / tls / tls-ok / fetch / draw / sleep, ms since reset)
+  - the simulator: /tmp/wake_bench --csv FILE
+
+Each wake is reduced to awake / radio-on / panel-refresh milliseconds and priced with a
+current profile (sleep, CPU per clock, Wi-Fi RX/TX, EPD refresh; --dump-profile prints the
+defaults, --profile FILE.json overrides any of them). Wakes with a refresh are "changed",
+the rest "unchanged"; the projection mixes them by content-change rate for each sleep
+interval (SLEEP_MINUTES, i.e. SLEEP_DURATION_US).
+
+    python3 tools/energy_model.py --log serial.txt
+    /tmp/wake_bench --only lan --csv /tmp/lan.csv
+    python3 tools/energy_model.py --csv /tmp/lan.csv --minutes 5,10,30,60 --change 0.1,0.5,1
+    python3 tools/energy_model.py --csv /tmp/before.csv --compare /tmp/after.csv
+"""
+
+import argparse
+import csv
+import json
+import re
+import statistics
+import sys
+
+# Board-level averages for the reference build (ESP32 DevKit + S7V8F5 + 4.2" panel).
+# Currents are on the 3.3 V rail; sleep_ua is the whole board in deep sleep.
+DEFAULT_PROFILE = {
+    "rail_volts": 3.3,
+    "battery_volts": 3.7,
+    "regulator_efficiency": 0.85,
+    "sleep_ua": 150.0,  # ESP32 ~10 uA + regulator quiescent + battery divider
+    "cpu_mhz": 240,
+    "cpu_ma": {"80": 30.0, "160": 40.0, "240": 50.0},
+    "wifi_rx_ma": 70.0,  # added to CPU while the radio is on (listening / receiving)
+    "wifi_tx_ma": 180.0,  # added while transmitting
+    "wifi_tx_duty": 0.1,  # share of radio-on time spent transmitting
+    "epd_refresh_ma": 8.0,  # panel booster during a refresh, added to CPU
+    "epd_refresh_ms": 3500,  # used when the traces have no changed wake to measure
+    "refresh_threshold_ms": 250,  # fetch->draw longer than this counts as a refresh
+}
+
+LOG_HEAD = re.compile(r"\[WAKE\] #(\d+) prev:")
+LOG_PHASE = re.compile(r"\[WAKE\]\s+(\S+)\s+(\d+) ms free=")
+
+
+class Wake:
+    def __init__(self, awake_ms, radio_ms, epd_ms, source):
+        self.awake_ms = awake_ms
+        self.radio_ms = radio_ms
+        self.epd_ms = epd_ms
+        self.source = source
+
+
+def load_profile(path):
+    profile = json.loads(json.dumps(DEFAULT_PROFILE))
+    if path:
+        with open(path) as f:
+            override = json.load(f)
+        for k, v in override.items():
+            if k not in profile:
+                raise SystemExit("%s: unknown profile key %r" % (path, k))
+            if isinstance(profile[k], dict):
+                profile[k].update({str(a): b for a, b in v.items()})
+            else:
+                profile[k] = v
+    return profile
+
+
+def wake_from_phases(phases, source, profile):
+    """Phase marks (name, ms since reset) -> Wake; None when the record is incomplete."""
+    marks = dict(phases)
+    if "sleep" not in marks:
+        return None
+    awake = marks["sleep"]
+    # The radio comes up right after boot (battery check first) and stays on until sleep.
+    radio = awake - marks.get("boot", 0) if "wifi" in marks else 0
+
+    epd = 0
+    for i in range(1, len(phases)):
+        name, ms = phases[i]
+        span = ms - phases[i - 1][1]
+        if name == "draw" and span >= profile["refresh_threshold_ms"]:
+            epd += span
+    return Wake(awake, radio, epd, source)
+
+
+def read_log(path, profile):
+    wakes = []
+    phases = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            if LOG_HEAD.search(line):
+                phases = []
+                continue
+            m = LOG_PHASE.search(line)
+            if m and phases is not None:
+                phases.append((m.group(1), int(m.group(2))))
+                continue
+            if phases:
+                w = wake_from_phases(phases, path, profile)
+                if w:
+                    wakes.append(w)
+                phases = None
+    if phases:
+        w = wake_from_phases(phases, path, profile)
+        if w:
+            wakes.append(w)
+    return wakes
+
+
+def read_csv(path):
+    wakes = []
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            if row.get("ok", "1") != "1" or row.get("wake") == "1":
+                continue  # fault wakes and the cold power-on wake are not the steady state
+            wakes.append(Wake(int(row["awake_ms"]), int(row["radio_ms"]), int(row["epd_ms"]),
+                              "%s:%s" % (path, row.get("scenario", ""))))
+    return wakes
+
+
+def median_wake(wakes):
+    return Wake(statistics.median(w.awake_ms for w in wakes),
+                statistics.median(w.radio_ms for w in wakes),
+                statistics.median(w.epd_ms for w in wakes), "median")
+
+
+def split(wakes, profile):
+    """Median (changed, unchanged) wake; a missing kind is derived from the other one."""
+    changed = [w for w in wakes if w.epd_ms > 0]
+    unchanged = [w for w in wakes if w.epd_ms == 0]
+    c = median_wake(changed) if changed else None
+    u = median_wake(unchanged) if unchanged else None
+    if c is None:
+        r = profile["epd_refresh_ms"]
+        c = Wake(u.awake_ms + r, u.radio_ms + r, r, "derived")
+    if u is None:
+        u = Wake(c.awake_ms - c.epd_ms, max(0, c.radio_ms - c.epd_ms), 0, "derived")
+    return c, u, len(changed), len(unchanged)
+
+
+def battery_mah(rail_ma_ms, profile):
+    """mA*ms on the rail -> mAh drawn from the battery through the regulator."""
+    ratio = profile["rail_volts"] / (profile["battery_volts"] * profile["regulator_efficiency"])
+    return rail_ma_ms / 3.6e6 * ratio
+
+
+def wake_mah(w, profile):
+    cpu = profile["cpu_ma"][str(profile["cpu_mhz"])]
+    duty = profile["wifi_tx_duty"]
+    radio = profile["wifi_rx_ma"] * (1 - duty) + profile["wifi_tx_ma"] * duty
+    return battery_mah(cpu * w.awake_ms + radio * w.radio_ms + profile["epd_refresh_ma"] * w.epd_ms,
+                       profile)
+
+
+def per_day(changed, unchanged, minutes, rate, profile):
+    """(wakes/day, mAh/day) for one sleep interval and content-change rate."""
+    avg_awake_s = (rate * changed.awake_ms + (1 - rate) * unchanged.awake_ms) / 1000.0
+    wakes = 86400.0 / (minutes * 60.0 + avg_awake_s)
+    active = wakes * (rate * wake_mah(changed, profile) + (1 - rate) * wake_mah(unchanged, profile))
+    asleep_h = 24.0 - wakes * avg_awake_s / 3600.0
+    sleep = battery_mah(profile["sleep_ua"] / 1000.0 * asleep_h * 3.6e6, profile)
+    return wakes, active + sleep
+
+
+def load(paths_log, paths_csv, profile):
+    wakes = []
+    for p in paths_log or ():
+        wakes += read_log(p, profile)
+    for p in paths_csv or ():
+        wakes += read_csv(p)
+    return wakes
+
+
+def describe(label, w, n, profile):
+    print("  %-9s %3d wake(s): awake %6.0f ms, radio %6.0f ms, refresh %5.0f ms -> %.4f mAh" %
+          (label, n, w.awake_ms, w.radio_ms, w.epd_ms, wake_mah(w, profile)))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--log", action="append", help="device serial log with [WAKE] prev records")
+    ap.add_argument("--csv", action="append", help="wake_bench --csv output")
+    ap.add_argument("--compare", help="second wake_bench CSV to project side by side")
+    ap.add_argument("--profile", help="JSON file overriding DEFAULT_PROFILE keys")
+    ap.add_argument("--dump-profile", action="store_true", help="print the default profile and exit")
+    ap.add_argument("--cpu-mhz", type=int, help="CPU clock to price (80/160/240)")
+    ap.add_argument("--minutes", default="5,10,30,60", help="sleep intervals (SLEEP_MINUTES)")
+    ap.add_argument("--change", default="0.1,0.5,1", help="share of wakes whose content changed")
+    ap.add_argument("--battery", type=float, default=10000.0, help="capacity, mAh")
+    ap.add_argument("--usable", type=float, default=0.8, help="usable share of capacity")
+    args = ap.parse_args()
+
+    if args.dump_profile:
+        json.dump(DEFAULT_PROFILE, sys.stdout, indent=2)
+        print()
+        return
+
+    profile = load_profile(args.profile)
+    if args.cpu_mhz:
+        profile["cpu_mhz"] = args.cpu_mhz
+    if str(profile["cpu_mhz"]) not in profile["cpu_ma"]:
+        raise SystemExit("no CPU current for %s MHz in the profile" % profile["cpu_mhz"])
+
+    runs = [("", load(args.log, args.csv, profile))]
+    if args.compare:
+        runs.append(("compare", read_csv(args.compare)))
+    for label, wakes in runs:
+        if not wakes:
+            raise SystemExit("no complete wakes in the %s input" % (label or "given"))
+
+    minutes = [float(m) for m in args.minutes.split(",")]
+    rates = [float(r) for r in args.change.split(",")]
+    usable = args.battery * args.usable
+
+    print("profile: CPU %s MHz %.0f mA, Wi-Fi RX %.0f / TX %.0f mA (%.0f%% TX), EPD %.0f mA, "
+          "sleep %.0f uA; battery %.0f mAh x %.2f" %
+          (profile["cpu_mhz"], profile["cpu_ma"][str(profile["cpu_mhz"])], profile["wifi_rx_ma"],
+           profile["wifi_tx_ma"], profile["wifi_tx_duty"] * 100, profile["epd_refresh_ma"],
+           profile["sleep_ua"], args.battery, args.usable))
+
+    projections = []
+    for label, wakes in runs:
+        c, u, nc, nu = split(wakes, profile)
+        print("\n%s%d wake(s)" % ("[%s] " % label if label else "", len(wakes)))
+        describe("changed", c, nc, profile)
+        describe("unchanged", u, nu, profile)
+        projections.append((c, u))
+
+    print("\n%8s %7s %8s %10s %9s%s" % ("interval", "change", "wakes/d", "mAh/day", "days",
+                                        "  compare days  vs base" if args.compare else ""))
+    for m in minutes:
+        for r in rates:
+            wakes, mah = per_day(projections[0][0], projections[0][1], m, r, profile)
+            line = "%6.0f m %6.0f%% %8.0f %10.2f %9.0f" % (m, r * 100, wakes, mah, usable / mah)
+            if args.compare:
+                _, mah2 = per_day(projections[1][0], projections[1][1], m, r, profile)
+                line += "  %12.0f %+6.1f%%" % (usable / mah2, (mah / mah2 - 1) * 100)
+            print(line)
+
+
+if __name__ == "__main__":
+    main()
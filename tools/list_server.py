@@ -0,0 +1,406 @@
+#!/usr/bin/env python3
+"""Host stand-in for the list-service PBM endpoint (reference for the device protocol).
+
+Serves GET /list/items.pbm over HTTP/1.1 keep-alive with:
+  - strong ETag, Range / If-Range -> 206 Partial Content
+  - X-Tile-Manifest (v1;rows=16;<base64 uint32le FNV-1a per band>) -> tile-delta
+    container (application/x-tile-delta) with only the bands that differ
+  - Content-Digest: sha-256=:<base64>: over every response body (--corrupt flips a
+    body byte after hashing, to exercise the device's integrity check)
+  - Accept: image/x-portable-graymap (FRAME_GRAY builds) -> 8-bit P5 instead of P4,
+    from --pgm FILE or derived from the 1-bpp frame with all four gray levels
+  - Accept: application/x-item-list (with --items) -> the list itself ("ILS1", see
+    main/ItemList.h); everyone else gets the same list rendered to P4 from the device's
+    glyph atlas (main/GlyphAtlas.h), pixel for pixel what the device draws
+  - GET /ota/delta?from=<image id> (with --ota DIR) -> firmware delta from that image to
+    the newest *.bin in DIR (tools/ota_delta.py, main/OtaUpdater.h), Range-resumable;
+    204 when the device runs the newest image or one the server does not have
+
+Frame source: --items FILE or --pbm FILE (re-read when they change), otherwise a
+generated 400x300 test pattern where one band flips every --tick seconds (a "list item"
+changing). An items file has one item per line; "# text" is a heading, "~ text" is done.
+
+    python3 tools/list_server.py --port 3001
+    python3 tools/list_server.py --pbm items.pbm --pgm items.pgm --port 3001
+    python3 tools/list_server.py --items list.txt --size 400x300 --port 3001
+    python3 tools/list_server.py --ota firmware/ --port 3001
+"""
+
+import argparse
+import base64
+import hashlib
+import os
+import re
+import struct
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs
+
+from ota_delta import image_id, make_delta
+
+TILE_ROWS = 16
+
+# Item layout, as in main/ItemList.h
+ITEM_PITCH = 32
+ITEM_TEXT_X = 8
+ITEM_HEADING = 1
+ITEM_DONE = 2
+ATLAS_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "main", "GlyphAtlas.h")
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def parse_pbm(blob, magic=b"P4"):
+    """Returns (w, h, raster) for a binary P4 PBM (or an 8-bit P5 PGM)."""
+    want = 3 if magic == b"P4" else 4
+    tokens = []
+    i = 0
+    while len(tokens) < want:
+        while blob[i:i + 1].isspace():
+            i += 1
+        if blob[i:i + 1] == b"#":
+            while blob[i:i + 1] not in (b"\n", b"\r"):
+                i += 1
+            continue
+        j = i
+        while not blob[j:j + 1].isspace():
+            j += 1
+        tokens.append(blob[i:j])
+        i = j
+    if tokens[0] != magic:
+        raise ValueError("not a %s file" % magic.decode())
+    i += 1  # single whitespace before raster
+    w, h = int(tokens[1]), int(tokens[2])
+    if magic == b"P5":
+        if int(tokens[3]) > 255:
+            raise ValueError("16-bit PGM not supported")
+        return w, h, blob[i:i + w * h]
+    return w, h, blob[i:i + ((w + 7) // 8) * h]
+
+
+def make_pbm(w, h, bitmap):
+    return b"P4\n%d %d\n" % (w, h) + bitmap
+
+
+def make_pgm(w, h, bitmap, pgm_path):
+    """P5 for gray clients: --pgm file when its size matches, else the 1-bpp frame with
+    light gray on every 4th white row and dark gray on every 4th black row."""
+    if pgm_path:
+        with open(pgm_path, "rb") as f:
+            gw, gh, gray = parse_pbm(f.read(), b"P5")
+        if (gw, gh) == (w, h):
+            return b"P5\n%d %d\n255\n" % (w, h) + gray
+    bpr = (w + 7) // 8
+    out = bytearray()
+    for y in range(h):
+        for x in range(w):
+            black = (bitmap[y * bpr + x // 8] >> (7 - x % 8)) & 1
+            out.append((85 if y % 4 == 0 else 0) if black else (170 if y % 4 == 0 else 255))
+    return b"P5\n%d %d\n255\n" % (w, h) + bytes(out)
+
+
+def load_atlas(path=ATLAS_PATH):
+    with open(path) as f:
+        src = f.read()
+    const = {k: int(v, 0) for k, v in re.findall(r"(GLYPH_\w+) = (0x[0-9A-Fa-f]+|\d+);", src)}
+    rows = [int(v, 16) for v in re.findall(r"0x([0-9A-F]{4})", src.split("PROGMEM", 1)[1])]
+    return const, rows
+
+
+def parse_items(text):
+    items = []
+    for line in text.splitlines():
+        flags = 0
+        if line.startswith("# "):
+            flags, line = ITEM_HEADING, line[2:]
+        elif line.startswith("~ "):
+            flags, line = ITEM_DONE, line[2:]
+        if line.strip():
+            items.append((flags, line.rstrip().encode("ascii", "replace")[:255]))
+    return items[:255]
+
+
+def make_item_list(items):
+    out = bytearray(b"ILS1" + bytes([len(items)]))
+    for flags, text in items:
+        out += bytes([flags, len(text)]) + text
+    return bytes(out)
+
+
+def render_items(items, w, h, atlas):
+    """P4 raster of the list, the same pixels as renderItemList() on the device."""
+    const, glyphs = atlas
+    gw, gh, base = const["GLYPH_W"], const["GLYPH_H"], const["GLYPH_BASELINE"]
+    first, last = const["GLYPH_FIRST"], const["GLYPH_LAST"]
+    bpr = (w + 7) // 8
+    frame = bytearray(bpr * h)
+
+    def put(x, y, ink):
+        if x < w and y < h:
+            if ink:
+                frame[y * bpr + x // 8] |= 0x80 >> (x % 8)
+            else:
+                frame[y * bpr + x // 8] &= ~(0x80 >> (x % 8)) & 0xFF
+
+    cell_top = (ITEM_PITCH - gh) // 2
+    max_chars = (w - ITEM_TEXT_X) // gw
+    for i, (flags, text) in enumerate(items):
+        top = i * ITEM_PITCH
+        if top + ITEM_PITCH > h:
+            break
+        heading = bool(flags & ITEM_HEADING)
+        if heading:
+            for y in range(top, top + ITEM_PITCH):
+                for x in range(w):
+                    put(x, y, True)
+        chars = min(len(text), max_chars)
+        for k in range(chars):
+            c = text[k]
+            if c == 0x20:
+                continue
+            if not first <= c <= last:
+                c = ord("?")
+            rows = glyphs[(c - first) * gh:(c - first + 1) * gh]
+            x0 = ITEM_TEXT_X + k * gw
+            for r, bits in enumerate(rows):
+                for b in range(16):
+                    if (bits >> (15 - b)) & 1:
+                        put(x0 + b, top + cell_top + r, not heading)
+        if flags & ITEM_DONE and chars:
+            for y in range(2):
+                for x in range(ITEM_TEXT_X, ITEM_TEXT_X + chars * gw):
+                    put(x, top + cell_top + base - 6 + y, not heading)
+    return bytes(frame)
+
+
+class FrameSource:
+    def __init__(self, path, tick, items_path=None, size=(400, 300)):
+        self.path = path
+        self.tick = tick
+        self.items_path = items_path
+        self.size = size
+        self.atlas = load_atlas() if items_path else None
+        self.lock = threading.Lock()
+        self.mtime = None
+        self.w = self.h = 0
+        self.bitmap = b""
+        self.item_list = None  # "ILS1" payload in items mode
+
+    def _pattern(self):
+        w, h = 400, 300
+        bpr = (w + 7) // 8
+        rows = bytearray()
+        step = int(time.time() // self.tick) if self.tick else 0
+        changing_band = step % ((h + TILE_ROWS - 1) // TILE_ROWS)
+        for y in range(h):
+            band = y // TILE_ROWS
+            if band == changing_band and (step // 2) % 2 == 0:
+                rows += bytes([0xFF if (y % 4) < 2 else 0x00]) * bpr
+            else:
+                rows += bytes([0xAA if (y + band) % 2 else 0x55]) * bpr
+        return w, h, bytes(rows)
+
+    def current(self):
+        with self.lock:
+            if self.items_path:
+                mtime = os.stat(self.items_path).st_mtime
+                if mtime != self.mtime:
+                    with open(self.items_path, errors="replace") as f:
+                        items = parse_items(f.read())
+                    self.w, self.h = self.size
+                    self.item_list = make_item_list(items)
+                    self.bitmap = render_items(items, self.w, self.h, self.atlas)
+                    self.mtime = mtime
+            elif not self.path:
+                self.w, self.h, self.bitmap = self._pattern()
+            else:
+                mtime = os.stat(self.path).st_mtime
+                if mtime != self.mtime:
+                    with open(self.path, "rb") as f:
+                        self.w, self.h, self.bitmap = parse_pbm(f.read())
+                    self.mtime = mtime
+            return self.w, self.h, self.bitmap
+
+
+def band_slices(w, h):
+    bpr = (w + 7) // 8
+    for band in range((h + TILE_ROWS - 1) // TILE_ROWS):
+        rows = min(TILE_ROWS, h - band * TILE_ROWS)
+        start = band * TILE_ROWS * bpr
+        yield band, start, start + rows * bpr
+
+
+def build_delta(w, h, bitmap, manifest):
+    """Tile-delta container or None if the manifest doesn't fit this frame."""
+    m = re.fullmatch(r"v1;rows=(\d+);([A-Za-z0-9+/=]*)", manifest.strip())
+    if not m or int(m.group(1)) != TILE_ROWS:
+        return None
+    raw = base64.b64decode(m.group(2))
+    slices = list(band_slices(w, h))
+    if len(raw) != 4 * len(slices):
+        return None
+    have = struct.unpack("<%dI" % len(slices), raw)
+
+    out = bytearray(b"TDL1" + struct.pack("<HHBB", w, h, TILE_ROWS, 0))
+    count = 0
+    for band, a, b in slices:
+        if fnv1a(bitmap[a:b]) != have[band]:
+            out += bytes([band]) + bitmap[a:b]
+            count += 1
+    out[9] = count
+    return bytes(out)
+
+
+class OtaImages:
+    """--ota DIR: app images (*.bin); the newest is current, the others are delta sources."""
+
+    def __init__(self, path):
+        self.path = path
+        self.deltas = {}
+        self.lock = threading.Lock()
+
+    def delta_from(self, from_id):
+        images, newest = {}, None
+        for name in os.listdir(self.path):
+            full = os.path.join(self.path, name)
+            if not name.endswith(".bin"):
+                continue
+            with open(full, "rb") as f:
+                blob = f.read()
+            try:
+                iid = image_id(blob)
+            except ValueError:
+                continue
+            images[iid] = blob
+            mtime = os.stat(full).st_mtime
+            if newest is None or mtime > newest[0]:
+                newest = (mtime, iid)
+
+        if newest is None or from_id == newest[1] or from_id not in images:
+            return None
+        key = (from_id, newest[1])
+        with self.lock:
+            if key not in self.deltas:
+                self.deltas[key] = make_delta(images[from_id], images[newest[1]])
+                print("delta %s -> %s: %d bytes" % (from_id, newest[1], len(self.deltas[key])), flush=True)
+            return self.deltas[key]
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # keep-alive
+    source = None
+
+    def log_message(self, fmt, *args):
+        print("[%s] %s" % (self.address_string(), fmt % args), flush=True)
+
+    corrupt = False
+    pgm = None
+    ota = None
+
+    def _send(self, code, body, ctype, headers=()):
+        self.send_response(code)
+        self.send_header("Content-Type", ctype)
+        self.send_header("Content-Length", str(len(body)))
+        if body:
+            digest = base64.b64encode(hashlib.sha256(body).digest()).decode()
+            self.send_header("Content-Digest", "sha-256=:%s:" % digest)
+            if self.corrupt:
+                body = bytearray(body)
+                body[len(body) // 2] ^= 0x01
+                body = bytes(body)
+        for k, v in headers:
+            self.send_header(k, v)
+        self.end_headers()
+        self.wfile.write(body)
+
+    def _send_entity(self, entity, ctype, etag):
+        """200, or 206 for "Range: bytes=N-" when If-Range (if any) still matches."""
+        m = re.fullmatch(r"bytes=(\d+)-", self.headers.get("Range") or "")
+        if_range = self.headers.get("If-Range")
+        if m and (if_range is None or if_range == etag):
+            start = int(m.group(1))
+            if start >= len(entity):
+                self._send(416, b"", "text/plain", [("Content-Range", "bytes */%d" % len(entity))])
+                return
+            part = entity[start:]
+            self._send(206, part, ctype, [
+                ("ETag", etag),
+                ("Content-Range", "bytes %d-%d/%d" % (start, len(entity) - 1, len(entity))),
+            ])
+            return
+
+        self._send(200, entity, ctype, [("ETag", etag)])
+
+    def _send_ota(self, query):
+        delta = self.ota.delta_from(parse_qs(query).get("from", [""])[0])
+        if delta is None:
+            self.send_response(204)  # no body, no Content-Length
+            self.end_headers()
+            return
+        etag = '"%s"' % hashlib.sha1(delta).hexdigest()[:16]
+        self._send_entity(delta, "application/x-ota-delta", etag)
+
+    def do_GET(self):
+        path, _, query = self.path.partition("?")
+        if path == "/ota/delta" and self.ota:
+            self._send_ota(query)
+            return
+        if path != "/list/items.pbm":
+            self._send(404, b"not found\n", "text/plain")
+            return
+
+        w, h, bitmap = self.source.current()
+        accept = self.headers.get("Accept", "")
+        item_list = self.source.item_list
+        if item_list and "application/x-item-list" in accept:
+            etag = '"%s"' % hashlib.sha1(item_list).hexdigest()[:16]
+            self._send(200, item_list, "application/x-item-list", [("ETag", etag)])
+            return
+
+        gray = "graymap" in accept
+        entity = make_pgm(w, h, bitmap, self.pgm) if gray else make_pbm(w, h, bitmap)
+        ctype = "image/x-portable-graymap" if gray else "image/x-portable-bitmap"
+        etag = '"%s"' % hashlib.sha1(entity).hexdigest()[:16]
+
+        manifest = None if gray else self.headers.get("X-Tile-Manifest")
+        if manifest and not self.headers.get("Range"):
+            delta = build_delta(w, h, bitmap, manifest)
+            if delta is not None:
+                self._send(200, delta, "application/x-tile-delta", [("ETag", etag)])
+                return
+
+        self._send_entity(entity, ctype, etag)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--port", type=int, default=3001)
+    ap.add_argument("--bind", default="0.0.0.0")
+    ap.add_argument("--pbm", help="P4 PBM file to serve (default: generated pattern)")
+    ap.add_argument("--pgm", help="8-bit P5 PGM served to gray clients (default: derived from the PBM)")
+    ap.add_argument("--items", help="item list text file (one item per line, '# ' heading, '~ ' done)")
+    ap.add_argument("--size", default="400x300", help="frame size for --items (PANEL_VARIANT geometry)")
+    ap.add_argument("--tick", type=float, default=60.0, help="pattern change period, seconds")
+    ap.add_argument("--corrupt", action="store_true", help="damage bodies after computing Content-Digest")
+    ap.add_argument("--ota", help="directory of firmware images (*.bin, newest is current) for /ota/delta")
+    args = ap.parse_args()
+
+    size = tuple(int(v) for v in args.size.lower().split("x"))
+    Handler.source = FrameSource(args.pbm, args.tick, args.items, size)
+    Handler.corrupt = args.corrupt
+    Handler.pgm = args.pgm
+    Handler.ota = OtaImages(args.ota) if args.ota else None
+    server = ThreadingHTTPServer((args.bind, args.port), Handler)
+    print("serving http://%s:%d/list/items.pbm" % (args.bind, args.port), flush=True)
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+"""Pre-rasterize a monospace TrueType font into main/GlyphAtlas.h.
+
+The atlas is what the device blits item-list text from (ItemList.cpp) and what
+tools/list_server.py renders with, so both produce the same pixels. Every printable
+ASCII glyph becomes GLYPH_H rows of a 16-bit, MSB-first span (GLYPH_W advance, ink may
+overhang to the right), thresholded from 4x4 supersampled coverage. Standard library
+only: the glyf outlines are flattened and filled with the nonzero rule here.
+
+    python3 tools/make_glyph_atlas.py \\
+        --ttf /usr/share/fonts/truetype/dejavu/DejaVuSansMono-Bold.ttf --px 20 > main/GlyphAtlas.h
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+FIRST, LAST = 0x20, 0x7E
+SPAN_BITS = 16
+SS = 4  # supersampling per axis
+
+
+class Font:
+    def __init__(self, data):
+        self.data = data
+        _, ntables = struct.unpack(">IH", data[:6])
+        self.tables = {}
+        for i in range(ntables):
+            tag, _, off, length = struct.unpack(">4sIII", data[12 + 16 * i:28 + 16 * i])
+            self.tables[tag.decode("latin-1")] = (off, length)
+
+        head = self.table("head")
+        self.units_per_em = struct.unpack(">H", head[18:20])[0]
+        self.long_loca = struct.unpack(">h", head[50:52])[0] == 1
+
+        hhea = self.table("hhea")
+        self.ascender, self.descender = struct.unpack(">hh", hhea[4:8])
+        self.num_hmetrics = struct.unpack(">H", hhea[34:36])[0]
+
+        self.num_glyphs = struct.unpack(">H", self.table("maxp")[4:6])[0]
+        self.cmap = self.read_cmap()
+
+    def table(self, tag):
+        off, length = self.tables[tag]
+        return self.data[off:off + length]
+
+    def read_cmap(self):
+        cmap = self.table("cmap")
+        n = struct.unpack(">H", cmap[2:4])[0]
+        for i in range(n):
+            platform, encoding, off = struct.unpack(">HHI", cmap[4 + 8 * i:12 + 8 * i])
+            if (platform, encoding) in ((3, 1), (0, 3), (0, 4)) and \
+                    struct.unpack(">H", cmap[off:off + 2])[0] == 4:
+                return self.cmap_format4(cmap[off:])
+        raise SystemExit("no Unicode BMP (format 4) cmap")
+
+    @staticmethod
+    def cmap_format4(sub):
+        segx2 = struct.unpack(">H", sub[6:8])[0]
+        seg = segx2 // 2
+        ends = struct.unpack(">%dH" % seg, sub[14:14 + segx2])
+        starts = struct.unpack(">%dH" % seg, sub[16 + segx2:16 + 2 * segx2])
+        deltas = struct.unpack(">%dh" % seg, sub[16 + 2 * segx2:16 + 3 * segx2])
+        ro_off = 16 + 3 * segx2
+        range_offsets = struct.unpack(">%dH" % seg, sub[ro_off:ro_off + segx2])
+        out = {}
+        for s in range(seg):
+            for c in range(starts[s], ends[s] + 1):
+                if c > 0xFF:
+                    break
+                if range_offsets[s] == 0:
+                    g = (c + deltas[s]) & 0xFFFF
+                else:
+                    p = ro_off + 2 * s + range_offsets[s] + 2 * (c - starts[s])
+                    g = struct.unpack(">H", sub[p:p + 2])[0]
+                    if g:
+                        g = (g + deltas[s]) & 0xFFFF
+                out[c] = g
+        return out
+
+    def advance(self, gid):
+        hmtx = self.table("hmtx")
+        i = min(gid, self.num_hmetrics - 1)
+        return struct.unpack(">H", hmtx[4 * i:4 * i + 2])[0]
+
+    def glyph_range(self, gid):
+        loca = self.table("loca")
+        if self.long_loca:
+            a, b = struct.unpack(">II", loca[4 * gid:4 * gid + 8])
+        else:
+            a, b = struct.unpack(">HH", loca[2 * gid:2 * gid + 4])
+            a, b = a * 2, b * 2
+        return a, b
+
+    def contours(self, gid, dx=0.0, dy=0.0):
+        """List of contours, each a list of (x, y, on_curve) in font units."""
+        a, b = self.glyph_range(gid)
+        if a == b:
+            return []
+        g = self.table("glyf")[a:b]
+        ncont = struct.unpack(">h", g[:2])[0]
+        if ncont < 0:
+            return self.composite(g, dx, dy)
+
+        ends = struct.unpack(">%dH" % ncont, g[10:10 + 2 * ncont])
+        npts = ends[-1] + 1 if ncont else 0
+        p = 10 + 2 * ncont
+        ilen = struct.unpack(">H", g[p:p + 2])[0]
+        p += 2 + ilen
+
+        flags = []
+        while len(flags) < npts:
+            f = g[p]
+            p += 1
+            flags.append(f)
+            if f & 8:
+                flags.extend([f] * g[p])
+                p += 1
+
+        def coords(short_bit, same_bit):
+            nonlocal p
+            vals, v = [], 0
+            for f in flags:
+                if f & short_bit:
+                    d = g[p]
+                    p += 1
+                    v += d if f & same_bit else -d
+                elif not f & same_bit:
+                    v += struct.unpack(">h", g[p:p + 2])[0]
+                    p += 2
+                vals.append(v)
+            return vals
+
+        xs = coords(2, 16)
+        ys = coords(4, 32)
+        out, start = [], 0
+        for e in ends:
+            out.append([(xs[i] + dx, ys[i] + dy, bool(flags[i] & 1)) for i in range(start, e + 1)])
+            start = e + 1
+        return out
+
+    def composite(self, g, dx, dy):
+        out, p = [], 10
+        while True:
+            flags, gid = struct.unpack(">HH", g[p:p + 4])
+            p += 4
+            if flags & 1:
+                ox, oy = struct.unpack(">hh", g[p:p + 4])
+                p += 4
+            else:
+                ox, oy = struct.unpack(">bb", g[p:p + 2])
+                p += 2
+            if flags & 8:
+                p += 2
+            elif flags & 0x40:
+                p += 4
+            elif flags & 0x80:
+                p += 8
+            out += self.contours(gid, dx + ox, dy + oy)  # offsets only; no scaled parts in ASCII
+            if not flags & 0x20:
+                return out
+
+
+def flatten(contour, steps=8):
+    """Quadratic B-spline contour -> closed polyline (implied on-curve midpoints)."""
+    pts = contour
+    if not any(on for _, _, on in pts):
+        pts = [((x1 + x2) / 2, (y1 + y2) / 2, True) for (x1, y1, _), (x2, y2, _) in zip(pts, pts[1:] + pts[:1])]
+    start = next(i for i, (_, _, on) in enumerate(pts) if on)
+    pts = pts[start:] + pts[:start]
+
+    poly = [(pts[0][0], pts[0][1])]
+    cur = pts[0]
+    ctrl = None
+    for x, y, on in pts[1:] + pts[:1]:
+        if on:
+            if ctrl is None:
+                poly.append((x, y))
+            else:
+                poly += quad(cur, ctrl, (x, y), steps)
+                ctrl = None
+            cur = (x, y)
+        else:
+            if ctrl is not None:
+                mid = ((ctrl[0] + x) / 2, (ctrl[1] + y) / 2)
+                poly += quad(cur, ctrl, mid, steps)
+                cur = mid
+            ctrl = (x, y)
+    return poly
+
+
+def quad(p0, c, p1, steps):
+    out = []
+    for i in range(1, steps + 1):
+        t = i / steps
+        a, b, d = (1 - t) ** 2, 2 * (1 - t) * t, t * t
+        out.append((a * p0[0] + b * c[0] + d * p1[0], a * p0[1] + b * c[1] + d * p1[1]))
+    return out
+
+
+def rasterize(polys, width, height):
+    """Nonzero fill of pixel-space polygons, SS x SS samples per pixel; returns coverage rows."""
+    cover = [[0] * width for _ in range(height)]
+    edges = []
+    for poly in polys:
+        for (x0, y0), (x1, y1) in zip(poly, poly[1:] + poly[:1]):
+            if y0 != y1:
+                edges.append((x0, y0, x1, y1))
+
+    for sy in range(height * SS):
+        y = (sy + 0.5) / SS
+        crossings = []
+        for x0, y0, x1, y1 in edges:
+            if (y0 <= y < y1) or (y1 <= y < y0):
+                x = x0 + (y - y0) * (x1 - x0) / (y1 - y0)
+                crossings.append((x, 1 if y1 > y0 else -1))
+        if not crossings:
+            continue
+        crossings.sort()
+        row = cover[sy // SS]
+        wind = 0
+        for k in range(len(crossings) - 1):
+            wind += crossings[k][1]
+            if wind == 0:
+                continue
+            xa, xb = crossings[k][0], crossings[k + 1][0]
+            sa = max(0, int(xa * SS + 0.5))
+            sb = min(width * SS, int(xb * SS + 0.5))
+            for sx in range(sa, sb):
+                row[sx // SS] += 1
+    return cover
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--ttf", required=True, help="monospace TrueType font (glyf outlines)")
+    ap.add_argument("--px", type=float, default=20.0, help="em size in pixels")
+    ap.add_argument("--threshold", type=float, default=0.45, help="coverage that counts as ink")
+    args = ap.parse_args()
+
+    with open(args.ttf, "rb") as f:
+        font = Font(f.read())
+
+    scale = args.px / font.units_per_em
+    advance = round(font.advance(font.cmap.get(ord("M"), 0)) * scale)
+    baseline = round(font.ascender * scale)
+    height = baseline + round(-font.descender * scale)
+    if advance > SPAN_BITS:
+        raise SystemExit("advance %d px does not fit a %d-bit span" % (advance, SPAN_BITS))
+
+    need = int(args.threshold * SS * SS + 0.5)
+    rows_out = []
+    for c in range(FIRST, LAST + 1):
+        polys = []
+        for contour in font.contours(font.cmap.get(c, 0)):
+            polys.append([(x * scale, baseline - y * scale) for x, y in flatten(contour)])
+        cover = rasterize(polys, SPAN_BITS, height)
+        rows = []
+        for r in range(height):
+            bits = 0
+            for x in range(SPAN_BITS):
+                bits = (bits << 1) | (1 if cover[r][x] >= need else 0)
+            rows.append(bits)
+        rows_out.append((c, rows))
+
+    name = os.path.basename(args.ttf)
+    w = sys.stdout.write
+    w("#pragma once\n\n#include <Arduino.h>\n\n")
+    w("// Generated by tools/make_glyph_atlas.py from %s at %g px; do not edit.\n" % (name, args.px))
+    w("// Glyph c, row r: GLYPH_ATLAS[(c - GLYPH_FIRST) * GLYPH_H + r], MSB = leftmost pixel,\n")
+    w("// 1 = ink. Ink may extend past GLYPH_W into the next cell.\n")
+    w("static constexpr char GLYPH_FIRST = 0x%02X;\n" % FIRST)
+    w("static constexpr char GLYPH_LAST = 0x%02X;\n" % LAST)
+    w("static constexpr int16_t GLYPH_W = %d;		// advance\n" % advance)
+    w("static constexpr int16_t GLYPH_H = %d;		// cell rows\n" % height)
+    w("static constexpr int16_t GLYPH_BASELINE = %d; // rows above the baseline\n\n" % baseline)
+    w("static const uint16_t GLYPH_ATLAS[%d * GLYPH_H] PROGMEM = {\n" % (LAST - FIRST + 1))
+    for c, rows in rows_out:
+        label = "space" if c == 0x20 else "'%s'" % ("\\\\" if c == 0x5C else chr(c))
+        w("\t// %s\n\t" % label)
+        w(", ".join("0x%04X" % r for r in rows))
+        w(",\n")
+    w("};\n")
+
+
+if __name__ == "__main__":
+    main()
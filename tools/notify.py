@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""Host stand-in notifier for connected standby (main/StandbyChannel.*).
+
+Devices subscribe with a UDP datagram "SUB1 <listenPort>\\n" (resent every minute);
+the notifier answers each trigger with "NOTIFY1 <seq>\\n" to every live subscriber.
+Triggers: --pbm FILE changes (mtime), --every N seconds, or Enter on stdin.
+
+    python3 tools/notify.py --port 3002 --pbm items.pbm
+"""
+
+import argparse
+import os
+import select
+import socket
+import sys
+import time
+
+SUBSCRIPTION_TTL = 180.0  # three missed SUB1 keepalives
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--port", type=int, default=3002)
+    ap.add_argument("--bind", default="0.0.0.0")
+    ap.add_argument("--pbm", help="notify when this file changes")
+    ap.add_argument("--every", type=float, default=0.0, help="also notify every N seconds")
+    args = ap.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+    print("notifier on udp %s:%d" % (args.bind, args.port), flush=True)
+
+    subscribers = {}  # (ip, port) -> last SUB1 time
+    seq = 0
+    mtime = os.stat(args.pbm).st_mtime if args.pbm else None
+    last_periodic = time.time()
+    watch = [sock] + ([sys.stdin] if sys.stdin.isatty() else [])
+
+    while True:
+        ready, _, _ = select.select(watch, [], [], 0.5)
+        now = time.time()
+        trigger = None
+
+        if sock in ready:
+            data, (ip, _) = sock.recvfrom(64)
+            parts = data.decode("ascii", "replace").split()
+            if len(parts) == 2 and parts[0] == "SUB1" and parts[1].isdigit():
+                key = (ip, int(parts[1]))
+                if key not in subscribers:
+                    print("subscribe %s:%d" % key, flush=True)
+                subscribers[key] = now
+        if sys.stdin in ready:
+            sys.stdin.readline()
+            trigger = "manual"
+        if args.pbm:
+            m = os.stat(args.pbm).st_mtime
+            if m != mtime:
+                mtime = m
+                trigger = "file changed"
+        if args.every and now - last_periodic >= args.every:
+            last_periodic = now
+            trigger = "periodic"
+
+        for key in [k for k, t in subscribers.items() if now - t > SUBSCRIPTION_TTL]:
+            print("expire %s:%d" % key, flush=True)
+            del subscribers[key]
+
+        if trigger and subscribers:
+            seq += 1
+            for key in subscribers:
+                sock.sendto(b"NOTIFY1 %d\n" % seq, key)
+            print("notify seq=%d (%s) -> %d device(s)" % (seq, trigger, len(subscribers)), flush=True)
+
+
+if __name__ == "__main__":
+    main()
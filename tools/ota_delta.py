@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""Build a firmware delta for the device's OtaUpdater (format in main/OtaUpdater.h).
+
+bsdiff-style, without the suffix sort: 8-byte seeds from a hash index of the old image
+anchor an alignment, which is then stretched forward while at least half the bytes agree
+(relinked code: same instructions, pointers off by a byte or two). Inside an alignment
+equal runs become COPY and the rest ADD (byte differences, mostly small); whatever no
+alignment covers is sent as INSERT. Standard library only.
+
+    python3 tools/ota_delta.py old.bin new.bin -o old-to-new.odl
+    python3 tools/ota_delta.py old.bin new.bin --check     # round trip, print sizes
+
+Images are named by the first 16 hex digits of their ELF SHA-256 (esp_app_desc_t), which
+is what the device sends as ?from=; image_id() reads it.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+SEED = 8          # bytes that anchor an alignment
+GIVE_UP = 32      # stop stretching once the score is this far below its best
+MIN_EQUAL = 3     # shorter equal runs inside an ADD stay in it (cheaper than a COPY op)
+
+OP_END, OP_COPY, OP_ADD, OP_INSERT, OP_SEEK = range(5)
+
+APP_DESC_OFFSET = 32          # image header (24) + first segment header (8)
+APP_DESC_MAGIC = 0xABCD5432
+ELF_SHA_OFFSET = APP_DESC_OFFSET + 144
+
+
+def image_id(image):
+    magic = struct.unpack_from("<I", image, APP_DESC_OFFSET)[0] if len(image) >= ELF_SHA_OFFSET + 32 else 0
+    if magic != APP_DESC_MAGIC:
+        raise ValueError("not an ESP32 app image (no esp_app_desc_t)")
+    return image[ELF_SHA_OFFSET:ELF_SHA_OFFSET + 8].hex()
+
+
+def varint(v):
+    out = bytearray()
+    while True:
+        b = v & 0x7F
+        v >>= 7
+        out.append(b | (0x80 if v else 0))
+        if not v:
+            return bytes(out)
+
+
+def zigzag(d):
+    return (d << 1) if d >= 0 else ((-d << 1) - 1)
+
+
+class Writer:
+    def __init__(self, old, new):
+        self.out = bytearray(b"ODL1")
+        self.out += struct.pack("<II", len(old), len(new))
+        self.out += hashlib.sha256(new).digest()
+
+    def op(self, code, n, data=b""):
+        self.out.append(code)
+        self.out += varint(n)
+        self.out += data
+
+    def aligned(self, new, j, old, i, n):
+        """new[j:j+n] against old[i:i+n]: COPY equal runs, ADD the rest."""
+        k = 0
+        while k < n:
+            e = k
+            while e < n and new[j + e] == old[i + e]:
+                e += 1
+            if e > k:
+                self.op(OP_COPY, e - k)
+                k = e
+                continue
+            while e < n and new[j + e:j + e + MIN_EQUAL] != old[i + e:i + e + MIN_EQUAL]:
+                e += 1
+            if n - e < MIN_EQUAL:
+                e = n
+            diff = bytes((new[j + x] - old[i + x]) & 0xFF for x in range(k, e))
+            self.op(OP_ADD, e - k, diff)
+            k = e
+
+
+def stretch(new, j, old, i):
+    """Length of the alignment new[j:] ~ old[i:] that maximises matches minus mismatches."""
+    score = best = best_len = 0
+    k = 0
+    limit = min(len(new) - j, len(old) - i)
+    while k < limit:
+        score += 1 if new[j + k] == old[i + k] else -1
+        k += 1
+        if score > best:
+            best, best_len = score, k
+        elif score < best - GIVE_UP:
+            break
+    return best_len
+
+
+def make_delta(old, new):
+    index = {}
+    for i in range(len(old) - SEED, -1, -1):
+        index[old[i:i + SEED]] = i  # lowest offset wins
+
+    w = Writer(old, new)
+    src = 0        # source cursor
+    lit = 0        # start of new bytes not yet covered
+    j = 0
+    while j + SEED <= len(new):
+        seed = new[j:j + SEED]
+        i = src + (j - lit) if old[src + (j - lit):src + (j - lit) + SEED] == seed else index.get(seed)
+        if i is None:
+            j += 1
+            continue
+
+        back = 0  # grow the alignment back into the uncovered bytes
+        while j - back > lit and i - back > 0 and new[j - back - 1] == old[i - back - 1]:
+            back += 1
+        j, i = j - back, i - back
+
+        n = stretch(new, j, old, i)
+        if j > lit:
+            w.op(OP_INSERT, j - lit, new[lit:j])
+        if i != src:
+            w.op(OP_SEEK, zigzag(i - src))
+        w.aligned(new, j, old, i, n)
+        src, j = i + n, j + n
+        lit = j
+
+    if lit < len(new):
+        w.op(OP_INSERT, len(new) - lit, new[lit:])
+    w.out.append(OP_END)
+    return bytes(w.out)
+
+
+def apply_delta(old, delta):
+    """Reference decoder (what OtaUpdater does on the device, minus the flash)."""
+    if delta[:4] != b"ODL1":
+        raise ValueError("bad magic")
+    src_len, dst_len = struct.unpack_from("<II", delta, 4)
+    want = delta[12:44]
+    if src_len != len(old):
+        raise ValueError("delta is for a %d-byte source, got %d" % (src_len, len(old)))
+
+    out = bytearray()
+    p, src = 44, 0
+
+    def operand():
+        nonlocal p
+        v = shift = 0
+        while True:
+            b = delta[p]
+            p += 1
+            v |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                return v
+
+    while True:
+        code = delta[p]
+        p += 1
+        if code == OP_END:
+            break
+        n = operand()
+        if code == OP_COPY:
+            out += old[src:src + n]
+            src += n
+        elif code == OP_ADD:
+            out += bytes((old[src + k] + delta[p + k]) & 0xFF for k in range(n))
+            src += n
+            p += n
+        elif code == OP_INSERT:
+            out += delta[p:p + n]
+            p += n
+        elif code == OP_SEEK:
+            src += (n >> 1) ^ -(n & 1)
+        else:
+            raise ValueError("unknown op %d" % code)
+
+    if len(out) != dst_len or hashlib.sha256(out).digest() != want:
+        raise ValueError("target mismatch")
+    return bytes(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("old", help="image the device runs")
+    ap.add_argument("new", help="image to update to")
+    ap.add_argument("-o", "--out", help="delta file (default: stdout)")
+    ap.add_argument("--check", action="store_true", help="apply the delta again and report sizes")
+    args = ap.parse_args()
+
+    with open(args.old, "rb") as f:
+        old = f.read()
+    with open(args.new, "rb") as f:
+        new = f.read()
+
+    delta = make_delta(old, new)
+    if args.check:
+        apply_delta(old, delta)
+        print("%d -> %d bytes: delta %d bytes (%.1f%% of the image)" %
+              (len(old), len(new), len(delta), 100.0 * len(delta) / len(new)), file=sys.stderr)
+    if args.out:
+        with open(args.out, "wb") as f:
+            f.write(delta)
+    elif not args.check:
+        sys.stdout.buffer.write(delta)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,149 @@
+#pragma once
+
+// Host simulator for the firmware: virtual clock, power meter, simulated WiFi link and an
+// in-process list-service (HTTP/1.1 keep-alive, Range/If-Range, tile deltas, chunked
+// bodies, Content-Digest). The firmware sources build unchanged against tools/sim/include.
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace sim
+{
+
+// ---------------- clock / power ----------------
+
+uint64_t nowUs();
+void advanceUs(uint64_t us);
+
+enum Load : uint8_t
+{
+	LOAD_CPU = 1,
+	LOAD_RADIO = 2, // associated / associating, RX listening + TX bursts averaged
+	LOAD_EPD = 4	// panel refresh in progress
+};
+void setLoad(uint8_t load, bool on);
+
+// Average currents (mA) of the board at the regulator output
+struct PowerModel
+{
+	double volts = 3.3;
+	double cpuMa = 50.0;   // ESP32 at 240 MHz, radio off
+	double radioMa = 70.0; // on top of the CPU while WiFi is up (19.5 dBm TX power)
+	double txRangeMa = 8.0; // radioMa drop from 19.5 dBm down to 2 dBm TX power (linear in dBm)
+	double epdMa = 8.0;	   // panel booster during a refresh
+};
+
+struct Meter
+{
+	uint64_t awakeUs = 0;
+	uint64_t radioUs = 0;
+	uint64_t epdUs = 0;
+	double microAmpHours = 0;
+	uint32_t rxBytes = 0;
+	uint32_t connects = 0;
+	uint32_t requests = 0;
+};
+
+PowerModel &power();
+Meter &meter();
+
+// ---------------- link / server ----------------
+
+static constexpr uint32_t NTP_UNREACHABLE = UINT32_MAX;
+
+struct LinkProfile
+{
+	uint32_t latencyMs = 3;		  // one way
+	uint32_t jitterMs = 0;		  // uniform 0..jitter added per segment (order preserved)
+	uint32_t bandwidthKbps = 20000; // bottleneck rate
+	uint16_t minSegment = 1460;	  // response bytes are delivered in random segments
+	uint16_t maxSegment = 1460;	  // of minSegment..maxSegment bytes
+	uint32_t stallAtByte = 0;	  // response byte offset of a one-off stall (0 = none)
+	uint32_t stallMs = 0;
+	uint32_t closeAtByte = 0; // server drops the connection after this many body+head bytes (0 = never)
+	uint8_t faultWake = 1;	  // wake the stall / close applies to (0 = every wake)
+	uint32_t assocMs = 900;	  // WiFi association + DHCP
+	uint32_t scanMs = 400;	  // part of assocMs spent scanning; skipped with a known channel + BSSID
+	int8_t rssi = -58;
+	uint32_t apOffMask = 0; // bit w-1: AP switched off during wake w
+	uint32_t dnsMs = 40;
+	uint32_t ntpMs = 0;	// SNTP answer delay; 0 = one round trip, NTP_UNREACHABLE = never
+	uint32_t tlsMs = 0; // > 0: endpoint is https; handshake crypto time on top of 2 extra RTTs
+};
+
+struct ServerProfile
+{
+	bool chunked = false; // Transfer-Encoding: chunked instead of Content-Length
+	uint16_t chunkBytes = 1024;
+	bool digest = true; // Content-Digest: sha-256
+	bool delta = true;	// answer X-Tile-Manifest with a tile-delta container
+	uint32_t thinkMs = 5;
+	uint8_t changedBandsPerWake = 2; // frame edits between wakes
+	uint8_t workers = 0;			 // > 0: server shared by a fleet, see serverBookings()
+};
+
+struct Config
+{
+	LinkProfile link;
+	ServerProfile server;
+	uint32_t seed = 1;
+	uint64_t mac = 0;			  // ESP.getEfuseMac(); 0 = derived from the seed
+	uint32_t batteryPinMv = 2000; // 4.0 V behind the 1:2 divider
+	uint32_t bootMs = 180;		  // ROM + bootloader before setup()
+	float dieTempC = 40.0f;		  // temperatureRead() at wake (room + self-heating)
+	bool verbose = false;		  // firmware Serial output to stdout
+};
+
+Config &config();
+
+// Server frame: P4 bitmap rows (1 = black); edited between wakes by beginWake()
+void setServerFrame(int w, int h, const std::vector<uint8_t> &bitmap);
+// Server content is an item list (sent to clients that accept one); the frame is its
+// rendering and beginWake() edits items instead of raw bands.
+void setServerItems(int w, int h, uint32_t seed);
+const std::vector<uint8_t> &serverFrame();
+
+// App partitions ota_0 / ota_1; ota_0 runs from power-on and esp_ota_set_boot_partition()
+// takes effect at the next wake (or esp_restart()). setServerOta() puts an "old" image in
+// ota_0 and has /ota/delta serve a delta to a relinked new one; without it the server
+// answers 204 (current).
+static constexpr uint32_t APP_PARTITION_BYTES = 0x50000;
+std::vector<uint8_t> &appPartition(int index);
+int runningPartition();
+void setServerOta(uint32_t seed);
+bool runningServerImage(); // the running partition starts with the server's new image
+
+// Fleet runs (wake_bench --fleet): with server.workers > 0 the list-service is shared with
+// other simulated devices. A request waits until one of the workers is free of everyone's
+// bookings, then holds it for thinkMs. All devices' virtual clocks count from the same
+// instant (a device powered on later starts its clock there), so bookings share a timeline.
+struct Booking
+{
+	uint64_t arriveUs; // request complete at the server
+	uint64_t startUs;  // a worker takes it
+	uint64_t endUs;	   // first response byte leaves
+	uint32_t device;   // Config::seed
+	uint8_t wake;
+};
+std::vector<Booking> &serverBookings();
+
+// Physical panel image (what the last refreshes left on the glass, 1 = white, native
+// order) and whether a GFX screen (status text, not modelled) was drawn since.
+std::vector<uint8_t> &panelImage();
+bool &panelShowsText();
+
+// ---------------- wakes ----------------
+
+struct DeepSleep
+{
+	uint64_t sleepUs;
+};
+
+// Resets the meter, applies the wake cause and the server's frame edits, charges bootMs.
+// wake is 1-based; wake 1 is a power-on.
+void beginWake(uint8_t wake);
+uint8_t currentWake();
+uint64_t requestedSleepUs();
+
+} // namespace sim
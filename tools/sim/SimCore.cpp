@@ -0,0 +1,690 @@
+// Virtual clock, power meter and the Arduino / ESP-IDF / GxEPD2 stand-ins.
+
+#include "Sim.h"
+
+#include <Arduino.h>
+#include <ESPmDNS.h>
+#include <GxEPD2_BW.h>
+#include <Preferences.h>
+#include <SPI.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <esp_bt.h>
+#include <esp_ota_ops.h>
+#include <esp_sleep.h>
+#include <esp_sntp.h>
+#include <esp_system.h>
+#include <esp_wifi.h>
+#include <lwip/dns.h>
+
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <sys/time.h>
+#include <time.h>
+
+namespace sim
+{
+
+static uint64_t gNowUs = 0;
+static uint64_t gBootUs = 0; // millis() / micros() / CCOUNT count from here (reset every boot)
+static uint8_t gLoad = 0;
+static PowerModel gPower;
+static Meter gMeter;
+static Config gConfig;
+static uint8_t gWake = 0;
+static bool gRestarted = false; // last wake ended in esp_restart()
+static esp_reset_reason_t gResetReason = ESP_RST_POWERON;
+static uint64_t gSleepUs = 0;
+static std::vector<uint8_t> gPanel;
+static bool gPanelText = false;
+static double gTxQuarterDbm = 78; // WiFi.setTxPower units
+static sntp_sync_status_t gSntp = SNTP_SYNC_STATUS_RESET;
+static std::vector<uint8_t> gAppFlash[2] = {std::vector<uint8_t>(APP_PARTITION_BYTES, 0xFF),
+											std::vector<uint8_t>(APP_PARTITION_BYTES, 0xFF)};
+static int gRunningApp = 0;
+static int gBootApp = 0;
+
+uint64_t nowUs() { return gNowUs; }
+
+// Work lwIP finishes in its own thread (SNTP answer, DNS reply), due at a virtual time
+struct Timer
+{
+	uint64_t dueUs;
+	std::function<void()> fire;
+};
+static std::vector<Timer> gTimers;
+
+static void schedule(uint64_t delayUs, std::function<void()> fire)
+{
+	gTimers.push_back({gNowUs + delayUs, std::move(fire)});
+}
+
+static void fireTimers()
+{
+	for (size_t i = 0; i < gTimers.size();)
+	{
+		if (gTimers[i].dueUs > gNowUs)
+		{
+			i++;
+			continue;
+		}
+		std::function<void()> fire = std::move(gTimers[i].fire);
+		gTimers.erase(gTimers.begin() + i);
+		fire();
+	}
+}
+
+void advanceUs(uint64_t us)
+{
+	if (gLoad & LOAD_CPU)
+	{
+		double ma = gPower.cpuMa;
+		gMeter.awakeUs += us;
+		if (gLoad & LOAD_RADIO)
+		{
+			ma += gPower.radioMa - gPower.txRangeMa * (78.0 - gTxQuarterDbm) / 70.0;
+			gMeter.radioUs += us;
+		}
+		if (gLoad & LOAD_EPD)
+		{
+			ma += gPower.epdMa;
+			gMeter.epdUs += us;
+		}
+		gMeter.microAmpHours += ma * 1000.0 * (double)us / 3600e6;
+	}
+	gNowUs += us;
+	if (!gTimers.empty())
+		fireTimers();
+}
+
+void setLoad(uint8_t load, bool on)
+{
+	if (on)
+		gLoad |= load;
+	else
+		gLoad &= ~load;
+}
+
+PowerModel &power() { return gPower; }
+Meter &meter() { return gMeter; }
+Config &config() { return gConfig; }
+std::vector<uint8_t> &panelImage() { return gPanel; }
+bool &panelShowsText() { return gPanelText; }
+uint8_t currentWake() { return gWake; }
+uint64_t requestedSleepUs() { return gSleepUs; }
+std::vector<uint8_t> &appPartition(int index) { return gAppFlash[index]; }
+int runningPartition() { return gRunningApp; }
+
+void editServerFrame(std::mt19937 &rng); // SimLink.cpp
+void resetLinks();
+
+void beginWake(uint8_t wake)
+{
+	static std::mt19937 rng;
+	if (wake == 1)
+		rng.seed(gConfig.seed * 7919u + 1);
+	else
+		editServerFrame(rng);
+
+	resetLinks();
+	gTimers.clear(); // whatever was in flight died with the last wake
+	gSntp = SNTP_SYNC_STATUS_RESET;
+	gWake = wake;
+	gResetReason = wake <= 1 ? ESP_RST_POWERON : (gRestarted ? ESP_RST_SW : ESP_RST_DEEPSLEEP);
+	gRestarted = false;
+	gRunningApp = gBootApp;
+	gSleepUs = 0;
+	gMeter = Meter();
+	gLoad = 0;
+	gTxQuarterDbm = 78; // PHY defaults come back with every boot
+	gBootUs = gNowUs;
+	setLoad(LOAD_CPU, true);
+	advanceUs((uint64_t)gConfig.bootMs * 1000);
+}
+
+} // namespace sim
+
+using namespace sim;
+
+// ---------------- Arduino core ----------------
+
+HardwareSerial Serial;
+EspClass ESP;
+const IPAddress INADDR_NONE;
+
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+size_t HardwareSerial::write(const uint8_t *b, size_t n)
+{
+	if (gConfig.verbose)
+		fwrite(b, 1, n, stdout);
+	return n;
+}
+void HardwareSerial::flush()
+{
+	if (gConfig.verbose)
+		fflush(stdout);
+}
+
+size_t Print::print(const IPAddress &ip) { return print(ip.toString()); }
+
+// Every clock read costs a microsecond so that polling loops always make progress.
+uint32_t millis()
+{
+	advanceUs(1);
+	return (uint32_t)((gNowUs - gBootUs) / 1000);
+}
+uint32_t micros()
+{
+	advanceUs(1);
+	return (uint32_t)(gNowUs - gBootUs);
+}
+void delay(uint32_t ms) { advanceUs((uint64_t)ms * 1000); }
+void delayMicroseconds(uint32_t us) { advanceUs(us); }
+void yield() {}
+
+void pinMode(int, int) {}
+int digitalRead(int) { return HIGH; } // buttons released, charger absent
+void digitalWrite(int, int) {}
+uint32_t analogReadMilliVolts(int)
+{
+	advanceUs(20);
+	return gConfig.batteryPinMv;
+}
+int analogRead(int) { return (int)(gConfig.batteryPinMv * 4095 / 3300); }
+void analogSetPinAttenuation(int, int) {}
+void analogReadResolution(int) {}
+float temperatureRead() { return gConfig.dieTempC; }
+static uint32_t gCpuMhz = 240;
+bool setCpuFrequencyMhz(uint32_t mhz)
+{
+	gCpuMhz = mhz;
+	return true;
+}
+uint32_t getCpuFrequencyMhz() { return gCpuMhz; }
+
+int Stream::timedRead()
+{
+	const uint32_t start = millis();
+	do
+	{
+		int c = read();
+		if (c >= 0)
+			return c;
+		delay(1);
+	} while (millis() - start < _timeout);
+	return -1;
+}
+
+String Stream::readStringUntil(char term)
+{
+	String s;
+	int c;
+	while ((c = timedRead()) >= 0 && c != term)
+		s += (char)c;
+	return s;
+}
+
+size_t Stream::readBytes(char *buf, size_t len)
+{
+	size_t n = 0;
+	int c;
+	while (n < len && (c = timedRead()) >= 0)
+		buf[n++] = (char)c;
+	return n;
+}
+
+uint32_t EspClass::getFreeHeap() { return 200000; }
+uint32_t EspClass::getMinFreeHeap() { return 190000; }
+uint32_t EspClass::getMaxAllocHeap() { return 110000; }
+uint32_t EspClass::getHeapSize() { return 300000; }
+uint32_t EspClass::getCycleCount() { return (uint32_t)((gNowUs - gBootUs) * gCpuMhz); }
+uint64_t EspClass::getEfuseMac() { return gConfig.mac ? gConfig.mac : 0x563412C40A24ull + gConfig.seed; }
+void EspClass::restart() { throw DeepSleep{0}; }
+
+// Wall clock follows the virtual clock (RTC caches, NTP sanity checks, rate limits).
+static constexpr time_t EPOCH_BASE = 1760000000;
+
+extern "C" int gettimeofday(struct timeval *tv, void *)
+{
+	tv->tv_sec = EPOCH_BASE + (time_t)(gNowUs / 1000000);
+	tv->tv_usec = (suseconds_t)(gNowUs % 1000000);
+	return 0;
+}
+
+extern "C" time_t time(time_t *out)
+{
+	const time_t t = EPOCH_BASE + (time_t)(gNowUs / 1000000);
+	if (out)
+		*out = t;
+	return t;
+}
+
+// SNTP: returns at once; the answer lands one round trip (or ntpMs) later
+
+void configTime(long, int, const char *, const char *, const char *)
+{
+	const uint32_t ms = gConfig.link.ntpMs ? gConfig.link.ntpMs : 2 * gConfig.link.latencyMs + 10;
+	if (ms != NTP_UNREACHABLE)
+		schedule((uint64_t)ms * 1000, [] { gSntp = SNTP_SYNC_STATUS_COMPLETED; });
+}
+sntp_sync_status_t sntp_get_sync_status(void) { return gSntp; }
+void sntp_set_sync_status(sntp_sync_status_t status) { gSntp = status; }
+
+bool btStop() { return true; }
+
+// ---------------- sleep ----------------
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause()
+{
+	return gWake <= 1 ? ESP_SLEEP_WAKEUP_UNDEFINED : ESP_SLEEP_WAKEUP_TIMER;
+}
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t us)
+{
+	gSleepUs = us;
+	return ESP_OK;
+}
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t, int) { return ESP_OK; }
+esp_err_t esp_sleep_enable_ext1_wakeup(uint64_t, esp_sleep_ext1_wakeup_mode_t) { return ESP_OK; }
+uint64_t esp_sleep_get_ext1_wakeup_status() { return 0; }
+esp_err_t esp_sleep_enable_gpio_wakeup() { return ESP_OK; }
+esp_err_t esp_sleep_enable_wifi_wakeup() { return ESP_OK; }
+esp_err_t esp_light_sleep_start() { return ESP_OK; }
+esp_err_t esp_wifi_set_protocol(wifi_interface_t, uint8_t) { return ESP_OK; }
+esp_err_t esp_wifi_set_bandwidth(wifi_interface_t, wifi_bandwidth_t) { return ESP_OK; }
+void esp_deep_sleep_start()
+{
+	setLoad(LOAD_CPU | LOAD_RADIO | LOAD_EPD, false);
+	throw DeepSleep{gSleepUs};
+}
+esp_reset_reason_t esp_reset_reason() { return gResetReason; }
+void esp_restart()
+{
+	gRestarted = true;
+	setLoad(LOAD_CPU | LOAD_RADIO | LOAD_EPD, false);
+	throw DeepSleep{0};
+}
+esp_err_t rtc_gpio_pullup_en(gpio_num_t) { return ESP_OK; }
+esp_err_t rtc_gpio_pulldown_dis(gpio_num_t) { return ESP_OK; }
+
+// ---------------- app partitions ----------------
+
+static esp_partition_t gAppParts[2] = {
+	{nullptr, ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, 0x10000, APP_PARTITION_BYTES, "ota_0", false},
+	{nullptr, ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, 0x10000 + APP_PARTITION_BYTES, APP_PARTITION_BYTES, "ota_1", false},
+};
+
+static int appIndex(const esp_partition_t *p)
+{
+	return p == &gAppParts[0] ? 0 : p == &gAppParts[1] ? 1 : -1;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *)
+{
+	for (const esp_partition_t &p : gAppParts)
+		if (p.type == type && (subtype == ESP_PARTITION_SUBTYPE_ANY || p.subtype == subtype))
+			return &p;
+	return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *p, size_t off, void *dst, size_t n)
+{
+	const int i = appIndex(p);
+	if (i < 0 || off + n > p->size)
+		return ESP_ERR_INVALID_ARG;
+	advanceUs(5 + n / 40); // ~40 MB/s through the cache
+	memcpy(dst, gAppFlash[i].data() + off, n);
+	return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *p, size_t off, const void *src, size_t n)
+{
+	const int i = appIndex(p);
+	if (i < 0 || off + n > p->size)
+		return ESP_ERR_INVALID_ARG;
+	advanceUs(100 + n * 3); // page program ~0.7 ms / 256 B
+	for (size_t k = 0; k < n; k++)
+		gAppFlash[i][off + k] &= ((const uint8_t *)src)[k];
+	return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *p, size_t off, size_t n)
+{
+	const int i = appIndex(p);
+	if (i < 0 || off % 4096 || n % 4096 || off + n > p->size)
+		return ESP_ERR_INVALID_ARG;
+	advanceUs((uint64_t)(n / 4096) * 45000); // 4 KB sector erase, typical
+	memset(gAppFlash[i].data() + off, 0xFF, n);
+	return ESP_OK;
+}
+
+const esp_partition_t *esp_ota_get_running_partition() { return &gAppParts[gRunningApp]; }
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *)
+{
+	return &gAppParts[1 - gRunningApp];
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *p)
+{
+	const int i = appIndex(p);
+	if (i < 0 || gAppFlash[i][0] != 0xE9) // image magic
+		return ESP_FAIL;
+	gBootApp = i;
+	return ESP_OK;
+}
+
+// Hex of esp_app_desc_t.app_elf_sha256 (image header 24 B + segment header 8 B + 144 B)
+int esp_ota_get_app_elf_sha256(char *dst, size_t size)
+{
+	const uint8_t *sha = gAppFlash[gRunningApp].data() + 176;
+	size_t n = 0;
+	for (; n + 1 < size && n < 64; n++)
+		dst[n] = "0123456789abcdef"[(sha[n / 2] >> (n % 2 ? 0 : 4)) & 15];
+	if (size)
+		dst[n] = '\0';
+	return (int)n;
+}
+
+esp_err_t esp_ota_mark_app_valid_cancel_rollback() { return ESP_OK; }
+
+// ---------------- WiFi (association; TCP lives in SimLink.cpp) ----------------
+
+WiFiClass WiFi;
+static bool gRadio = false;
+static uint64_t gAssocDoneUs = UINT64_MAX;
+static uint64_t gNoApUs = UINT64_MAX; // AP off: WL_NO_SSID_AVAIL from here on
+static uint8_t gBssid[6] = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+static String gSsid;
+
+static bool apOff()
+{
+	const uint8_t w = currentWake();
+	return w >= 1 && w <= 32 && (gConfig.link.apOffMask >> (w - 1)) & 1;
+}
+
+bool WiFiClass::mode(wifi_mode_t m)
+{
+	gRadio = (m != WIFI_OFF);
+	setLoad(LOAD_RADIO, gRadio);
+	if (!gRadio)
+		gAssocDoneUs = gNoApUs = UINT64_MAX;
+	return true;
+}
+// A known channel + BSSID skips the scan; a missing AP is reported once the scan (one
+// channel or all of them) comes up empty.
+wl_status_t WiFiClass::begin(const char *ssid, const char *, int32_t channel, const uint8_t *bssid, bool)
+{
+	mode(WIFI_STA);
+	gSsid = ssid ? ssid : "";
+	const bool known = channel > 0 && bssid;
+	const uint32_t scanMs = known ? 0 : gConfig.link.scanMs;
+	gAssocDoneUs = gNoApUs = UINT64_MAX;
+	if (apOff())
+		gNoApUs = gNowUs + (uint64_t)(known ? 250 : scanMs) * 1000;
+	else
+		gAssocDoneUs = gNowUs + (uint64_t)(gConfig.link.assocMs - gConfig.link.scanMs + scanMs) * 1000;
+	return WL_DISCONNECTED;
+}
+bool WiFiClass::disconnect(bool wifioff, bool)
+{
+	gAssocDoneUs = gNoApUs = UINT64_MAX;
+	if (wifioff)
+		mode(WIFI_OFF);
+	return true;
+}
+wl_status_t WiFiClass::status()
+{
+	if (gRadio && gNowUs >= gAssocDoneUs)
+		return WL_CONNECTED;
+	return (gRadio && gNowUs >= gNoApUs) ? WL_NO_SSID_AVAIL : WL_DISCONNECTED;
+}
+IPAddress WiFiClass::localIP() { return IPAddress(10, 0, 0, 2); }
+int8_t WiFiClass::RSSI() { return gConfig.link.rssi; }
+int32_t WiFiClass::channel() { return 6; }
+uint8_t *WiFiClass::BSSID() { return gBssid; }
+String WiFiClass::macAddress() { return String("24:0A:C4:12:34:56"); }
+uint8_t *WiFiClass::macAddress(uint8_t *mac)
+{
+	const uint64_t m = ESP.getEfuseMac();
+	for (int i = 0; i < 6; i++)
+		mac[i] = (uint8_t)(m >> (8 * i));
+	return mac;
+}
+int WiFiClass::hostByName(const char *host, IPAddress &ip)
+{
+	if (status() != WL_CONNECTED)
+		return 0;
+	if (!ip.fromString(host))
+	{
+		advanceUs((uint64_t)gConfig.link.dnsMs * 1000);
+		ip = IPAddress(10, 0, 0, 1);
+	}
+	return 1;
+}
+err_t dns_gethostbyname(const char *hostname, ip_addr_t *addr, dns_found_callback found, void *arg)
+{
+	IPAddress ip;
+	if (ip.fromString(hostname))
+	{
+		addr->u_addr.addr = (uint32_t)ip;
+		return ERR_OK;
+	}
+	if (WiFi.status() != WL_CONNECTED)
+		return ERR_ARG;
+
+	std::string name = hostname;
+	schedule((uint64_t)gConfig.link.dnsMs * 1000, [name, found, arg] {
+		ip_addr_t answer;
+		answer.u_addr.addr = (uint32_t)IPAddress(10, 0, 0, 1);
+		found(name.c_str(), &answer, arg);
+	});
+	return ERR_INPROGRESS;
+}
+bool WiFiClass::setTxPower(wifi_power_t p)
+{
+	gTxQuarterDbm = p;
+	return true;
+}
+wifi_power_t WiFiClass::getTxPower() { return (wifi_power_t)(int)gTxQuarterDbm; }
+bool WiFiClass::setSleep(bool) { return true; }
+bool WiFiClass::setSleep(wifi_ps_type_t) { return true; }
+int16_t WiFiClass::scanNetworks(bool, bool, bool, uint32_t msPerChannel, uint8_t channel, const char *ssid, const uint8_t *)
+{
+	mode(WIFI_STA);
+	if (ssid)
+		gSsid = ssid;
+	advanceUs((uint64_t)msPerChannel * 1000 * (channel ? 1 : 13));
+	return apOff() ? 0 : 1;
+}
+String WiFiClass::SSID(uint8_t) { return gSsid; }
+int32_t WiFiClass::RSSI(uint8_t) { return gConfig.link.rssi; }
+int32_t WiFiClass::channel(uint8_t) { return 6; }
+uint8_t *WiFiClass::BSSID(uint8_t) { return gBssid; }
+void WiFiClass::scanDelete() {}
+bool WiFiClass::setAutoReconnect(bool) { return true; }
+bool WiFiClass::persistent(bool) { return true; }
+
+// No notifier on the simulated network: standby subscribes but never hears back.
+uint8_t WiFiUDP::begin(uint16_t) { return 1; }
+void WiFiUDP::stop() {}
+int WiFiUDP::beginPacket(IPAddress, uint16_t) { return 1; }
+int WiFiUDP::beginPacket(const char *, uint16_t) { return 1; }
+int WiFiUDP::endPacket() { return 1; }
+size_t WiFiUDP::write(uint8_t) { return 1; }
+size_t WiFiUDP::write(const uint8_t *, size_t n) { return n; }
+int WiFiUDP::parsePacket() { return 0; }
+int WiFiUDP::available() { return 0; }
+int WiFiUDP::read() { return -1; }
+int WiFiUDP::read(uint8_t *, size_t) { return 0; }
+IPAddress WiFiUDP::remoteIP() { return IPAddress(); }
+uint16_t WiFiUDP::remotePort() { return 0; }
+
+MDNSResponder MDNS;
+bool MDNSResponder::begin(const char *) { return true; }
+void MDNSResponder::end() {}
+IPAddress MDNSResponder::queryHost(const char *, uint32_t) { return IPAddress(10, 0, 0, 1); }
+
+SPIClass SPI;
+void SPIClass::begin(int8_t, int8_t, int8_t, int8_t) {}
+
+// ---------------- NVS (survives wakes, like flash) ----------------
+
+static std::map<std::string, std::vector<uint8_t>> gNvs;
+static std::string gNvsNs;
+
+static std::string nvsKey(const char *key) { return gNvsNs + "/" + key; }
+
+bool Preferences::begin(const char *name, bool, const char *)
+{
+	gNvsNs = name;
+	return true;
+}
+void Preferences::end() {}
+bool Preferences::clear()
+{
+	for (auto it = gNvs.begin(); it != gNvs.end();)
+		it = (it->first.compare(0, gNvsNs.size() + 1, gNvsNs + "/") == 0) ? gNvs.erase(it) : std::next(it);
+	return true;
+}
+bool Preferences::remove(const char *key) { return gNvs.erase(nvsKey(key)) > 0; }
+bool Preferences::isKey(const char *key) { return gNvs.count(nvsKey(key)) > 0; }
+size_t Preferences::putBytes(const char *key, const void *value, size_t len)
+{
+	advanceUs(2000 + len * 2); // flash write
+	gNvs[nvsKey(key)].assign((const uint8_t *)value, (const uint8_t *)value + len);
+	return len;
+}
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen)
+{
+	auto it = gNvs.find(nvsKey(key));
+	if (it == gNvs.end() || it->second.size() > maxLen)
+		return 0;
+	advanceUs(200 + it->second.size() / 10);
+	memcpy(buf, it->second.data(), it->second.size());
+	return it->second.size();
+}
+size_t Preferences::getBytesLength(const char *key)
+{
+	auto it = gNvs.find(nvsKey(key));
+	return it == gNvs.end() ? 0 : it->second.size();
+}
+size_t Preferences::putUInt(const char *key, uint32_t v) { return putBytes(key, &v, 4); }
+uint32_t Preferences::getUInt(const char *key, uint32_t d)
+{
+	uint32_t v;
+	return getBytes(key, &v, 4) == 4 ? v : d;
+}
+size_t Preferences::putString(const char *key, const char *v) { return putBytes(key, v, strlen(v) + 1); }
+size_t Preferences::getString(const char *key, char *v, size_t maxLen) { return getBytes(key, v, maxLen); }
+
+// ---------------- GxEPD2 ----------------
+
+GxEPD2_EPD::GxEPD2_EPD(uint16_t w, uint16_t h, uint16_t fullMs, uint16_t partialMs, uint16_t fastMs)
+	: WIDTH(w), HEIGHT(h), _fullMs(fullMs), _partialMs(partialMs), _fastMs(fastMs), _ram((size_t)w * h / 8, 0xFF)
+{
+	if (gPanel.size() != _ram.size())
+		gPanel.assign(_ram.size(), 0xFF);
+}
+
+void GxEPD2_EPD::spiBytes(size_t n)
+{
+	advanceUs(n * 8 / 4); // 4 MHz
+}
+
+void GxEPD2_EPD::blit(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap,
+					  int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool store)
+{
+	const int srcBpr = (w_bitmap + 7) / 8;
+	const int dstBpr = WIDTH / 8;
+	for (int row = 0; row < h; row++)
+	{
+		for (int col = 0; col < w; col++)
+		{
+			const int sx = x_part + col;
+			const int sy = y_part + row;
+			const int dx = x + col;
+			const int dy = y + row;
+			if (dx < 0 || dy < 0 || dx >= WIDTH || dy >= HEIGHT)
+				continue;
+			bool bit = (bitmap[sy * srcBpr + sx / 8] >> (7 - sx % 8)) & 1;
+			if (invert)
+				bit = !bit;
+			if (!store)
+				continue;
+			uint8_t &d = _ram[(size_t)dy * dstBpr + dx / 8];
+			const uint8_t m = (uint8_t)(0x80 >> (dx % 8));
+			d = bit ? (d | m) : (d & ~m);
+		}
+	}
+	spiBytes((size_t)h * ((w + 7) / 8));
+}
+
+void GxEPD2_EPD::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool, bool)
+{
+	blit(bitmap, 0, 0, w, x, y, w, h, invert, true);
+}
+void GxEPD2_EPD::writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool, bool)
+{
+	blit(bitmap, 0, 0, w, x, y, w, h, invert, false); // "previous" RAM: timing only
+}
+void GxEPD2_EPD::writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool, bool)
+{
+	blit(bitmap, x_part, y_part, w_bitmap, x, y, w, h, invert, true);
+}
+void GxEPD2_EPD::writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool, bool)
+{
+	blit(bitmap, x_part, y_part, w_bitmap, x, y, w, h, invert, false);
+}
+
+void GxEPD2_EPD::blit4G(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap,
+						int16_t x, int16_t y, int16_t w, int16_t h)
+{
+	const int srcBpr = (w_bitmap + 3) / 4;
+	const int dstBpr = WIDTH / 8;
+	for (int row = 0; row < h; row++)
+	{
+		for (int col = 0; col < w; col++)
+		{
+			const int sx = x_part + col;
+			const int dx = x + col;
+			const int dy = y + row;
+			if (dx < 0 || dy < 0 || dx >= WIDTH || dy >= HEIGHT)
+				continue;
+			const uint8_t level = (bitmap[(y_part + row) * srcBpr + sx / 4] >> (6 - 2 * (sx % 4))) & 3;
+			uint8_t &d = _ram[(size_t)dy * dstBpr + dx / 8];
+			const uint8_t m = (uint8_t)(0x80 >> (dx % 8));
+			d = level >= 2 ? (d | m) : (d & ~m);
+		}
+	}
+	spiBytes((size_t)h * ((w + 3) / 4)); // both controller planes
+}
+
+void GxEPD2_EPD::gfxPageShown()
+{
+	gPanelText = true;
+}
+
+static void busy(uint32_t ms)
+{
+	setLoad(LOAD_EPD, true);
+	advanceUs((uint64_t)ms * 1000);
+	setLoad(LOAD_EPD, false);
+}
+
+void GxEPD2_EPD::refresh(bool partial_update_mode)
+{
+	gPanel = _ram;
+	gPanelText = false;
+	busy(partial_update_mode ? _partialMs : (fastFull() && _fastMs ? _fastMs : _fullMs));
+}
+
+void GxEPD2_EPD::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+	const int bpr = WIDTH / 8;
+	for (int row = y; row < y + h && row < HEIGHT; row++)
+		for (int b = x / 8; b < (x + w + 7) / 8 && b < bpr; b++)
+			gPanel[(size_t)row * bpr + b] = _ram[(size_t)row * bpr + b];
+	gPanelText = false;
+	busy(_partialMs);
+}
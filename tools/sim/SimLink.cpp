@@ -0,0 +1,737 @@
+// Simulated TCP link and in-process list-service (see tools/list_server.py for the
+// reference server this mirrors).
+
+#include "Sim.h"
+
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+
+#include "Digest.h"
+#include "ItemList.h"
+#include "TileDelta.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <strings.h>
+
+namespace sim
+{
+
+struct Conn
+{
+	std::vector<uint8_t> rx;							  // every byte the server has sent
+	std::vector<std::pair<size_t, uint64_t>> arrivals; // (end offset, arrival time), ascending
+	size_t readPos = 0;
+	uint64_t closeUs = UINT64_MAX;	   // peer close reaches us
+	uint64_t serverFreeUs = 0;		   // server's send side busy until
+	size_t sentBytes = 0;			   // response bytes on this connection (fault offsets)
+	bool stalled = false;
+	std::string request;
+};
+
+static std::map<int, Conn> gConns;
+static int gNextConn = 1;
+static std::mt19937 gRng;
+
+static int gFrameW = 0;
+static int gFrameH = 0;
+static std::vector<uint8_t> gFrame;
+
+void setServerFrame(int w, int h, const std::vector<uint8_t> &bitmap)
+{
+	gFrameW = w;
+	gFrameH = h;
+	gFrame = bitmap;
+}
+
+const std::vector<uint8_t> &serverFrame() { return gFrame; }
+
+// Item-list content: the frame is always the device-side rendering of gItems
+static std::vector<std::pair<uint8_t, std::string>> gItems;
+
+static std::vector<uint8_t> itemPayload()
+{
+	std::vector<uint8_t> p = {'I', 'L', 'S', '1', (uint8_t)gItems.size()};
+	for (const auto &it : gItems)
+	{
+		p.push_back(it.first);
+		p.push_back((uint8_t)it.second.size());
+		p.insert(p.end(), it.second.begin(), it.second.end());
+	}
+	return p;
+}
+
+static void renderServerItems()
+{
+	const std::vector<uint8_t> p = itemPayload();
+	renderItemList(p.data(), p.size(), gFrame.data(), gFrameW, gFrameH, nullptr);
+}
+
+static const char *const ITEM_WORDS[] = {"milk", "bread", "eggs", "coffee beans", "apples", "rice",
+										 "olive oil", "tomatoes", "cheese", "dish soap", "batteries AA"};
+
+void setServerItems(int w, int h, uint32_t seed)
+{
+	gFrameW = w;
+	gFrameH = h;
+	gFrame.assign((size_t)((w + 7) / 8) * h, 0);
+
+	std::mt19937 rng(seed);
+	gItems.clear();
+	gItems.push_back({ITEM_HEADING, "Shopping list"});
+	for (int i = 1; i < h / ITEM_PITCH; i++)
+	{
+		std::string text = ITEM_WORDS[rng() % (sizeof(ITEM_WORDS) / sizeof(ITEM_WORDS[0]))];
+		text += " x" + std::to_string(1 + rng() % 4);
+		gItems.push_back({(uint8_t)(rng() % 4 == 0 ? ITEM_DONE : 0), text});
+	}
+	renderServerItems();
+}
+
+void editServerFrame(std::mt19937 &rng)
+{
+	if (!gItems.empty())
+	{
+		// One item edit touches the two bands of its row
+		for (int i = 0; i < (config().server.changedBandsPerWake + 1) / 2; i++)
+		{
+			auto &it = gItems[1 + rng() % (gItems.size() - 1)];
+			if (rng() % 2)
+				it.first ^= ITEM_DONE;
+			else
+				it.second.back() = (char)('1' + rng() % 9);
+		}
+		renderServerItems();
+		return;
+	}
+
+	const TileGeometry geo = {gFrameW, gFrameH};
+	for (int i = 0; i < config().server.changedBandsPerWake; i++)
+	{
+		const int band = (int)(rng() % (uint32_t)geo.bandCount());
+		uint8_t *p = gFrame.data() + geo.bandOffset(band);
+		const uint8_t v = (uint8_t)rng();
+		for (size_t k = 0; k < geo.bandBytes(band); k++)
+			p[k] ^= (uint8_t)(v + k);
+	}
+}
+
+void resetLinks()
+{
+	gConns.clear();
+	gRng.seed(config().seed * 104729u + currentWake());
+}
+
+static bool faultsActive()
+{
+	const uint8_t w = config().link.faultWake;
+	return w == 0 || w == currentWake();
+}
+
+static uint64_t jitterUs()
+{
+	const uint32_t j = config().link.jitterMs;
+	return j ? (uint64_t)(gRng() % (j * 1000 + 1)) : 0;
+}
+
+// ---------------- server ----------------
+
+static std::string header(const std::string &req, const char *name)
+{
+	const size_t n = strlen(name);
+	size_t pos = req.find("\r\n");
+	while (pos != std::string::npos && pos + 2 < req.size())
+	{
+		const size_t end = req.find("\r\n", pos + 2);
+		const std::string line = req.substr(pos + 2, end - pos - 2);
+		if (line.size() > n && line[n] == ':' && strncasecmp(line.c_str(), name, n) == 0)
+		{
+			size_t v = n + 1;
+			while (v < line.size() && line[v] == ' ')
+				v++;
+			return line.substr(v);
+		}
+		pos = end;
+	}
+	return std::string();
+}
+
+static std::vector<uint8_t> base64Decode(const std::string &in)
+{
+	std::vector<uint8_t> out;
+	uint32_t acc = 0;
+	int bits = 0;
+	for (char c : in)
+	{
+		int v;
+		if (c >= 'A' && c <= 'Z')
+			v = c - 'A';
+		else if (c >= 'a' && c <= 'z')
+			v = c - 'a' + 26;
+		else if (c >= '0' && c <= '9')
+			v = c - '0' + 52;
+		else if (c == '+')
+			v = 62;
+		else if (c == '/')
+			v = 63;
+		else
+			continue;
+		acc = (acc << 6) | (uint32_t)v;
+		bits += 6;
+		if (bits >= 8)
+		{
+			bits -= 8;
+			out.push_back((uint8_t)(acc >> bits));
+		}
+	}
+	return out;
+}
+
+static std::string base64Encode(const uint8_t *p, size_t n)
+{
+	static const char *T = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	std::string out;
+	for (size_t i = 0; i < n; i += 3)
+	{
+		uint32_t v = (uint32_t)p[i] << 16;
+		if (i + 1 < n)
+			v |= (uint32_t)p[i + 1] << 8;
+		if (i + 2 < n)
+			v |= p[i + 2];
+		out += T[(v >> 18) & 63];
+		out += T[(v >> 12) & 63];
+		out += (i + 1 < n) ? T[(v >> 6) & 63] : '=';
+		out += (i + 2 < n) ? T[v & 63] : '=';
+	}
+	return out;
+}
+
+static bool buildDelta(const std::string &manifest, std::vector<uint8_t> &out)
+{
+	const std::string prefix = "v1;rows=" + std::to_string(TILE_ROWS) + ";";
+	if (manifest.compare(0, prefix.size(), prefix) != 0)
+		return false;
+
+	const TileGeometry geo = {gFrameW, gFrameH};
+	const std::vector<uint8_t> raw = base64Decode(manifest.substr(prefix.size()));
+	if (raw.size() != (size_t)geo.bandCount() * 4)
+		return false;
+
+	out = {'T', 'D', 'L', '1', (uint8_t)gFrameW, (uint8_t)(gFrameW >> 8),
+		   (uint8_t)gFrameH, (uint8_t)(gFrameH >> 8), (uint8_t)TILE_ROWS, 0};
+	for (int band = 0; band < geo.bandCount(); band++)
+	{
+		const uint8_t *p = gFrame.data() + geo.bandOffset(band);
+		uint32_t have;
+		memcpy(&have, &raw[(size_t)band * 4], 4);
+		if (tileHash(p, geo.bandBytes(band)) == have)
+			continue;
+		out.push_back((uint8_t)band);
+		out.insert(out.end(), p, p + geo.bandBytes(band));
+		out[9]++;
+	}
+	return true;
+}
+
+static std::string entityTag(const std::vector<uint8_t> &entity)
+{
+	char buf[24];
+	snprintf(buf, sizeof(buf), "\"%08x\"", (unsigned)tileHash(entity.data(), entity.size()));
+	return buf;
+}
+
+// ---------------- OTA delta (tools/ota_delta.py format) ----------------
+
+static std::vector<uint8_t> gOtaOld;
+static std::vector<uint8_t> gOtaNew;
+static std::vector<uint8_t> gOtaDelta;
+
+static constexpr size_t ELF_SHA_OFFSET = 176; // esp_app_desc_t.app_elf_sha256 in the image
+
+static std::string imageId(const std::vector<uint8_t> &image)
+{
+	char id[17];
+	for (int i = 0; i < 8; i++)
+		snprintf(id + 2 * i, 3, "%02x", image[ELF_SHA_OFFSET + i]);
+	return id;
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+	for (int i = 0; i < 4; i++)
+		p[i] = (uint8_t)(v >> (8 * i));
+}
+
+// Code-like bytes: a few common opcodes, and every 16th word a pointer into the image
+static std::vector<uint8_t> makeImage(std::mt19937 &rng, size_t len)
+{
+	static const uint8_t OPS[] = {0x06, 0x0c, 0x1d, 0x20, 0x22, 0x25, 0x36, 0x41, 0x81, 0xa2, 0xe0, 0xf0};
+	std::vector<uint8_t> img(len);
+	for (size_t i = 0; i < len; i++)
+		img[i] = (rng() % 3) ? OPS[rng() % sizeof(OPS)] : (uint8_t)rng();
+	for (size_t i = 256; i + 4 <= len; i += 64)
+		put32(&img[i], 0x400D0000u + (uint32_t)(rng() % len));
+
+	img[0] = 0xE9; // image header magic
+	put32(&img[32], 0xABCD5432u); // esp_app_desc_t magic
+	for (size_t i = 0; i < 32; i++)
+		img[ELF_SHA_OFFSET + i] = (uint8_t)rng();
+	return img;
+}
+
+static void deltaOp(std::vector<uint8_t> &d, uint8_t code, uint32_t v)
+{
+	d.push_back(code);
+	do
+	{
+		d.push_back((uint8_t)((v & 0x7F) | (v > 0x7F ? 0x80 : 0)));
+		v >>= 7;
+	} while (v);
+}
+
+// nw[0, n) against the source at the cursor: COPY what is equal, ADD the rest
+static void alignedOps(std::vector<uint8_t> &d, const uint8_t *nw, const uint8_t *old, size_t n)
+{
+	size_t k = 0;
+	while (k < n)
+	{
+		size_t e = k;
+		while (e < n && nw[e] == old[e])
+			e++;
+		if (e > k)
+		{
+			deltaOp(d, 1, (uint32_t)(e - k));
+			k = e;
+			continue;
+		}
+		while (e < n && !(e + 4 <= n && !memcmp(nw + e, old + e, 4)))
+			e++;
+		deltaOp(d, 2, (uint32_t)(e - k));
+		for (size_t i = k; i < e; i++)
+			d.push_back((uint8_t)(nw[i] - old[i]));
+		k = e;
+	}
+}
+
+void setServerOta(uint32_t seed)
+{
+	std::mt19937 rng(seed * 31337u + 7);
+	gOtaOld = makeImage(rng, 256 * 1024);
+
+	// Relinked build: 1500 bytes of new code at a, 800 bytes dropped at b; pointers past
+	// each edit move with it.
+	const size_t a = gOtaOld.size() * 2 / 5, b = gOtaOld.size() * 7 / 10;
+	const size_t ins = 1500, del = 800;
+	std::vector<uint8_t> added = makeImage(rng, ins);
+	gOtaNew.assign(gOtaOld.begin(), gOtaOld.begin() + (long)a);
+	gOtaNew.insert(gOtaNew.end(), added.begin(), added.end());
+	gOtaNew.insert(gOtaNew.end(), gOtaOld.begin() + (long)a, gOtaOld.begin() + (long)b);
+	gOtaNew.insert(gOtaNew.end(), gOtaOld.begin() + (long)(b + del), gOtaOld.end());
+	for (size_t i = 256; i + 4 <= gOtaOld.size(); i += 64)
+	{
+		if ((i < a && i + 4 > a) || (i + 4 > b && i < b + del))
+			continue;
+		const size_t at = i < a ? i : i < b ? i + ins : i + ins - del;
+		uint32_t ptr = 0;
+		memcpy(&ptr, &gOtaOld[i], 4);
+		const uint32_t target = ptr - 0x400D0000u;
+		put32(&gOtaNew[at], ptr + (target >= a ? ins : 0) - (target >= b ? del : 0));
+	}
+	for (size_t i = 0; i < 32; i++)
+		gOtaNew[ELF_SHA_OFFSET + i] = (uint8_t)rng();
+
+	StreamDigest sha;
+	sha.begin(DigestAlgo::Sha256);
+	sha.update(gOtaNew.data(), gOtaNew.size());
+	gOtaDelta.assign({'O', 'D', 'L', '1'});
+	gOtaDelta.resize(12 + 32);
+	put32(&gOtaDelta[4], (uint32_t)gOtaOld.size());
+	put32(&gOtaDelta[8], (uint32_t)gOtaNew.size());
+	sha.finish(&gOtaDelta[12]);
+
+	alignedOps(gOtaDelta, gOtaNew.data(), gOtaOld.data(), a);
+	deltaOp(gOtaDelta, 3, ins);
+	gOtaDelta.insert(gOtaDelta.end(), gOtaNew.begin() + (long)a, gOtaNew.begin() + (long)(a + ins));
+	alignedOps(gOtaDelta, gOtaNew.data() + a + ins, gOtaOld.data() + a, b - a);
+	deltaOp(gOtaDelta, 4, del * 2); // zigzag +del
+	alignedOps(gOtaDelta, gOtaNew.data() + b + ins, gOtaOld.data() + b + del, gOtaOld.size() - b - del);
+	gOtaDelta.push_back(0);
+
+	std::vector<uint8_t> &flash = appPartition(0);
+	std::copy(gOtaOld.begin(), gOtaOld.end(), flash.begin());
+}
+
+bool runningServerImage()
+{
+	const std::vector<uint8_t> &flash = appPartition(runningPartition());
+	return !gOtaNew.empty() && std::equal(gOtaNew.begin(), gOtaNew.end(), flash.begin());
+}
+
+static std::vector<uint8_t> buildResponse(const std::string &req)
+{
+	const ServerProfile &sp = config().server;
+
+	const size_t sp1 = req.find(' ');
+	const size_t sp2 = req.find(' ', sp1 + 1);
+	const std::string path = req.substr(sp1 + 1, sp2 - sp1 - 1);
+
+	int code = 200;
+	std::string ctype = "image/x-portable-bitmap";
+	std::string extra;
+	std::vector<uint8_t> body;
+
+	// Gray clients (FRAME_GRAY builds) get a P5 of the same frame with all four levels:
+	// light gray on white rows, dark gray on black ones, so thresholding gives the P4 back.
+	const bool ota = path.compare(0, 10, "/ota/delta") == 0;
+	const bool gray = header(req, "Accept").find("graymap") != std::string::npos;
+	std::vector<uint8_t> entity;
+	if (ota)
+	{
+		ctype = "application/x-ota-delta";
+		if (!gOtaDelta.empty() && path.find("from=" + imageId(gOtaOld)) != std::string::npos)
+			entity = gOtaDelta;
+		else
+			code = 204; // current (or an image this server has no delta from)
+	}
+	else
+	{
+		char head[32];
+		snprintf(head, sizeof(head), gray ? "P5\n%d %d\n255\n" : "P4\n%d %d\n", gFrameW, gFrameH);
+		entity.assign(head, head + strlen(head));
+		if (gray)
+		{
+			ctype = "image/x-portable-graymap";
+			const int bpr = (gFrameW + 7) / 8;
+			for (int y = 0; y < gFrameH; y++)
+				for (int x = 0; x < gFrameW; x++)
+				{
+					const bool black = (gFrame[(size_t)y * bpr + x / 8] >> (7 - x % 8)) & 1;
+					entity.push_back(black ? (y % 4 ? 0 : 85) : (y % 4 ? 255 : 170));
+				}
+		}
+		else
+		{
+			entity.insert(entity.end(), gFrame.begin(), gFrame.end());
+		}
+	}
+	const std::string etag = entityTag(entity);
+
+	const std::string manifest = header(req, "X-Tile-Manifest");
+	const std::string range = header(req, "Range");
+	const std::string ifRange = header(req, "If-Range");
+
+	if (!ota && path.compare(0, 15, "/list/items.pbm") != 0)
+	{
+		code = 404;
+		ctype = "text/plain";
+		const char *msg = "not found\n";
+		body.assign(msg, msg + strlen(msg));
+	}
+	else if (code == 204)
+	{
+	}
+	else if (!ota && !gItems.empty() && header(req, "Accept").find("application/x-item-list") != std::string::npos)
+	{
+		ctype = "application/x-item-list";
+		body = itemPayload();
+		extra += "ETag: " + entityTag(body) + "\r\n";
+	}
+	else if (!ota && sp.delta && !manifest.empty() && range.empty() && buildDelta(manifest, body))
+	{
+		ctype = "application/x-tile-delta";
+		extra += "ETag: " + etag + "\r\n";
+	}
+	else if (range.compare(0, 6, "bytes=") == 0 && (ifRange.empty() || ifRange == etag) &&
+			 strtoul(range.c_str() + 6, nullptr, 10) < entity.size())
+	{
+		const size_t start = strtoul(range.c_str() + 6, nullptr, 10);
+		code = 206;
+		body.assign(entity.begin() + (long)start, entity.end());
+		extra += "ETag: " + etag + "\r\n";
+		extra += "Content-Range: bytes " + std::to_string(start) + "-" + std::to_string(entity.size() - 1) +
+				 "/" + std::to_string(entity.size()) + "\r\n";
+	}
+	else
+	{
+		body = entity;
+		extra += "ETag: " + etag + "\r\n";
+	}
+
+	if (sp.digest && !body.empty())
+	{
+		StreamDigest d;
+		d.begin(DigestAlgo::Sha256);
+		d.update(body.data(), body.size());
+		uint8_t h[32];
+		d.finish(h);
+		extra += "Content-Digest: sha-256=:" + base64Encode(h, 32) + ":\r\n";
+	}
+
+	std::string h = "HTTP/1.1 " + std::to_string(code) + (code == 200 ? " OK" : code == 204 ? " No Content" : code == 206 ? " Partial Content" : " Not Found") + "\r\n";
+	h += "Content-Type: " + ctype + "\r\n" + extra;
+	h += "Connection: keep-alive\r\n";
+
+	std::vector<uint8_t> out;
+	if (sp.chunked)
+	{
+		h += "Transfer-Encoding: chunked\r\n\r\n";
+		out.assign(h.begin(), h.end());
+		for (size_t i = 0; i < body.size(); i += sp.chunkBytes)
+		{
+			const size_t n = std::min(body.size() - i, (size_t)sp.chunkBytes);
+			char sz[16];
+			snprintf(sz, sizeof(sz), "%zx\r\n", n);
+			out.insert(out.end(), sz, sz + strlen(sz));
+			out.insert(out.end(), body.begin() + (long)i, body.begin() + (long)(i + n));
+			out.push_back('\r');
+			out.push_back('\n');
+		}
+		const char *last = "0\r\n\r\n";
+		out.insert(out.end(), last, last + 5);
+	}
+	else
+	{
+		h += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+		out.assign(h.begin(), h.end());
+		out.insert(out.end(), body.begin(), body.end());
+	}
+	return out;
+}
+
+static std::vector<Booking> gBookings;
+
+std::vector<Booking> &serverBookings() { return gBookings; }
+
+static unsigned busyAt(uint64_t t)
+{
+	unsigned n = 0;
+	for (const Booking &b : gBookings)
+		n += b.startUs <= t && t < b.endUs;
+	return n;
+}
+
+// Earliest start >= arriveUs at which fewer than `workers` bookings overlap [start, start + d).
+// The worker count only rises at a booking's start, so those are the instants to check.
+static uint64_t serverSlot(uint64_t arriveUs, uint64_t d, unsigned workers)
+{
+	std::vector<uint64_t> starts = {arriveUs};
+	for (const Booking &b : gBookings)
+		if (b.endUs > arriveUs)
+			starts.push_back(b.endUs);
+	std::sort(starts.begin(), starts.end());
+
+	for (uint64_t s : starts)
+	{
+		bool free = busyAt(s) < workers;
+		for (size_t i = 0; free && i < gBookings.size(); i++)
+			if (gBookings[i].startUs > s && gBookings[i].startUs < s + d && busyAt(gBookings[i].startUs) >= workers)
+				free = false;
+		if (free)
+			return s;
+	}
+	return starts.back(); // not reached: everything is free after the last end
+}
+
+// Queue a response: request travels one way, the server thinks (after waiting for a worker
+// when it is shared), then segments leave at the bottleneck rate and arrive one latency
+// (+ jitter) later, in order.
+static void respond(Conn &c, const std::string &req)
+{
+	const LinkProfile &lp = config().link;
+	const ServerProfile &sp = config().server;
+	const std::vector<uint8_t> data = buildResponse(req);
+	meter().requests++;
+
+	uint64_t t = std::max(nowUs() + (uint64_t)lp.latencyMs * 1000 + jitterUs(), c.serverFreeUs);
+	const uint64_t thinkUs = (uint64_t)sp.thinkMs * 1000;
+	if (sp.workers)
+	{
+		const uint64_t arrive = t;
+		t = serverSlot(arrive, thinkUs, sp.workers);
+		gBookings.push_back({arrive, t, t + thinkUs, config().seed, currentWake()});
+	}
+	t += thinkUs;
+
+	uint64_t lastArrival = c.arrivals.empty() ? 0 : c.arrivals.back().second;
+	size_t off = 0;
+	while (off < data.size())
+	{
+		size_t seg = lp.minSegment + (lp.maxSegment > lp.minSegment ? gRng() % (lp.maxSegment - lp.minSegment + 1) : 0);
+		seg = std::min(seg, data.size() - off);
+
+		if (faultsActive() && lp.closeAtByte)
+		{
+			if (c.sentBytes >= lp.closeAtByte)
+				break;
+			seg = std::min(seg, lp.closeAtByte - c.sentBytes);
+		}
+		if (faultsActive() && lp.stallAtByte && !c.stalled && c.sentBytes + seg > lp.stallAtByte)
+		{
+			c.stalled = true;
+			t += (uint64_t)lp.stallMs * 1000;
+		}
+
+		t += (uint64_t)seg * 8000 / std::max<uint32_t>(lp.bandwidthKbps, 1);
+		const uint64_t arrival = std::max(t + (uint64_t)lp.latencyMs * 1000 + jitterUs(), lastArrival);
+		lastArrival = arrival;
+
+		c.rx.insert(c.rx.end(), data.begin() + (long)off, data.begin() + (long)(off + seg));
+		c.arrivals.push_back({c.rx.size(), arrival});
+		off += seg;
+		c.sentBytes += seg;
+	}
+	c.serverFreeUs = t;
+
+	if (off < data.size())
+		c.closeUs = lastArrival ? lastArrival : nowUs() + (uint64_t)lp.latencyMs * 1000;
+}
+
+static Conn *conn(int id)
+{
+	auto it = gConns.find(id);
+	return it == gConns.end() ? nullptr : &it->second;
+}
+
+static size_t arrived(const Conn &c)
+{
+	size_t n = 0;
+	for (const auto &a : c.arrivals)
+	{
+		if (a.second > nowUs())
+			break;
+		n = a.first;
+	}
+	return n;
+}
+
+static int openConn(uint64_t handshakeUs)
+{
+	if (WiFi.status() != WL_CONNECTED)
+		return -1;
+	advanceUs(handshakeUs);
+	meter().connects++;
+	const int id = gNextConn++;
+	gConns[id];
+	return id;
+}
+
+static uint64_t rttUs()
+{
+	return 2 * (uint64_t)config().link.latencyMs * 1000 + jitterUs();
+}
+
+// TCP handshake; with tlsMs set the endpoint is treated as https whatever the URL says
+// (the firmware's URL list is compile-time), adding two round trips and the crypto time.
+static uint64_t handshakeUs()
+{
+	uint64_t us = rttUs();
+	if (config().link.tlsMs)
+		us += 2 * rttUs() + (uint64_t)config().link.tlsMs * 1000;
+	return us;
+}
+
+} // namespace sim
+
+using namespace sim;
+
+// ---------------- WiFiClient ----------------
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) { return connect(ip, port, 5000); }
+int WiFiClient::connect(const char *host, uint16_t port) { return connect(host, port, 5000); }
+int WiFiClient::connect(const char *host, uint16_t port, int32_t timeoutMs)
+{
+	IPAddress ip;
+	return WiFi.hostByName(host, ip) ? connect(ip, port, timeoutMs) : 0;
+}
+int WiFiClient::connect(IPAddress, uint16_t, int32_t)
+{
+	stop();
+	_conn = openConn(handshakeUs());
+	return _conn > 0;
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t size)
+{
+	Conn *c = conn(_conn);
+	if (!c || nowUs() >= c->closeUs)
+		return 0;
+	c->request.append((const char *)buf, size);
+	size_t end;
+	while ((end = c->request.find("\r\n\r\n")) != std::string::npos)
+	{
+		const std::string req = c->request.substr(0, end + 4);
+		c->request.erase(0, end + 4);
+		respond(*c, req);
+	}
+	return size;
+}
+
+int WiFiClient::available()
+{
+	Conn *c = conn(_conn);
+	return c ? (int)(arrived(*c) - c->readPos) : 0;
+}
+
+int WiFiClient::read()
+{
+	uint8_t b;
+	return read(&b, 1) == 1 ? b : -1;
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size)
+{
+	Conn *c = conn(_conn);
+	if (!c)
+		return -1;
+	const size_t n = std::min(size, arrived(*c) - c->readPos);
+	if (n == 0)
+		return (nowUs() >= c->closeUs) ? -1 : 0;
+	memcpy(buf, c->rx.data() + c->readPos, n);
+	c->readPos += n;
+	meter().rxBytes += (uint32_t)n;
+	advanceUs(n / 64); // copy out of the lwIP buffer
+	return (int)n;
+}
+
+int WiFiClient::peek()
+{
+	Conn *c = conn(_conn);
+	return (c && arrived(*c) > c->readPos) ? c->rx[c->readPos] : -1;
+}
+
+void WiFiClient::stop()
+{
+	gConns.erase(_conn);
+	_conn = -1;
+}
+
+uint8_t WiFiClient::connected()
+{
+	Conn *c = conn(_conn);
+	return c && (nowUs() < c->closeUs || arrived(*c) > c->readPos);
+}
+
+// ---------------- WiFiClientSecure ----------------
+
+int WiFiClientSecure::connect(IPAddress ip, uint16_t port) { return connect(ip, port, nullptr, nullptr, nullptr, nullptr); }
+int WiFiClientSecure::connect(const char *host, uint16_t port)
+{
+	IPAddress ip;
+	return WiFi.hostByName(host, ip) ? connect(ip, port) : 0;
+}
+int WiFiClientSecure::connect(IPAddress, uint16_t, const char *, const char *, const char *, const char *)
+{
+	stop();
+	_conn = openConn(handshakeUs());
+	return _conn > 0;
+}
+int WiFiClientSecure::connect(IPAddress ip, uint16_t port, const char *, const char *)
+{
+	return connect(ip, port, nullptr, nullptr, nullptr, nullptr);
+}
+int WiFiClientSecure::connect(IPAddress ip, uint16_t port, const char *host, const char *, const char *)
+{
+	return connect(ip, port, host, nullptr, nullptr, nullptr);
+}
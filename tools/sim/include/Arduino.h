@@ -0,0 +1,198 @@
+#pragma once
+// Arduino-ESP32 core stand-in for the host simulator (tools/sim): just the API surface the
+// firmware uses. millis()/micros()/delay() run on the simulator's virtual clock.
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <cctype>
+#include <string>
+#include <algorithm>
+#define PROGMEM
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define IRAM_ATTR
+#define F(x) x
+typedef bool boolean;
+typedef uint8_t byte;
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t);
+void delayMicroseconds(uint32_t);
+void yield();
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define ADC_11db 3
+typedef int adc_attenuation_t;
+void pinMode(int, int);
+int digitalRead(int);
+void digitalWrite(int, int);
+uint32_t analogReadMilliVolts(int);
+int analogRead(int);
+void analogSetPinAttenuation(int, int);
+void analogReadResolution(int);
+float temperatureRead();
+bool setCpuFrequencyMhz(uint32_t);
+uint32_t getCpuFrequencyMhz();
+static inline uint8_t pgm_read_byte(const void *p) { return *(const uint8_t *)p; }
+static inline uint16_t pgm_read_word(const void *p) { return *(const uint16_t *)p; }
+static inline const void *pgm_read_ptr(const void *p) { return *(const void *const *)p; }
+static inline uint32_t pgm_read_dword(const void *p) { return *(const uint32_t *)p; }
+
+class String
+{
+public:
+	String() {}
+	String(const char *s) : s_(s ? s : "") {}
+	String(const std::string &s) : s_(s) {}
+	explicit String(char c) : s_(1, c) {}
+	explicit String(int v) : s_(std::to_string(v)) {}
+	explicit String(unsigned v) : s_(std::to_string(v)) {}
+	explicit String(long v) : s_(std::to_string(v)) {}
+	explicit String(unsigned long v) : s_(std::to_string(v)) {}
+	explicit String(float v, unsigned d = 2) { char b[32]; snprintf(b, 32, "%.*f", d, v); s_ = b; }
+	const char *c_str() const { return s_.c_str(); }
+	unsigned length() const { return (unsigned)s_.size(); }
+	bool reserve(unsigned n) { s_.reserve(n); return true; }
+	String substring(unsigned a) const { return a > s_.size() ? String() : String(s_.substr(a)); }
+	String substring(unsigned a, unsigned b) const { if (a > b) std::swap(a, b); if (a > s_.size()) return String(); return String(s_.substr(a, b - a)); }
+	int indexOf(char c, unsigned from = 0) const { auto p = s_.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+	int indexOf(const char *c, unsigned from = 0) const { auto p = s_.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+	int indexOf(const String &c, unsigned from = 0) const { return indexOf(c.c_str(), from); }
+	int lastIndexOf(char c) const { auto p = s_.rfind(c); return p == std::string::npos ? -1 : (int)p; }
+	long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+	void trim() { size_t a = 0; while (a < s_.size() && isspace((unsigned char)s_[a])) a++; size_t b = s_.size(); while (b > a && isspace((unsigned char)s_[b - 1])) b--; s_ = s_.substr(a, b - a); }
+	void toLowerCase() { for (auto &c : s_) c = (char)tolower((unsigned char)c); }
+	void toUpperCase() { for (auto &c : s_) c = (char)toupper((unsigned char)c); }
+	bool startsWith(const char *p) const { return s_.compare(0, strlen(p), p) == 0; }
+	bool startsWith(const String &p) const { return startsWith(p.c_str()); }
+	bool endsWith(const char *p) const { size_t n = strlen(p); return s_.size() >= n && s_.compare(s_.size() - n, n, p) == 0; }
+	bool equalsIgnoreCase(const String &o) const { return strcasecmp(c_str(), o.c_str()) == 0; }
+	bool concat(char c) { s_ += c; return true; }
+	bool concat(const char *c) { s_ += c; return true; }
+	bool concat(const String &c) { s_ += c.s_; return true; }
+	bool concat(const char *c, unsigned n) { s_.append(c, n); return true; }
+	char operator[](unsigned i) const { return s_[i]; }
+	char charAt(unsigned i) const { return i < s_.size() ? s_[i] : 0; }
+	String &operator+=(const String &o) { s_ += o.s_; return *this; }
+	String &operator+=(const char *o) { s_ += o; return *this; }
+	String &operator+=(char o) { s_ += o; return *this; }
+	String &operator+=(int o) { s_ += std::to_string(o); return *this; }
+	String &operator+=(unsigned o) { s_ += std::to_string(o); return *this; }
+	friend String operator+(const String &a, const String &b) { return String(a.s_ + b.s_); }
+	friend String operator+(const String &a, const char *b) { return String(a.s_ + b); }
+	friend String operator+(const char *a, const String &b) { return String(std::string(a) + b.s_); }
+	friend String operator+(const String &a, int b) { return String(a.s_ + std::to_string(b)); }
+	friend String operator+(const String &a, unsigned b) { return String(a.s_ + std::to_string(b)); }
+	bool operator==(const String &o) const { return s_ == o.s_; }
+	bool operator==(const char *o) const { return s_ == o; }
+	bool operator!=(const String &o) const { return s_ != o.s_; }
+	bool operator!=(const char *o) const { return s_ != o; }
+	bool isEmpty() const { return s_.empty(); }
+	void remove(unsigned i) { if (i < s_.size()) s_.erase(i); }
+	void remove(unsigned i, unsigned n) { if (i < s_.size()) s_.erase(i, n); }
+
+private:
+	std::string s_;
+};
+
+class IPAddress;
+
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t *b, size_t n) { size_t k = 0; for (size_t i = 0; i < n; i++) k += write(b[i]); return k; }
+	size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+	size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+	size_t print(const String &s) { return print(s.c_str()); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(int v) { return print(std::to_string(v).c_str()); }
+	size_t print(unsigned v) { return print(std::to_string(v).c_str()); }
+	size_t print(long v) { return print(std::to_string(v).c_str()); }
+	size_t print(unsigned long v) { return print(std::to_string(v).c_str()); }
+	size_t print(const IPAddress &ip);
+	size_t println() { return print("\r\n"); }
+	template <class T> size_t println(const T &v) { size_t n = print(v); return n + println(); }
+	size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)))
+	{
+		char b[512];
+		va_list ap;
+		va_start(ap, fmt);
+		int n = vsnprintf(b, sizeof(b), fmt, ap);
+		va_end(ap);
+		write((const uint8_t *)b, strlen(b));
+		return n;
+	}
+	virtual void flush() {}
+};
+class Printable;
+
+class Stream : public Print
+{
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+	void setTimeout(unsigned long t) { _timeout = t; }
+	unsigned long getTimeout() const { return _timeout; }
+	String readStringUntil(char term);
+	size_t readBytes(char *buf, size_t len);
+	size_t readBytes(uint8_t *buf, size_t len) { return readBytes((char *)buf, len); }
+
+protected:
+	int timedRead();
+	unsigned long _timeout = 1000;
+};
+
+class HardwareSerial : public Stream
+{
+public:
+	void begin(unsigned long) {}
+	size_t write(uint8_t c) override;
+	size_t write(const uint8_t *b, size_t n) override;
+	int available() override { return 0; }
+	int read() override { return -1; }
+	int peek() override { return -1; }
+	void flush() override;
+	operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+class IPAddress
+{
+public:
+	IPAddress() {}
+	IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _v((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+	IPAddress(uint32_t v) : _v(v) {}
+	operator uint32_t() const { return _v; }
+	uint8_t operator[](int i) const { return (uint8_t)(_v >> (8 * i)); }
+	String toString() const { char b[20]; snprintf(b, 20, "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]); return String(b); }
+	bool fromString(const char *s) { unsigned a, b, c, d; if (sscanf(s, "%u.%u.%u.%u", &a, &b, &c, &d) != 4) return false; *this = IPAddress(a, b, c, d); return true; }
+	bool operator==(const IPAddress &o) const { return _v == o._v; }
+	bool operator!=(const IPAddress &o) const { return _v != o._v; }
+
+private:
+	uint32_t _v = 0;
+};
+extern const IPAddress INADDR_NONE;
+
+class EspClass
+{
+public:
+	uint32_t getFreeHeap();
+	uint32_t getMinFreeHeap();
+	uint32_t getMaxAllocHeap();
+	uint32_t getHeapSize();
+	uint32_t getCycleCount();
+	uint64_t getEfuseMac();
+	void restart();
+};
+extern EspClass ESP;
+void configTime(long gmtOffset_sec, int daylightOffset_sec, const char *server1, const char *server2 = nullptr, const char *server3 = nullptr);
@@ -0,0 +1,3 @@
+#pragma once
+#include "../GxEPD2_BW.h"
+static const GFXfont FreeMonoBold12pt7b = {nullptr, nullptr, 0x20, 0x7E, 24};
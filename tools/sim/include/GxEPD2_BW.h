@@ -0,0 +1,141 @@
+#pragma once
+// GxEPD2 stand-in: controller RAM is modelled (current image only, 1 = white) so the
+// simulator can check what ends up on the panel; SPI transfers and refreshes advance
+// the virtual clock.
+#include "Arduino.h"
+#include <vector>
+#define GxEPD_BLACK 0x0000
+#define GxEPD_WHITE 0xFFFF
+struct GFXglyph { uint16_t bitmapOffset; uint8_t width, height, xAdvance; int8_t xOffset, yOffset; };
+struct GFXfont { uint8_t *bitmap; GFXglyph *glyph; uint16_t first, last; uint8_t yAdvance; };
+
+class GxEPD2_EPD
+{
+public:
+	GxEPD2_EPD(uint16_t w, uint16_t h, uint16_t fullMs, uint16_t partialMs, uint16_t fastMs = 0);
+	virtual ~GxEPD2_EPD() {}
+	void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+	void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+	void writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+	void writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+	void refresh(bool partial_update_mode = false);
+	void refresh(int16_t x, int16_t y, int16_t w, int16_t h);
+	void powerOff() {}
+	void hibernate() {}
+
+	const uint16_t WIDTH;
+	const uint16_t HEIGHT;
+
+	// Simulator access
+	const std::vector<uint8_t> &ram() const { return _ram; }
+	void spiBytes(size_t n); // clock cost of n bytes at the GxEPD2 default 4 MHz
+	void gfxPageShown();	 // panel now shows unmodelled GFX content
+	// 2-bpp gray window (3 = white); the RAM model keeps it thresholded at mid gray
+	void blit4G(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t x, int16_t y, int16_t w, int16_t h);
+
+protected:
+	virtual bool fastFull() const { return false; }
+
+private:
+	void blit(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool store);
+
+	uint16_t _fullMs;
+	uint16_t _partialMs;
+	uint16_t _fastMs;
+	std::vector<uint8_t> _ram;
+};
+
+// Refresh times as published in the GxEPD2 driver classes; the GDEY042T81 fast full
+// waveform (useFastFullUpdate) is taken as half the normal one.
+class GxEPD2_420_GDEY042T81 : public GxEPD2_EPD
+{
+public:
+	static const uint16_t WIDTH = 400;
+	static const uint16_t WIDTH_VISIBLE = WIDTH;
+	static const uint16_t HEIGHT = 300;
+	static const bool hasPartialUpdate = true;
+	static const bool hasFastPartialUpdate = true;
+	static const uint16_t full_refresh_time = 3600;
+	static const uint16_t partial_refresh_time = 800;
+	GxEPD2_420_GDEY042T81(int16_t, int16_t, int16_t, int16_t) : GxEPD2_EPD(WIDTH, HEIGHT, full_refresh_time, partial_refresh_time, full_refresh_time / 2) {}
+	bool useFastFullUpdate = false;
+	void writeImagePart_4G(const uint8_t bitmap[], uint8_t, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t, int16_t x, int16_t y, int16_t w, int16_t h, bool = false, bool = false, bool = false)
+	{
+		blit4G(bitmap, x_part, y_part, w_bitmap, x, y, w, h);
+	}
+
+protected:
+	bool fastFull() const override { return useFastFullUpdate; }
+};
+class GxEPD2_290_T94_V2 : public GxEPD2_EPD
+{
+public:
+	static const uint16_t WIDTH = 128;
+	static const uint16_t WIDTH_VISIBLE = WIDTH;
+	static const uint16_t HEIGHT = 296;
+	static const bool hasPartialUpdate = true;
+	static const bool hasFastPartialUpdate = true;
+	static const uint16_t full_refresh_time = 2100;
+	static const uint16_t partial_refresh_time = 500;
+	GxEPD2_290_T94_V2(int16_t, int16_t, int16_t, int16_t) : GxEPD2_EPD(WIDTH, HEIGHT, full_refresh_time, partial_refresh_time) {}
+};
+class GxEPD2_750_T7 : public GxEPD2_EPD
+{
+public:
+	static const uint16_t WIDTH = 800;
+	static const uint16_t WIDTH_VISIBLE = WIDTH;
+	static const uint16_t HEIGHT = 480;
+	static const bool hasPartialUpdate = true;
+	static const bool hasFastPartialUpdate = false;
+	static const uint16_t full_refresh_time = 4000;
+	static const uint16_t partial_refresh_time = 4000;
+	GxEPD2_750_T7(int16_t, int16_t, int16_t, int16_t) : GxEPD2_EPD(WIDTH, HEIGHT, full_refresh_time, partial_refresh_time) {}
+};
+
+class GxEPD2_GFX_Base : public Print
+{
+public:
+	size_t write(uint8_t) override { return 1; }
+};
+
+// Paged GFX drawing: content is not rasterized; each page loop costs one frame of SPI
+// plus a full or partial refresh.
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW : public GxEPD2_GFX_Base
+{
+public:
+	GxEPD2_Type epd2;
+	GxEPD2_BW(GxEPD2_Type epd2_instance) : epd2(epd2_instance) {}
+	void init(uint32_t, bool, uint16_t = 10, bool = false) {}
+	void setRotation(uint8_t r) { _rotation = r & 3; }
+	uint8_t getRotation() const { return _rotation; }
+	int16_t width() const { return (_rotation & 1) ? GxEPD2_Type::HEIGHT : GxEPD2_Type::WIDTH; }
+	int16_t height() const { return (_rotation & 1) ? GxEPD2_Type::WIDTH : GxEPD2_Type::HEIGHT; }
+	void setFullWindow() { _partial = false; }
+	void setPartialWindow(int16_t, int16_t, int16_t, int16_t) { _partial = true; }
+	void firstPage() {}
+	bool nextPage()
+	{
+		epd2.spiBytes((size_t)GxEPD2_Type::WIDTH * GxEPD2_Type::HEIGHT / 8);
+		if (_partial)
+			epd2.refresh(0, 0, GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT);
+		else
+			epd2.refresh(false);
+		epd2.gfxPageShown();
+		return false;
+	}
+	void fillScreen(uint16_t) {}
+	void drawPixel(int16_t, int16_t, uint16_t) {}
+	void setFont(const GFXfont *) {}
+	void setTextColor(uint16_t) {}
+	void setCursor(int16_t, int16_t) {}
+	void drawBitmap(int16_t, int16_t, const uint8_t *, int16_t, int16_t, uint16_t) {}
+	void drawInvertedBitmap(int16_t, int16_t, const uint8_t *, int16_t, int16_t, uint16_t) {}
+	void hibernate() { epd2.hibernate(); }
+	void powerOff() { epd2.powerOff(); }
+	void refresh(bool partial = false) { epd2.refresh(partial); }
+
+private:
+	uint8_t _rotation = 0;
+	bool _partial = false;
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include "Arduino.h"
+class Preferences
+{
+public:
+	bool begin(const char *name, bool readOnly = false, const char *partitionLabel = nullptr);
+	void end();
+	bool clear();
+	bool remove(const char *key);
+	bool isKey(const char *key);
+	size_t putBytes(const char *key, const void *value, size_t len);
+	size_t getBytes(const char *key, void *buf, size_t maxLen);
+	size_t getBytesLength(const char *key);
+	size_t putUInt(const char *key, uint32_t value);
+	uint32_t getUInt(const char *key, uint32_t defaultValue = 0);
+	size_t putString(const char *key, const char *value);
+	size_t getString(const char *key, char *value, size_t maxLen);
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include "Arduino.h"
+#include "Client.h"
+typedef enum { WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL = 1, WL_SCAN_COMPLETED = 2, WL_CONNECTED = 3, WL_CONNECT_FAILED = 4, WL_CONNECTION_LOST = 5, WL_DISCONNECTED = 6 } wl_status_t;
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1 } wifi_mode_t;
+typedef enum { WIFI_POWER_19_5dBm = 78, WIFI_POWER_17dBm = 68, WIFI_POWER_15dBm = 60, WIFI_POWER_13dBm = 52, WIFI_POWER_11dBm = 44, WIFI_POWER_8_5dBm = 34, WIFI_POWER_7dBm = 28, WIFI_POWER_5dBm = 20, WIFI_POWER_2dBm = 8 } wifi_power_t;
+typedef enum { WIFI_PS_NONE, WIFI_PS_MIN_MODEM, WIFI_PS_MAX_MODEM } wifi_ps_type_t;
+#define WIFI_SCAN_FAILED (-2)
+
+// TCP client on a simulated link (SimLink.h); fd() is -1, so socket options are skipped.
+class WiFiClient : public Client
+{
+public:
+	WiFiClient() {}
+	virtual ~WiFiClient() { stop(); }
+	int connect(IPAddress ip, uint16_t port) override;
+	int connect(const char *host, uint16_t port) override;
+	int connect(IPAddress ip, uint16_t port, int32_t timeoutMs);
+	int connect(const char *host, uint16_t port, int32_t timeoutMs);
+	size_t write(uint8_t c) override { return write(&c, 1); }
+	size_t write(const uint8_t *buf, size_t size) override;
+	int available() override;
+	int read() override;
+	int read(uint8_t *buf, size_t size) override;
+	int peek() override;
+	void stop() override;
+	uint8_t connected() override;
+	operator bool() override { return connected(); }
+	int fd() const { return -1; }
+	int setNoDelay(bool) { return 0; }
+	IPAddress remoteIP() const { return IPAddress(); }
+
+protected:
+	int _conn = -1; // simulator connection id
+};
+
+class WiFiClass
+{
+public:
+	bool mode(wifi_mode_t m);
+	wl_status_t begin(const char *ssid, const char *pass, int32_t channel = 0, const uint8_t *bssid = nullptr, bool connect = true);
+	bool disconnect(bool wifioff = false, bool eraseap = false);
+	wl_status_t status();
+	IPAddress localIP();
+	int8_t RSSI();
+	int32_t channel();
+	uint8_t *BSSID();
+	String macAddress();
+	uint8_t *macAddress(uint8_t *mac);
+	int hostByName(const char *host, IPAddress &ip);
+	bool setTxPower(wifi_power_t p);
+	wifi_power_t getTxPower();
+	bool setSleep(bool enabled);
+	bool setSleep(wifi_ps_type_t t);
+	int16_t scanNetworks(bool async = false, bool show_hidden = false, bool passive = false, uint32_t max_ms_per_chan = 300, uint8_t channel = 0, const char *ssid = nullptr, const uint8_t *bssid = nullptr);
+	String SSID(uint8_t i);
+	int32_t RSSI(uint8_t i);
+	int32_t channel(uint8_t i);
+	uint8_t *BSSID(uint8_t i);
+	void scanDelete();
+	bool setAutoReconnect(bool);
+	bool persistent(bool);
+};
+extern WiFiClass WiFi;
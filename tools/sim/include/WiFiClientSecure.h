@@ -0,0 +1,16 @@
+#pragma once
+#include "WiFi.h"
+// No encryption on the simulated link; connect() adds the profile's handshake cost.
+class WiFiClientSecure : public WiFiClient
+{
+public:
+	void setInsecure() {}
+	void setHandshakeTimeout(unsigned long) {}
+	void setCACert(const char *) {}
+	void setPreSharedKey(const char *, const char *) {}
+	int connect(IPAddress ip, uint16_t port) override;
+	int connect(const char *host, uint16_t port) override;
+	int connect(IPAddress ip, uint16_t port, const char *host, const char *CA_cert, const char *cert, const char *private_key);
+	int connect(IPAddress ip, uint16_t port, const char *pskIdent, const char *psKey);
+	int connect(IPAddress ip, uint16_t port, const char *host, const char *pskIdent, const char *psKey);
+};
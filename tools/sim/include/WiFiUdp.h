@@ -0,0 +1,20 @@
+#pragma once
+#include "WiFi.h"
+class WiFiUDP : public Stream
+{
+public:
+	uint8_t begin(uint16_t port);
+	void stop();
+	int beginPacket(IPAddress ip, uint16_t port);
+	int beginPacket(const char *host, uint16_t port);
+	int endPacket();
+	size_t write(uint8_t c) override;
+	size_t write(const uint8_t *b, size_t n) override;
+	int parsePacket();
+	int available() override;
+	int read() override;
+	int read(uint8_t *b, size_t n);
+	int peek() override { return -1; }
+	IPAddress remoteIP();
+	uint16_t remotePort();
+};
@@ -0,0 +1,6 @@
+#pragma once
+#include <stddef.h>
+#define MALLOC_CAP_8BIT (1 << 2)
+inline size_t heap_caps_get_free_size(unsigned) { return 200000; }
+inline size_t heap_caps_get_largest_free_block(unsigned) { return 110000; }
+inline size_t heap_caps_get_minimum_free_size(unsigned) { return 190000; }
@@ -0,0 +1,8 @@
+#pragma once
+// Boot selection for the simulated partitions: the set partition runs from the next wake.
+#include "esp_partition.h"
+const esp_partition_t *esp_ota_get_running_partition(void);
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start_from);
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition);
+int esp_ota_get_app_elf_sha256(char *dst, size_t size);
+esp_err_t esp_ota_mark_app_valid_cancel_rollback(void);
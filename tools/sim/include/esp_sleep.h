@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+typedef enum { ESP_SLEEP_WAKEUP_UNDEFINED = 0, ESP_SLEEP_WAKEUP_ALL, ESP_SLEEP_WAKEUP_EXT0, ESP_SLEEP_WAKEUP_EXT1, ESP_SLEEP_WAKEUP_TIMER, ESP_SLEEP_WAKEUP_TOUCHPAD, ESP_SLEEP_WAKEUP_ULP, ESP_SLEEP_WAKEUP_GPIO, ESP_SLEEP_WAKEUP_UART, ESP_SLEEP_WAKEUP_WIFI } esp_sleep_wakeup_cause_t;
+typedef enum { ESP_EXT1_WAKEUP_ALL_LOW = 0, ESP_EXT1_WAKEUP_ANY_HIGH = 1 } esp_sleep_ext1_wakeup_mode_t;
+typedef int esp_err_t;
+typedef int gpio_num_t;
+#define ESP_OK 0
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t);
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t, int);
+esp_err_t esp_sleep_enable_ext1_wakeup(uint64_t, esp_sleep_ext1_wakeup_mode_t);
+uint64_t esp_sleep_get_ext1_wakeup_status();
+esp_err_t esp_sleep_enable_gpio_wakeup();
+esp_err_t esp_sleep_enable_wifi_wakeup();
+esp_err_t esp_light_sleep_start();
+void esp_deep_sleep_start();
+esp_err_t rtc_gpio_pullup_en(gpio_num_t);
+esp_err_t rtc_gpio_pulldown_dis(gpio_num_t);
@@ -0,0 +1,11 @@
+#pragma once
+// SNTP status: the simulated server answers one link round trip (or LinkProfile::ntpMs)
+// after configTime().
+typedef enum
+{
+	SNTP_SYNC_STATUS_RESET,
+	SNTP_SYNC_STATUS_COMPLETED,
+	SNTP_SYNC_STATUS_IN_PROGRESS,
+} sntp_sync_status_t;
+sntp_sync_status_t sntp_get_sync_status(void);
+void sntp_set_sync_status(sntp_sync_status_t status);
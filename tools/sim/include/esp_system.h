@@ -0,0 +1,19 @@
+#pragma once
+// esp_restart() ends the wake like a zero-length deep sleep; RTC variables are not reset.
+void esp_restart(void);
+
+typedef enum
+{
+	ESP_RST_UNKNOWN,
+	ESP_RST_POWERON,
+	ESP_RST_EXT,
+	ESP_RST_SW,
+	ESP_RST_PANIC,
+	ESP_RST_INT_WDT,
+	ESP_RST_TASK_WDT,
+	ESP_RST_WDT,
+	ESP_RST_DEEPSLEEP,
+	ESP_RST_BROWNOUT,
+	ESP_RST_SDIO,
+} esp_reset_reason_t;
+esp_reset_reason_t esp_reset_reason(void);
@@ -0,0 +1,658 @@
+// End-to-end wake-time / energy benchmark on the simulated link.
+//
+// Runs the unmodified firmware (main.ino: battery -> WiFi -> httpGetStream -> PBM/tile
+// parser -> DisplayDrawer -> deep sleep) for a few consecutive wakes per scenario and seed.
+// Every scenario+seed runs in a forked child, so RTC memory and NVS start from power-on.
+// Between wakes only RTC_DATA_ATTR state and NVS survive: resetRam() puts every other
+// firmware global back to its boot value and millis() starts from 0 again. The firmware
+// sources are compiled into this file so it can reach their file-local state.
+//
+//   g++ -O1 -std=gnu++17 -Itools/sim/include -Itools/sim -Imain tools/sim/wake_bench.cpp tools/sim/SimCore.cpp tools/sim/SimLink.cpp -o /tmp/wake_bench
+//   /tmp/wake_bench                    # all scenarios, 10 seeds
+//   /tmp/wake_bench --only wan --seeds 30
+//   /tmp/wake_bench --only stall --seed 3 --verbose   # one run with the firmware log
+//   /tmp/wake_bench --only lan --csv /tmp/lan.csv      # per-wake rows for tools/energy_model.py
+//   /tmp/wake_bench --fleet 20 --hours 2 --think 120   # 20 units sharing one server
+
+#include "AppNetworkManager.cpp"
+#include "BatteryMonitor.cpp"
+#include "BitRotate.cpp"
+#include "Digest.cpp"
+#include "DisplayDrawer.cpp"
+#include "EndpointRanker.cpp"
+#include "FrameStore.cpp"
+#include "ItemList.cpp"
+#include "ItemsClient.cpp"
+#include "OtaUpdater.cpp"
+#include "RadioPolicy.cpp"
+#include "RefreshPolicy.cpp"
+#include "StandbyChannel.cpp"
+#include "TileDelta.cpp"
+#include "WakeArena.cpp"
+#include "WakeInputs.cpp"
+#include "WakeLoop.cpp"
+#include "WakeSchedule.cpp"
+#include "WakeTrace.cpp"
+#include "main.ino"
+
+#include "Sim.h"
+
+#include <algorithm>
+#include <new>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+struct Scenario
+{
+	const char *name;
+	const char *about;
+	sim::LinkProfile link;
+	sim::ServerProfile server;
+	uint8_t wakes;
+	bool items = false; // server content is an item list instead of a bitmap
+	bool ota = false;	// server has a firmware delta for the running image
+	float dieTempC = 40.0f;
+	uint32_t batteryPinMv = 2000; // 4.0 V behind the 1:2 divider
+};
+
+static std::vector<Scenario> scenarios()
+{
+	std::vector<Scenario> list;
+
+	Scenario lan = {"lan", "2 ms, 30 Mbit/s, full segments", {}, {}, 3};
+	lan.link.latencyMs = 2;
+	lan.link.bandwidthKbps = 30000;
+	list.push_back(lan);
+
+	Scenario frag = lan;
+	frag.name = "lan-frag";
+	frag.about = "LAN, random 1..536 B segments";
+	frag.link.minSegment = 1;
+	frag.link.maxSegment = 536;
+	list.push_back(frag);
+
+	Scenario wan = {"wan", "40 ms +0..15 jitter, 4 Mbit/s", {}, {}, 3};
+	wan.link.latencyMs = 40;
+	wan.link.jitterMs = 15;
+	wan.link.bandwidthKbps = 4000;
+	list.push_back(wan);
+
+	Scenario chunked = wan;
+	chunked.name = "wan-chunked";
+	chunked.about = "WAN, chunked 1 KB, 1..1460 B segments";
+	chunked.server.chunked = true;
+	chunked.link.minSegment = 1;
+	list.push_back(chunked);
+
+	Scenario slow = {"slow", "150 ms +0..50 jitter, 400 kbit/s", {}, {}, 3};
+	slow.link.latencyMs = 150;
+	slow.link.jitterMs = 50;
+	slow.link.bandwidthKbps = 400;
+	list.push_back(slow);
+
+	Scenario stall = wan;
+	stall.name = "stall";
+	stall.about = "WAN, 2.5 s stall at byte 6000 (wake 1)";
+	stall.link.stallAtByte = 6000;
+	stall.link.stallMs = 2500;
+	list.push_back(stall);
+
+	Scenario longStall = wan;
+	longStall.name = "long-stall";
+	longStall.about = "WAN, 9 s stall at byte 6000 (wake 1)";
+	longStall.link.stallAtByte = 6000;
+	longStall.link.stallMs = 9000;
+	list.push_back(longStall);
+
+	Scenario early = wan;
+	early.name = "early-close";
+	early.about = "WAN, server drops at byte 9000 (wake 1)";
+	early.link.closeAtByte = 9000;
+	list.push_back(early);
+
+	Scenario tls = wan;
+	tls.name = "tls-wan";
+	tls.about = "WAN, https endpoint (700 ms handshake crypto)";
+	tls.link.tlsMs = 700;
+	list.push_back(tls);
+
+	Scenario full = wan;
+	full.name = "no-delta";
+	full.about = "WAN, server ignores tile manifests";
+	full.server.delta = false;
+	list.push_back(full);
+
+	Scenario big = lan;
+	big.name = "big-edit";
+	big.about = "LAN, most bands change each wake (fast full refresh)";
+	big.server.changedBandsPerWake = 20;
+	list.push_back(big);
+
+	Scenario cold = big;
+	cold.name = "big-edit-cold";
+	cold.about = "as big-edit at about 2 C (normal full refresh)";
+	cold.dieTempC = 12.0f;
+	list.push_back(cold);
+
+	Scenario stuck = big;
+	stuck.name = "temp-stuck";
+	stuck.about = "as big-edit, die sensor stuck at 53.3 C (temperature unknown: full refresh)";
+	stuck.dieTempC = (128 - 32) / 1.8f;
+	list.push_back(stuck);
+
+	Scenario noBat = lan;
+	noBat.name = "no-bat-sense";
+	noBat.about = "LAN, no battery divider fitted (pin reads 0 mV: Normal tier)";
+	noBat.batteryPinMv = 0;
+	list.push_back(noBat);
+
+	Scenario near = lan;
+	near.name = "near-ap";
+	near.about = "LAN, -45 dBm (reduced TX power once the history agrees)";
+	near.link.rssi = -45;
+	list.push_back(near);
+
+	Scenario nearSlow = near;
+	nearSlow.name = "near-slow";
+	nearSlow.about = "as near-ap, 3.5 s association (full TX power kept)";
+	nearSlow.link.assocMs = 3500;
+	list.push_back(nearSlow);
+
+	Scenario items = wan;
+	items.name = "items-wan";
+	items.about = "WAN, server sends the item list (rendered on the device)";
+	items.items = true;
+	list.push_back(items);
+
+	Scenario itemsSlow = slow;
+	itemsSlow.name = "items-slow";
+	itemsSlow.about = "slow link, item list";
+	itemsSlow.items = true;
+	list.push_back(itemsSlow);
+
+	Scenario ntpDown = wan;
+	ntpDown.name = "ntp-down";
+	ntpDown.about = "WAN, NTP server unreachable";
+	ntpDown.link.ntpMs = sim::NTP_UNREACHABLE;
+	list.push_back(ntpDown);
+
+	Scenario apOff = wan;
+	apOff.name = "ap-off";
+	apOff.about = "WAN, AP switched off for wakes 2-3";
+	apOff.link.apOffMask = 0x6;
+	apOff.wakes = 4;
+	list.push_back(apOff);
+
+	Scenario ota = wan;
+	ota.name = "ota-wan";
+	ota.about = "WAN, firmware delta on wake 1 (256 KB image), new image from wake 2";
+	ota.ota = true;
+	list.push_back(ota);
+
+	Scenario otaDrop = ota;
+	otaDrop.name = "ota-drop";
+	otaDrop.about = "WAN, connection drops mid-delta (wake 1); resumed on wake 2";
+	otaDrop.link.closeAtByte = 16000;
+	otaDrop.wakes = 4;
+	list.push_back(otaDrop);
+
+	return list;
+}
+
+struct WakeResult
+{
+	uint8_t panelOk; // panel shows the server's current frame
+	uint32_t wakeMs;
+	uint32_t radioMs;
+	uint32_t epdMs;
+	double microAmpHours;
+	uint32_t rxBytes;
+	uint32_t connects;
+	uint32_t requests;
+};
+
+// List-like test frame: row stripes with per-"item" text-ish noise
+static std::vector<uint8_t> makeFrame(uint32_t seed)
+{
+	std::vector<uint8_t> f((size_t)Panel::FRAME_BYTES, 0);
+	uint32_t x = seed * 2654435761u + 1;
+	for (size_t row = 0; row < (size_t)Panel::HEIGHT; row++)
+	{
+		const bool rule = (row % 30) == 29;
+		for (size_t b = 0; b < (size_t)Panel::BYTES_PER_ROW; b++)
+		{
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			const bool text = (row % 30) >= 8 && (row % 30) < 22 && b > 1 && b < (size_t)Panel::BYTES_PER_ROW - 6;
+			f[row * Panel::BYTES_PER_ROW + b] = rule ? 0xFF : (text ? (uint8_t)(x & 0x5A) : 0x00);
+		}
+	}
+	return f;
+}
+
+static bool panelMatchesServer()
+{
+	if (sim::panelShowsText())
+		return false;
+	const std::vector<uint8_t> &frame = sim::serverFrame();
+	const std::vector<uint8_t> &panel = sim::panelImage();
+	if (Panel::ROTATION != 0 || panel.size() != frame.size())
+		return false; // only the native-orientation panel is compared
+	for (size_t i = 0; i < frame.size(); i++)
+		if (panel[i] != (uint8_t)~frame[i])
+			return false;
+	return true;
+}
+
+// Deep sleep keeps RTC memory only: .data / .bss come back from flash on the next boot.
+// Every firmware global not marked RTC_DATA_ATTR is listed here.
+static void resetRam()
+{
+	memset(frameBuf.data, 0, sizeof(frameBuf.data));
+	memset(itemPayload, 0, sizeof(itemPayload));
+	for (DnsLookup &l : dnsLookups)
+		l = DnsLookup();
+	wakeArena().~WakeArena();
+	new (&wakeArena()) WakeArena();
+	wakeLoop().~WakeLoop();
+	new (&wakeLoop()) WakeLoop();
+	app.~App();
+	new (&app) App();
+}
+
+static void runChild(const Scenario &s, uint32_t seed, bool verbose, int outFd)
+{
+	sim::Config &cfg = sim::config();
+	cfg.link = s.link;
+	cfg.server = s.server;
+	cfg.seed = seed;
+	cfg.verbose = verbose;
+	cfg.dieTempC = s.dieTempC;
+	cfg.batteryPinMv = s.batteryPinMv;
+	if (s.items)
+		sim::setServerItems(Panel::WIDTH, Panel::HEIGHT, seed);
+	else
+		sim::setServerFrame(Panel::WIDTH, Panel::HEIGHT, makeFrame(seed));
+	if (s.ota)
+	{
+		// The firmware only updates over authenticated TLS; the sim link doesn't encrypt
+		sim::setServerOta(seed);
+		OTA_URL = "https://raspberrypi4.local:3443/ota/delta";
+		TLS_PROFILE = TlsProfile::Psk;
+		TLS_PSK_HEX = "000102030405060708090a0b0c0d0e0f";
+	}
+
+	for (uint8_t w = 1; w <= s.wakes; w++)
+	{
+		if (verbose)
+			printf("\n===== %s seed %u wake %u =====\n", s.name, (unsigned)seed, (unsigned)w);
+
+		sim::beginWake(w);
+		resetRam();
+
+		uint64_t sleepUs = 0;
+		try
+		{
+			setup();
+		}
+		catch (const sim::DeepSleep &ds)
+		{
+			sleepUs = ds.sleepUs;
+		}
+
+		const sim::Meter &m = sim::meter();
+		WakeResult r;
+		r.panelOk = panelMatchesServer();
+		r.wakeMs = (uint32_t)(m.awakeUs / 1000);
+		r.radioMs = (uint32_t)(m.radioUs / 1000);
+		r.epdMs = (uint32_t)(m.epdUs / 1000);
+		r.microAmpHours = m.microAmpHours;
+		r.rxBytes = m.rxBytes;
+		r.connects = m.connects;
+		r.requests = m.requests;
+		if (write(outFd, &r, sizeof(r)) != (ssize_t)sizeof(r))
+			_exit(2);
+
+		sim::advanceUs(sleepUs); // asleep: not metered
+	}
+}
+
+static uint32_t percentile(std::vector<uint32_t> v, int pct)
+{
+	if (v.empty())
+		return 0;
+	std::sort(v.begin(), v.end());
+	return v[std::min(v.size() - 1, v.size() * pct / 100)];
+}
+
+static double median(std::vector<double> v)
+{
+	if (v.empty())
+		return 0;
+	std::sort(v.begin(), v.end());
+	return v[v.size() / 2];
+}
+
+// ---------------- fleet ----------------
+
+// One device of a fleet on a shared server: powered on at powerOnUs, runs wakes until
+// untilUs. Sends its wake results, then the server bookings it added.
+static void runFleetDevice(const Scenario &s, uint32_t device, uint64_t mac, uint64_t powerOnUs, uint64_t untilUs,
+						   const sim::ServerProfile &server, int outFd)
+{
+	sim::Config &cfg = sim::config();
+	cfg.link = s.link;
+	cfg.server = server;
+	cfg.seed = device;
+	cfg.mac = mac;
+	sim::setServerFrame(Panel::WIDTH, Panel::HEIGHT, makeFrame(1));
+
+	const size_t booked = sim::serverBookings().size();
+	std::vector<WakeResult> wakes;
+	sim::advanceUs(powerOnUs);
+	for (uint8_t w = 1; sim::nowUs() < untilUs && w < UINT8_MAX; w++)
+	{
+		sim::beginWake(w);
+		resetRam();
+
+		uint64_t sleepUs = 0;
+		try
+		{
+			setup();
+		}
+		catch (const sim::DeepSleep &ds)
+		{
+			sleepUs = ds.sleepUs;
+		}
+
+		const sim::Meter &m = sim::meter();
+		WakeResult r = {};
+		r.panelOk = panelMatchesServer();
+		r.wakeMs = (uint32_t)(m.awakeUs / 1000);
+		r.requests = m.requests;
+		wakes.push_back(r);
+
+		sim::advanceUs(sleepUs);
+	}
+
+	const std::vector<sim::Booking> &all = sim::serverBookings();
+	const uint32_t n = (uint32_t)wakes.size();
+	const uint32_t b = (uint32_t)(all.size() - booked);
+	if (write(outFd, &n, sizeof(n)) != (ssize_t)sizeof(n) ||
+		write(outFd, wakes.data(), n * sizeof(WakeResult)) != (ssize_t)(n * sizeof(WakeResult)) ||
+		write(outFd, &b, sizeof(b)) != (ssize_t)sizeof(b) ||
+		write(outFd, all.data() + booked, b * sizeof(sim::Booking)) != (ssize_t)(b * sizeof(sim::Booking)))
+		_exit(2);
+}
+
+template <typename T>
+static bool readAll(int fd, T *out, size_t count)
+{
+	uint8_t *p = (uint8_t *)out;
+	size_t left = count * sizeof(T);
+	while (left)
+	{
+		const ssize_t r = read(fd, p, left);
+		if (r <= 0)
+			return false;
+		p += r;
+		left -= (size_t)r;
+	}
+	return true;
+}
+
+struct FleetOptions
+{
+	uint32_t devices;
+	uint32_t hours = 2;
+	uint32_t powerOnMs = 2000; // all units powered on within this window (a power cut ends)
+	uint32_t thinkMs = 120;	   // server time per request (the Pi rendering a frame)
+	uint8_t workers = 1;
+};
+
+// Devices run one after another in forked children, each on top of the bookings of the
+// ones before it: a request never delays an earlier device's, even if it arrived first.
+// That is close to first-come-first-served whenever devices are not already in step.
+static void runFleet(const FleetOptions &o, bool sameMac)
+{
+	Scenario s = scenarios()[0]; // lan: the Pi is on the local network
+	sim::ServerProfile server = s.server;
+	server.thinkMs = o.thinkMs;
+	server.workers = o.workers;
+
+	sim::serverBookings().clear();
+	std::vector<WakeResult> powerOn, steady;
+	std::vector<uint32_t> worstDevice; // per device: p95 wake ms after power-on
+
+	for (uint32_t d = 1; d <= o.devices; d++)
+	{
+		const uint64_t powerOnUs = (uint64_t)(d * 2654435761u % (o.powerOnMs + 1)) * 1000;
+		const uint64_t mac = sameMac ? 0x563412C40A24ull : 0;
+
+		int fds[2];
+		if (pipe(fds) != 0)
+			return;
+		fflush(stdout);
+		const pid_t pid = fork();
+		if (pid == 0)
+		{
+			close(fds[0]);
+			runFleetDevice(s, d, mac, powerOnUs, (uint64_t)o.hours * 3600000000ull, server, fds[1]);
+			_exit(0);
+		}
+		close(fds[1]);
+
+		uint32_t n = 0, b = 0;
+		std::vector<WakeResult> wakes;
+		std::vector<sim::Booking> booked;
+		bool ok = readAll(fds[0], &n, 1);
+		wakes.resize(n);
+		ok = ok && readAll(fds[0], wakes.data(), n) && readAll(fds[0], &b, 1);
+		booked.resize(b);
+		ok = ok && readAll(fds[0], booked.data(), b);
+		close(fds[0]);
+		int status = 0;
+		waitpid(pid, &status, 0);
+		if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		{
+			printf("device %u: child failed (status %d)\n", (unsigned)d, status);
+			continue;
+		}
+
+		std::vector<uint32_t> mine;
+		for (size_t w = 0; w < wakes.size(); w++)
+		{
+			(w == 0 ? powerOn : steady).push_back(wakes[w]);
+			if (w)
+				mine.push_back(wakes[w].wakeMs);
+		}
+		worstDevice.push_back(percentile(mine, 95));
+		sim::serverBookings().insert(sim::serverBookings().end(), booked.begin(), booked.end());
+	}
+
+	// Server side: requests in the building (queued or being served) and queueing delay
+	const std::vector<sim::Booking> &all = sim::serverBookings();
+	for (int phase = 0; phase < 2; phase++)
+	{
+		std::vector<uint32_t> waitMs, wakeMs;
+		unsigned peak = 0, waited = 0, reqs = 0;
+		for (const sim::Booking &b : all)
+		{
+			if ((b.wake == 1) != (phase == 0))
+				continue;
+			reqs++;
+			waitMs.push_back((uint32_t)((b.startUs - b.arriveUs) / 1000));
+			waited += b.startUs > b.arriveUs;
+			unsigned in = 0;
+			for (const sim::Booking &o2 : all)
+				in += o2.arriveUs <= b.arriveUs && b.arriveUs < o2.endUs;
+			peak = std::max(peak, in);
+		}
+		for (const WakeResult &r : phase == 0 ? powerOn : steady)
+			wakeMs.push_back(r.wakeMs);
+
+		char worst[12] = "-";
+		if (phase == 1)
+			snprintf(worst, sizeof(worst), "%u", (unsigned)percentile(worstDevice, 100));
+		printf("%-10s %-9s %5u %5u %6.0f%% %6u %6u %6u %7u %6u %6u %6s\n",
+			   phase == 0 ? (sameMac ? "same MAC" : "per-MAC") : "", phase == 0 ? "power-on" : "steady",
+			   reqs, peak, reqs ? 100.0 * waited / reqs : 0.0,
+			   percentile(waitMs, 50), percentile(waitMs, 95), percentile(waitMs, 100),
+			   percentile(wakeMs, 50), percentile(wakeMs, 95), percentile(wakeMs, 100), worst);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t seeds = 10;
+	uint32_t firstSeed = 1;
+	const char *only = nullptr;
+	bool verbose = false;
+	const char *csvPath = nullptr;
+	FleetOptions fleet = {};
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--seeds") && i + 1 < argc)
+			seeds = (uint32_t)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+		{
+			firstSeed = (uint32_t)atoi(argv[++i]);
+			seeds = 1;
+		}
+		else if (!strcmp(argv[i], "--only") && i + 1 < argc)
+			only = argv[++i];
+		else if (!strcmp(argv[i], "--verbose"))
+			verbose = true;
+		else if (!strcmp(argv[i], "--csv") && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (!strcmp(argv[i], "--fleet") && i + 1 < argc)
+			fleet.devices = (uint32_t)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--hours") && i + 1 < argc)
+			fleet.hours = (uint32_t)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--think") && i + 1 < argc)
+			fleet.thinkMs = (uint32_t)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--workers") && i + 1 < argc)
+			fleet.workers = (uint8_t)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--power-on-ms") && i + 1 < argc)
+			fleet.powerOnMs = (uint32_t)atoi(argv[++i]);
+		else
+		{
+			fprintf(stderr, "usage: %s [--seeds N | --seed N] [--only NAME] [--verbose] [--csv FILE]\n"
+							"       %s --fleet N [--hours H] [--think MS] [--workers K] [--power-on-ms MS]\n",
+					argv[0], argv[0]);
+			return 1;
+		}
+	}
+
+	if (fleet.devices)
+	{
+		if (!fleet.workers)
+			fleet.workers = 1;
+		printf("fleet of %u on one server (%u worker(s), %u ms per request), powered on within %u ms, %u h on the lan link\n\n",
+			   (unsigned)fleet.devices, (unsigned)fleet.workers, (unsigned)fleet.thinkMs,
+			   (unsigned)fleet.powerOnMs, (unsigned)fleet.hours);
+		printf("%-10s %-9s %5s %5s %7s %6s %6s %6s %7s %6s %6s %6s\n", "schedule", "wakes", "req", "peak",
+			   "queued", "q p50", "q p95", "q max", "wake50", "wake95", "max", "worst");
+		runFleet(fleet, true);
+		runFleet(fleet, false);
+		printf("\nreq: server requests; peak: most requests in the server at once; queued: share that\n"
+			   "waited for a worker; q: that wait (ms); wake: device awake time (ms); worst: highest\n"
+			   "per-device p95 awake time after power-on. same MAC: every unit on one schedule.\n");
+		return 0;
+	}
+	if (verbose)
+		seeds = 1;
+
+	FILE *csv = nullptr;
+	if (csvPath)
+	{
+		csv = fopen(csvPath, "w");
+		if (!csv)
+		{
+			perror(csvPath);
+			return 1;
+		}
+		fprintf(csv, "scenario,seed,wake,ok,awake_ms,radio_ms,epd_ms,rx_bytes\n");
+	}
+
+	const sim::PowerModel pm;
+	printf("panel %ux%u, %u seed(s); power model %.0f mA CPU + %.0f mA radio + %.0f mA EPD @ %.1f V\n\n",
+		   (unsigned)Panel::WIDTH, (unsigned)Panel::HEIGHT, (unsigned)seeds,
+		   pm.cpuMa, pm.radioMa, pm.epdMa, pm.volts);
+	printf("%-12s %4s %5s %7s %7s %7s %6s %7s %7s %7s %4s %4s\n",
+		   "scenario", "wake", "ok", "p50 ms", "p95 ms", "radio", "epd", "uAh", "mJ", "rx B", "conn", "req");
+
+	for (const Scenario &s : scenarios())
+	{
+		if (only && !strstr(s.name, only))
+			continue;
+
+		std::vector<std::vector<WakeResult>> byWake(s.wakes);
+		for (uint32_t seed = firstSeed; seed < firstSeed + seeds; seed++)
+		{
+			int fds[2];
+			if (pipe(fds) != 0)
+				return 1;
+			fflush(stdout);
+			const pid_t pid = fork();
+			if (pid == 0)
+			{
+				close(fds[0]);
+				runChild(s, seed, verbose, fds[1]);
+				fflush(stdout);
+				_exit(0);
+			}
+			close(fds[1]);
+			WakeResult r;
+			uint8_t w = 0;
+			while (w < s.wakes && read(fds[0], &r, sizeof(r)) == (ssize_t)sizeof(r))
+			{
+				byWake[w++].push_back(r);
+				if (csv)
+					fprintf(csv, "%s,%u,%u,%u,%u,%u,%u,%u\n", s.name, (unsigned)seed, (unsigned)w,
+							(unsigned)r.panelOk, (unsigned)r.wakeMs, (unsigned)r.radioMs,
+							(unsigned)r.epdMs, (unsigned)r.rxBytes);
+			}
+			close(fds[0]);
+			int status = 0;
+			waitpid(pid, &status, 0);
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+				printf("%-12s seed %u: child failed (status %d)\n", s.name, (unsigned)seed, status);
+		}
+
+		if (verbose)
+			printf("\n");
+		for (uint8_t w = 0; w < s.wakes; w++)
+		{
+			std::vector<uint32_t> wake, radio, epd, rx;
+			std::vector<double> uah;
+			unsigned ok = 0, conns = 0, reqs = 0;
+			for (const WakeResult &r : byWake[w])
+			{
+				ok += r.panelOk;
+				wake.push_back(r.wakeMs);
+				radio.push_back(r.radioMs);
+				epd.push_back(r.epdMs);
+				rx.push_back(r.rxBytes);
+				uah.push_back(r.microAmpHours);
+				conns += r.connects;
+				reqs += r.requests;
+			}
+			const size_t n = byWake[w].size();
+			const double u = median(uah);
+			printf("%-12s %4u %2u/%-2u %7u %7u %7u %6u %7.1f %7.1f %7u %4.1f %4.1f\n",
+				   w == 0 ? s.name : "", (unsigned)(w + 1), ok, (unsigned)n,
+				   percentile(wake, 50), percentile(wake, 95), percentile(radio, 50), percentile(epd, 50),
+				   u, u * 3.6 * pm.volts, percentile(rx, 50),
+				   n ? (double)conns / n : 0.0, n ? (double)reqs / n : 0.0);
+		}
+		printf("%-12s      (%s)\n", "", s.about);
+	}
+	if (csv)
+		fclose(csv);
+	return 0;
+}
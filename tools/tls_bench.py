@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""TLS handshake cost per profile, against a local openssl s_server (TLS 1.2, like the
+ESP32's mbedTLS).
+
+For each profile a throwaway key/certificate is generated and s_client performs --runs
+full handshakes. Reported: negotiated suite, bytes read/written during the handshake
+(what goes over the air), and host wall time per handshake (includes s_client start-up;
+compare profiles, the device's own numbers come from the [TLS] log line).
+
+    python3 tools/tls_bench.py
+    python3 tools/tls_bench.py --runs 20 --profile psk --profile ecdhe-ecdsa
+
+--serve PROFILE runs the server for a device test instead: files under --root are
+served over HTTP/1.0 (s_server -WWW), e.g. --root . and GET /items.pbm.
+
+    python3 tools/tls_bench.py --serve psk --port 4443 --root /tmp/frames
+"""
+
+import argparse
+import os
+import re
+import statistics
+import subprocess
+import tempfile
+import time
+
+PSK_IDENTITY = "eink-01"
+PSK_HEX = "000102030405060708090a0b0c0d0e0f"
+
+# name -> (key type, cipher list, groups, about)
+PROFILES = {
+    "rsa-kx": ("rsa", "AES128-SHA256", None,
+               "RSA key exchange + AES-CBC (typical legacy negotiation)"),
+    "ecdhe-rsa": ("rsa", "ECDHE-RSA-AES128-GCM-SHA256", "X25519:P-256",
+                  "ECDHE with an RSA-2048 certificate"),
+    "ecdhe-ecdsa": ("ec", "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-ECDSA-AES128-GCM-SHA256", "X25519:P-256",
+                    "ECDHE-ECDSA P-256 certificate, ChaCha20-Poly1305 / AES-GCM (PinnedCa)"),
+    "psk": ("psk", "PSK-AES128-GCM-SHA256:PSK-CHACHA20-POLY1305", None,
+            "TLS-PSK per-device key, no certificate (Psk)"),
+}
+
+
+def make_cert(workdir, kind):
+    key = os.path.join(workdir, kind + ".key")
+    crt = os.path.join(workdir, kind + ".crt")
+    if kind == "rsa":
+        newkey = ["-newkey", "rsa:2048"]
+    else:
+        newkey = ["-newkey", "ec", "-pkeyopt", "ec_paramgen_curve:P-256"]
+    subprocess.run(["openssl", "req", "-x509", "-nodes", "-days", "2", "-subj", "/CN=localhost",
+                    "-keyout", key, "-out", crt] + newkey,
+                   check=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    return key, crt
+
+
+def server_cmd(profile, port, workdir, http_root=None):
+    kind, ciphers, groups, _ = PROFILES[profile]
+    cmd = ["openssl", "s_server", "-accept", str(port), "-tls1_2", "-cipher", ciphers, "-quiet"]
+    if kind == "psk":
+        cmd += ["-nocert", "-psk", PSK_HEX, "-psk_identity", PSK_IDENTITY]
+    else:
+        key, crt = make_cert(workdir, kind)
+        cmd += ["-key", key, "-cert", crt]
+    if groups:
+        cmd += ["-groups", groups]
+    cmd += ["-WWW"] if http_root else ["-naccept", "1000000"]
+    return cmd
+
+
+def handshake(profile, port):
+    kind = PROFILES[profile][0]
+    cmd = ["openssl", "s_client", "-connect", "127.0.0.1:%d" % port, "-tls1_2"]
+    if kind == "psk":
+        cmd += ["-psk", PSK_HEX, "-psk_identity", PSK_IDENTITY]
+    t0 = time.perf_counter()
+    out = subprocess.run(cmd, input=b"", stdout=subprocess.PIPE, stderr=subprocess.STDOUT).stdout.decode()
+    ms = (time.perf_counter() - t0) * 1000
+    m = re.search(r"handshake has read (\d+) bytes and written (\d+) bytes", out)
+    c = re.search(r"Cipher is (\S+)", out)
+    if not m or not c or c.group(1) == "(NONE)":
+        raise RuntimeError("handshake failed for %s:\n%s" % (profile, out))
+    return ms, int(m.group(1)), int(m.group(2)), c.group(1)
+
+
+def wait_listening(port, timeout=5.0):
+    import socket
+    end = time.time() + timeout
+    while time.time() < end:
+        try:
+            socket.create_connection(("127.0.0.1", port), timeout=0.2).close()
+            return
+        except OSError:
+            time.sleep(0.05)
+    raise RuntimeError("s_server did not start on port %d" % port)
+
+
+def bench(profiles, port, runs):
+    print("%-12s %-32s %8s %8s %8s  %s" % ("profile", "suite", "read B", "wrote B", "host ms", "notes"))
+    with tempfile.TemporaryDirectory() as workdir:
+        for name in profiles:
+            srv = subprocess.Popen(server_cmd(name, port, workdir),
+                                   stdin=subprocess.PIPE, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+            try:
+                wait_listening(port)
+                samples = [handshake(name, port) for _ in range(runs)]
+            finally:
+                srv.terminate()
+                srv.wait()
+            _, rd, wr, suite = samples[-1]
+            ms = statistics.median(s[0] for s in samples)
+            print("%-12s %-32s %8d %8d %8.1f  %s" % (name, suite, rd, wr, ms, PROFILES[name][3]), flush=True)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--port", type=int, default=4443)
+    ap.add_argument("--runs", type=int, default=10)
+    ap.add_argument("--profile", action="append", choices=sorted(PROFILES), help="repeatable; default all")
+    ap.add_argument("--serve", choices=sorted(PROFILES), help="run a server for device tests instead")
+    ap.add_argument("--root", default=".", help="directory served with --serve")
+    args = ap.parse_args()
+
+    if args.serve:
+        workdir = tempfile.mkdtemp()
+        print("TLS 1.2 %s on :%d serving %s (psk identity %s, key %s)" %
+              (args.serve, args.port, os.path.abspath(args.root), PSK_IDENTITY, PSK_HEX), flush=True)
+        subprocess.run(server_cmd(args.serve, args.port, workdir, http_root=args.root), cwd=args.root)
+        return
+
+    bench(args.profile or list(PROFILES), args.port, args.runs)
+
+
+if __name__ == "__main__":
+    main()